@@ -0,0 +1,848 @@
+// ==========================================
+// Le Mans 24h Simulation - Benchmark harness
+// ==========================================
+// Times the simulation hot paths over fixed seeds and field sizes, prints a table and
+// writes the results as JSON (one result per line) so two revisions can be compared:
+//
+//   make bench                                  -> build/bench.json
+//   make bench BENCH_ARGS="--baseline old.json"  -> also reports the change per result
+//   make bench-variants                         -> every build variant, and its speedup
+//
+// Linked with -Wl,--wrap for the allocation functions, so every allocation made by the
+// simulation code is counted.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "core.h"
+#include "analysis.h"
+#include "race.h"
+#include "entries.h"
+#include "pool.h"
+#include "display.h"
+#include "render.h"
+#include "snapshot.h"
+#include "telemetry.h"
+
+#ifndef BENCH_REVISION
+#define BENCH_REVISION "unknown"
+#endif
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unknown"
+#endif
+#ifndef BENCH_VARIANT
+#define BENCH_VARIANT "unknown"
+#endif
+
+#define BENCH_SEED 2024
+#define MAX_RESULTS 128
+#define MAX_VARIANTS 8
+#define RACE_STEPS (TOTAL_RACE_TIME / (int)RACE_TICK_SECONDS)
+
+static const int FIELD_SIZES[] = { 42, 512, 4096, 16384 };
+static const int NUM_FIELD_SIZES = sizeof(FIELD_SIZES) / sizeof(FIELD_SIZES[0]);
+
+// --- 1. ALLOCATION COUNTING ---
+// The benchmarks run on one thread, so a plain counter is enough.
+
+static uint64_t alloc_count = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size) { alloc_count++; return __real_malloc(size); }
+void* __wrap_calloc(size_t count, size_t size) { alloc_count++; return __real_calloc(count, size); }
+void* __wrap_realloc(void* ptr, size_t size) { alloc_count++; return __real_realloc(ptr, size); }
+void* __wrap_aligned_alloc(size_t alignment, size_t size) { alloc_count++; return __real_aligned_alloc(alignment, size); }
+
+// --- 2. RESULTS ---
+
+typedef struct {
+    char name[48];
+    int cars;
+    double value;
+    char unit[16];
+    uint64_t allocs;
+} BenchResult;
+
+typedef struct {
+    int reps;               // Repetitions per measurement (best one is kept)
+    double work_scale;      // Multiplies the amount of work per repetition
+    const char* json_path;
+    const char* baseline_path;
+    const char* variant_paths[MAX_VARIANTS];    // --variants: reference first, no benchmarks run
+    int num_variants;
+    double threshold;       // Percent change reported as a regression
+    int tick_threads;       // Threads for the parallel-tick and analysis benchmarks (1 = skip them)
+} BenchOptions;
+
+static BenchResult results[MAX_RESULTS];
+static int num_results = 0;
+
+static void add_result(const char* name, int cars, double value, const char* unit, uint64_t allocs) {
+    if (num_results == MAX_RESULTS) return;
+    BenchResult* r = &results[num_results++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->cars = cars;
+    r->value = value;
+    snprintf(r->unit, sizeof(r->unit), "%s", unit);
+    r->allocs = allocs;
+    printf("%-26s %6d cars  %12.2f %-10s %8llu allocs\n", name, cars, value, unit, (unsigned long long)allocs);
+    fflush(stdout);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double min_double(double a, double b) { return a < b ? a : b; }
+
+// Race steps to measure on a field of 'n' cars: a whole race for small fields, fewer for
+// big ones so every measurement costs about the same number of car updates
+static long scaled_steps(const BenchOptions* opt, int n) {
+    long steps = (long)(2000000 * opt->work_scale) / n;
+    if (steps < 20) steps = 20;
+    if (steps > RACE_STEPS) steps = RACE_STEPS;
+    return steps;
+}
+
+// --- 3. CAR UPDATE ---
+
+static void init_field(Car* cars, int n, Rng* rng) {
+    rng_seed(rng, BENCH_SEED);
+    for (int i = 0; i < n; i++) {
+        car_init(&cars[i], i + 1, (CarCategory)(i % 3), rng);
+    }
+}
+
+// ns per car_update() call. The field is re-gridded every race so cars do not all retire.
+// Ticks walk through one race's weather, so wet and dry sectors are both timed.
+static void bench_car_update(const BenchOptions* opt, int n) {
+    WeatherTimeline weather = { 0 };
+    weather_timeline_build(&weather, BENCH_SEED);
+    Car* cars = (Car*)malloc(n * sizeof(Car));
+    uint32_t* draws = (uint32_t*)malloc((size_t)n * CAR_DRAWS_PER_UPDATE * sizeof(uint32_t));
+    if (!cars || !draws) {
+        fprintf(stderr, "Error: Failed to allocate benchmark field.\n");
+        exit(EXIT_FAILURE);
+    }
+    long ticks = (long)(2000000 * opt->work_scale) / n;
+    if (ticks < 20) ticks = 20;
+
+    double best = 1e30;
+    uint64_t allocs = 0;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        Rng rng;
+        init_field(cars, n, &rng);
+        double elapsed = 0.0;
+        uint64_t allocs_before = alloc_count;
+        for (long t = 0; t < ticks; t++) {
+            if (t > 0 && t % RACE_STEPS == 0) init_field(cars, n, &rng);
+            rng_fill(&rng, draws, n * CAR_DRAWS_PER_UPDATE);
+            bool sc = (t % 97) < 5;
+            unsigned caution = (t % 89) < 3 ? 1u << (t % 3) : 0;     // A slow zone now and then
+            const TrackConditions* cond = &weather.slots[t % weather.num_slots];
+
+            double start = now_seconds();
+            for (int i = 0; i < n; i++) {
+                car_update(&cars[i], 1.0, sc, caution, cond, &draws[i * CAR_DRAWS_PER_UPDATE]);
+            }
+            elapsed += now_seconds() - start;
+        }
+        allocs = alloc_count - allocs_before;
+        best = min_double(best, elapsed);
+    }
+    add_result("car_update", n, best * 1e9 / ((double)ticks * n), "ns/car", allocs);
+
+    // Same work through the SoA batch kernel
+    CarSoA soa;
+    car_soa_alloc(&soa, n);
+    best = 1e30;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        Rng rng;
+        init_field(cars, n, &rng);
+        for (int i = 0; i < n; i++) car_soa_load(&soa, i, &cars[i]);
+        double elapsed = 0.0;
+        uint64_t allocs_before = alloc_count;
+        for (long t = 0; t < ticks; t++) {
+            if (t > 0 && t % RACE_STEPS == 0) {
+                init_field(cars, n, &rng);
+                for (int i = 0; i < n; i++) car_soa_load(&soa, i, &cars[i]);
+            }
+            rng_fill(&rng, draws, n * CAR_DRAWS_PER_UPDATE);
+            bool sc = (t % 97) < 5;
+            unsigned caution = (t % 89) < 3 ? 1u << (t % 3) : 0;     // A slow zone now and then
+            const TrackConditions* cond = &weather.slots[t % weather.num_slots];
+
+            double start = now_seconds();
+            car_update_batch(&soa, n, sc, caution, cond, draws);
+            elapsed += now_seconds() - start;
+        }
+        allocs = alloc_count - allocs_before;
+        best = min_double(best, elapsed);
+    }
+    add_result("car_update_batch", n, best * 1e9 / ((double)ticks * n), "ns/car", allocs);
+    car_soa_free(&soa);
+
+    // Same work through the specialized kernels, the field grouped by category
+    int* index = (int*)malloc(n * sizeof(int));
+    if (!index) {
+        fprintf(stderr, "Error: Failed to allocate benchmark field.\n");
+        exit(EXIT_FAILURE);
+    }
+    int start[CAR_CATEGORIES + 1];
+    int next = 0;
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        start[c] = next;
+        for (int i = 0; i < n; i++) {
+            if (i % 3 == c) index[next++] = i;
+        }
+    }
+    start[CAR_CATEGORIES] = next;
+    best = 1e30;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        Rng rng;
+        init_field(cars, n, &rng);
+        double elapsed = 0.0;
+        uint64_t allocs_before = alloc_count;
+        for (long t = 0; t < ticks; t++) {
+            if (t > 0 && t % RACE_STEPS == 0) init_field(cars, n, &rng);
+            rng_fill(&rng, draws, n * CAR_DRAWS_PER_UPDATE);
+            bool sc = (t % 97) < 5;
+            unsigned caution = (t % 89) < 3 ? 1u << (t % 3) : 0;     // A slow zone now and then
+            const TrackConditions* cond = &weather.slots[t % weather.num_slots];
+
+            double start_time = now_seconds();
+            for (int c = 0; c < CAR_CATEGORIES; c++) {
+                CarKernel kernel = car_kernel((CarCategory)c, cond->wet, sc);
+                kernel(cars, &index[start[c]], start[c + 1] - start[c], draws, cond, caution);
+            }
+            elapsed += now_seconds() - start_time;
+        }
+        allocs = alloc_count - allocs_before;
+        best = min_double(best, elapsed);
+    }
+    add_result("car_update_kernels", n, best * 1e9 / ((double)ticks * n), "ns/car", allocs);
+
+    free(index);
+    free(draws);
+    free(cars);
+    weather_timeline_free(&weather);
+}
+
+// us to precompute one race's weather timeline, and to branch a new future from mid-race
+// (what each strategy future pays once, shared by every plan run on it)
+static void bench_weather(const BenchOptions* opt) {
+    WeatherTimeline base = { 0 }, branch = { 0 };
+    long builds = (long)(2000 * opt->work_scale);
+    if (builds < 10) builds = 10;
+
+    double best_build = 1e30, best_branch = 1e30;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        double start = now_seconds();
+        for (long b = 0; b < builds; b++) weather_timeline_build(&base, BENCH_SEED + (uint64_t)b);
+        best_build = min_double(best_build, now_seconds() - start);
+
+        start = now_seconds();
+        for (long b = 0; b < builds; b++) {
+            weather_timeline_branch(&branch, &base, TOTAL_RACE_TIME / 2.0, BENCH_SEED + (uint64_t)b);
+        }
+        best_branch = min_double(best_branch, now_seconds() - start);
+    }
+    add_result("weather_build", base.num_slots, best_build * 1e6 / builds, "us", 0);
+    add_result("weather_branch", base.num_slots, best_branch * 1e6 / builds, "us", 0);
+    add_result("weather_bytes", base.num_slots, (double)base.num_slots * sizeof(TrackConditions), "bytes", 0);
+    weather_timeline_free(&branch);
+    weather_timeline_free(&base);
+}
+
+// --- 4. RUNNING ORDER ---
+
+static const Car* sort_cars = NULL;
+
+static int compare_order(const void* a, const void* b) {
+    const Car* x = &sort_cars[*(const int*)a];
+    const Car* y = &sort_cars[*(const int*)b];
+    if (race_car_is_ahead(x, y)) return -1;
+    if (race_car_is_ahead(y, x)) return 1;
+    return 0;
+}
+
+// Cost per tick of keeping the running order: the incremental position index against
+// a full qsort of the same index with the same comparator. Then what the standings add on
+// top: positions and fastest laps every tick, gaps on ticks somebody looks at.
+static void bench_order(const BenchOptions* opt, const EntryList* entries) {
+    RaceContext race;
+    race_init_seeded(&race, entries, BENCH_SEED);
+    int* scratch = (int*)malloc(race.num_cars * sizeof(int));
+    if (!scratch) {
+        fprintf(stderr, "Error: Failed to allocate benchmark field.\n");
+        exit(EXIT_FAILURE);
+    }
+    long max_ticks = scaled_steps(opt, race.num_cars);
+    long ticks = 0;
+
+    double best_index = 1e30, best_qsort = 1e30, best_standings = 1e30, best_gaps = 1e30;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        race_cleanup(&race);
+        race_init_seeded(&race, entries, BENCH_SEED);
+        race_weather(&race);
+        sort_cars = race.cars;
+        double index_time = 0.0, qsort_time = 0.0, standings_time = 0.0, gaps_time = 0.0;
+
+        for (ticks = 0; ticks < max_ticks && !race_is_finished(&race); ticks++) {
+            rng_fill(&race.rng, race.draws, race.num_cars * CAR_DRAWS_PER_UPDATE);
+            for (int i = 0; i < race.num_cars; i++) {
+                car_update(&race.cars[i], 1.0, false, 0, race_conditions(&race), &race.draws[i * CAR_DRAWS_PER_UPDATE]);
+            }
+
+            memcpy(scratch, race.order, race.num_cars * sizeof(int));
+            double start = now_seconds();
+            qsort(scratch, race.num_cars, sizeof(int), compare_order);
+            qsort_time += now_seconds() - start;
+
+            start = now_seconds();
+            race_update_positions(&race);
+            index_time += now_seconds() - start;
+
+            start = now_seconds();
+            race_update_standings(&race);
+            standings_time += now_seconds() - start;
+
+            start = now_seconds();
+            race_update_gaps(&race);
+            gaps_time += now_seconds() - start;
+        }
+        best_index = min_double(best_index, index_time);
+        best_qsort = min_double(best_qsort, qsort_time);
+        best_standings = min_double(best_standings, standings_time);
+        best_gaps = min_double(best_gaps, gaps_time);
+    }
+    add_result("order_position_index", race.num_cars, best_index * 1e9 / ticks, "ns/tick", 0);
+    add_result("order_qsort", race.num_cars, best_qsort * 1e9 / ticks, "ns/tick", 0);
+    add_result("standings_update", race.num_cars, best_standings * 1e9 / ticks, "ns/tick", 0);
+    add_result("standings_gaps", race.num_cars, best_gaps * 1e9 / ticks, "ns/tick", 0);
+
+    free(scratch);
+    race_cleanup(&race);
+}
+
+// --- 5. TRACK POSITIONS ---
+
+// Cost per tick of re-sorting the position ring, and per car of finding everyone
+// within traffic range ahead (what --traffic does every step)
+static void bench_track(const BenchOptions* opt, const EntryList* entries) {
+    RaceContext race;
+    int near[16];
+    long max_ticks = scaled_steps(opt, entries->num_entries);
+    long ticks = 0;
+
+    double best_ring = 1e30, best_near = 1e30;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        race_init_seeded(&race, entries, BENCH_SEED);
+        double ring_time = 0.0, near_time = 0.0;
+
+        for (ticks = 0; ticks < max_ticks && !race_is_finished(&race); ticks++) {
+            race_run_step(&race);
+
+            double start = now_seconds();
+            race_update_track(&race);
+            ring_time += now_seconds() - start;
+
+            start = now_seconds();
+            for (int i = 0; i < race.num_cars; i++) {
+                race_cars_near(&race, i, 0.0, TRAFFIC_RANGE_M, near, 16);
+            }
+            near_time += now_seconds() - start;
+        }
+        best_ring = min_double(best_ring, ring_time);
+        best_near = min_double(best_near, near_time);
+        race_cleanup(&race);
+    }
+    add_result("track_ring_update", entries->num_entries, best_ring * 1e9 / ticks, "ns/tick", 0);
+    add_result("track_cars_near", entries->num_entries,
+               best_near * 1e9 / ((double)ticks * entries->num_entries), "ns/car", 0);
+}
+
+// --- 6. RACE STEP AND WHOLE RACES ---
+
+static const char* engine_name(RaceEngine engine) {
+    switch (engine) {
+        case ENGINE_SIMD:  return "simd";
+        case ENGINE_EVENT: return "event";
+        case ENGINE_ADAPTIVE: return "adaptive";
+        default:           return "scalar";
+    }
+}
+
+// ns per race_run_step() from the start (allocations counted while stepping only)
+static void bench_race_step(const BenchOptions* opt, const EntryList* entries, RaceEngine engine,
+                            int tick_threads) {
+    double best = 1e30;
+    long max_steps = scaled_steps(opt, entries->num_entries);
+    long steps = 0;
+    uint64_t allocs = 0;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        RaceContext race;
+        race_init_seeded(&race, entries, BENCH_SEED);
+        race_set_engine(&race, engine);
+        race_set_threads(&race, tick_threads);
+
+        uint64_t allocs_before = alloc_count;
+        double start = now_seconds();
+        steps = 0;
+        while (steps < max_steps && !race_is_finished(&race)) {
+            race_run_step(&race);
+            steps++;
+        }
+        double elapsed = now_seconds() - start;
+        allocs = alloc_count - allocs_before;
+        best = min_double(best, elapsed);
+        race_cleanup(&race);
+    }
+
+    char name[48];
+    if (tick_threads > 1) snprintf(name, sizeof(name), "race_run_step_%s_t%d", engine_name(engine), tick_threads);
+    else snprintf(name, sizeof(name), "race_run_step_%s", engine_name(engine));
+    add_result(name, entries->num_entries, best * 1e9 / steps, "ns/step", allocs);
+}
+
+// Whole 24h races from init to cleanup, with the allocations one race costs
+static void bench_races(const BenchOptions* opt, const EntryList* entries, RaceEngine engine) {
+    int races = (int)(420 * opt->work_scale) / entries->num_entries;
+    if (races < 1) races = 1;
+
+    double best = 1e30;
+    uint64_t allocs = 0;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        uint64_t allocs_before = alloc_count;
+        double start = now_seconds();
+        for (int r = 0; r < races; r++) {
+            RaceContext race;
+            race_init_seeded(&race, entries, BENCH_SEED + r);
+            race_set_engine(&race, engine);
+            race_run_until(&race, TOTAL_RACE_TIME);     // As the ensemble runs them
+            race_cleanup(&race);
+        }
+        double elapsed = now_seconds() - start;
+        allocs = (alloc_count - allocs_before) / races;
+        best = min_double(best, elapsed);
+    }
+
+    char name[48];
+    snprintf(name, sizeof(name), "races_%s", engine_name(engine));
+    add_result(name, entries->num_entries, races / best, "races/s", allocs);
+}
+
+// --- 7. LEADERBOARD RENDERING ---
+
+// print_status() into /dev/null: every frame after a race step (the live case, where
+// only changed cells are sent) and with a forced full redraw.
+static void bench_print_status(const BenchOptions* opt, const EntryList* entries) {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open /dev/null.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    RaceContext race;
+    int field = entries->num_entries;
+    int frames = (int)(8400 * opt->work_scale) / field;
+    if (frames < 5) frames = 5;
+
+    for (int full = 0; full < 2; full++) {
+        double best = 1e30;
+        size_t bytes = 0;
+        uint64_t allocs = 0;
+        for (int rep = 0; rep < opt->reps; rep++) {
+            race_init_seeded(&race, entries, BENCH_SEED);
+            Screen screen;
+            screen_init(&screen, status_screen_rows(race.num_cars), STATUS_COLS, fd);
+            RaceSnapshot snap;
+            snapshot_alloc(&snap, race.num_cars);
+
+            double elapsed = 0.0;
+            bytes = 0;
+            uint64_t allocs_before = alloc_count;
+            for (int f = 0; f < frames; f++) {
+                race_run_step(&race);
+                snapshot_capture(&snap, &race);
+                if (full) screen.full_redraw = true;
+
+                double start = now_seconds();
+                print_status(&screen, &snap);
+                elapsed += now_seconds() - start;
+                bytes += screen.last_frame_bytes;
+            }
+            allocs = alloc_count - allocs_before;
+            best = min_double(best, elapsed);
+
+            snapshot_free(&snap);
+            screen_free(&screen);
+            race_cleanup(&race);
+        }
+        add_result(full ? "print_status_full" : "print_status", field, best * 1e6 / frames, "us/frame", allocs);
+        add_result(full ? "print_status_full_bytes" : "print_status_bytes", field,
+                   (double)bytes / frames, "bytes/frame", 0);
+    }
+    close(fd);
+}
+
+// --- 8. TELEMETRY AND LAP ANALYSIS ---
+
+typedef struct {
+    TelemetryRecord* records;
+    size_t count, capacity;
+} RecordBuffer;
+
+static void keep_records(void* ctx, const TelemetryRecord* records, int count) {
+    RecordBuffer* buf = (RecordBuffer*)ctx;
+    if (buf->count + count > buf->capacity) {
+        buf->capacity = 2 * (buf->count + count);
+        buf->records = realloc(buf->records, buf->capacity * sizeof(TelemetryRecord));
+        if (!buf->records) {
+            fprintf(stderr, "Error: Failed to allocate benchmark records.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    memcpy(buf->records + buf->count, records, count * sizeof(TelemetryRecord));
+    buf->count += count;
+}
+
+// Whole headless races on the scalar engine with every sector recorded (to /dev/null, so
+// the disk is not timed) against the same races unrecorded: the cost per record and the
+// overhead on the race. Each race is timed both ways back to back and keeps its best times,
+// so a noisy machine skews both sides alike.
+static void bench_recording(const BenchOptions* opt, const EntryList* entries) {
+    int races = (int)(420 * opt->work_scale) / entries->num_entries;
+    if (races < 1) races = 1;
+
+    double plain = 0.0, recorded = 0.0;
+    uint64_t records = 0, allocs = 0;
+    for (int r = 0; r < races; r++) {
+        double best[2] = { 1e30, 1e30 };
+        for (int rep = 0; rep < opt->reps; rep++) {
+            for (int rec = 0; rec < 2; rec++) {
+                RaceContext race;
+                race_init_seeded(&race, entries, BENCH_SEED + r);
+                TelemetryRecorder recorder;
+                uint64_t allocs_before = alloc_count;
+                double start = now_seconds();
+                if (rec) {
+                    if (!telemetry_recorder_open(&recorder, "/dev/null", &race)) exit(EXIT_FAILURE);
+                    race.recorder = &recorder;
+                }
+                while (!race_is_finished(&race)) race_run_step(&race);
+                if (rec) {
+                    if (rep == 0) records += recorder.records_written + recorder.buffered;
+                    telemetry_recorder_close(&recorder);
+                    race.recorder = NULL;
+                    allocs = alloc_count - allocs_before;
+                }
+                best[rec] = min_double(best[rec], now_seconds() - start);
+                race_cleanup(&race);
+            }
+        }
+        plain += best[0];
+        recorded += best[1];
+    }
+
+    add_result("record_sector", entries->num_entries, (recorded - plain) * 1e9 / records, "ns/record", allocs);
+    add_result("record_overhead", entries->num_entries, 100.0 * (recorded - plain) / plain, "%", 0);
+}
+
+// Million sector records per second through the whole analysis, on one race's records
+// already in memory (so only the analysis is timed, not the disk)
+static void bench_analysis(const BenchOptions* opt, const EntryList* entries, int threads) {
+    RaceContext race;
+    race_init_seeded(&race, entries, BENCH_SEED);
+    RecordBuffer buf = { NULL, 0, 0 };
+    TelemetryRecorder recorder;
+    telemetry_recorder_open_sink(&recorder, &race, keep_records, &buf);
+    race.recorder = &recorder;
+    while (!race_is_finished(&race)) race_run_step(&race);
+    telemetry_recorder_close(&recorder);
+    race.recorder = NULL;
+
+    Analysis an;
+    analysis_init(&an, threads);
+    int passes = (int)(20 * opt->work_scale * 42 / entries->num_entries);
+    if (passes < 1) passes = 1;
+
+    double best = 1e30;
+    uint64_t allocs = 0;
+    for (int rep = 0; rep < opt->reps; rep++) {
+        uint64_t allocs_before = alloc_count;
+        double start = now_seconds();
+        for (int p = 0; p < passes; p++) {
+            analysis_begin_race(&an, race.num_cars, race.standings.category);
+            analysis_add(&an, buf.records, buf.count);
+            analysis_end_race(&an);
+        }
+        best = min_double(best, now_seconds() - start);
+        allocs = (alloc_count - allocs_before) / passes;
+    }
+
+    char name[48];
+    snprintf(name, sizeof(name), threads > 1 ? "analysis_t%d" : "analysis", threads);
+    add_result(name, entries->num_entries, (double)buf.count * passes / best / 1e6, "Mrec/s", allocs);
+    analysis_free(&an);
+    free(buf.records);
+    race_cleanup(&race);
+}
+
+// --- 9. OUTPUT AND BASELINE COMPARISON ---
+
+static void write_json(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot write '%s'.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    fprintf(f, "{\n");
+    fprintf(f, "  \"revision\": \"%s\",\n", BENCH_REVISION);
+    fprintf(f, "  \"variant\": \"%s\",\n", BENCH_VARIANT);
+    fprintf(f, "  \"cflags\": \"%s\",\n", BENCH_CFLAGS);
+    fprintf(f, "  \"seed\": %d,\n", BENCH_SEED);
+    fprintf(f, "  \"results\": [\n");
+    for (int i = 0; i < num_results; i++) {
+        const BenchResult* r = &results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"cars\": %d, \"value\": %.4f, \"unit\": \"%s\", \"allocs\": %llu}%s\n",
+                r->name, r->cars, r->value, r->unit, (unsigned long long)r->allocs,
+                i + 1 < num_results ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    printf("\nResults written to %s\n", path);
+}
+
+// Units ending in "/s" are throughputs (higher is better); everything else is a cost
+static bool higher_is_better(const char* unit) {
+    size_t len = strlen(unit);
+    return len >= 2 && strcmp(unit + len - 2, "/s") == 0;
+}
+
+// Reads the results of a file written by write_json() into 'out' (at most MAX_RESULTS) and
+// its variant name into 'variant'. Returns how many results were read.
+static int load_results(const char* path, BenchResult* out, char* variant, size_t variant_size) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot open results '%s'.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    snprintf(variant, variant_size, "%s", path);    // Files from before variants were recorded
+    int count = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        char name[48];
+        if (sscanf(line, " \"variant\": \"%47[^\"]\"", name) == 1) {
+            snprintf(variant, variant_size, "%s", name);
+            continue;
+        }
+        BenchResult* r = &out[count];
+        if (count < MAX_RESULTS &&
+            sscanf(line, " {\"name\": \"%47[^\"]\", \"cars\": %d, \"value\": %lf, \"unit\": \"%15[^\"]\"",
+                   r->name, &r->cars, &r->value, r->unit) == 4) {
+            count++;
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+// Same result (name, field size, unit) in 'list', or NULL
+static const BenchResult* find_result(const BenchResult* list, int count, const BenchResult* r) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(list[i].name, r->name) == 0 && list[i].cars == r->cars && strcmp(list[i].unit, r->unit) == 0) {
+            return &list[i];
+        }
+    }
+    return NULL;
+}
+
+// Prints the change of every result found in both this run and 'path'.
+// Returns the number of regressions beyond the threshold.
+static int compare_baseline(const char* path, double threshold) {
+    static BenchResult baseline[MAX_RESULTS];
+    char variant[64];
+    int count = load_results(path, baseline, variant, sizeof(variant));
+
+    printf("\n=== CHANGE VS %s ===\n", path);
+    int regressions = 0;
+    for (int b = 0; b < count; b++) {
+        const BenchResult* old = &baseline[b];
+        const BenchResult* r = find_result(results, num_results, old);
+        if (!r || old->value <= 0.0) continue;
+
+        double change = (r->value - old->value) / old->value * 100.0;
+        double worse = higher_is_better(old->unit) ? -change : change;
+        bool regressed = worse > threshold;
+        if (regressed) regressions++;
+        printf("%-26s %6d cars  %12.2f -> %12.2f %-10s %+7.1f%%%s\n",
+               old->name, old->cars, old->value, r->value, old->unit, change, regressed ? "  REGRESSION" : "");
+    }
+    if (regressions > 0) printf("%d result(s) regressed by more than %.0f%%\n", regressions, threshold);
+    return regressions;
+}
+
+// Speedup of each variant over the first file, result by result (times faster, whatever the
+// unit's direction), and the geometric mean per variant: the one to deploy has the highest.
+// Byte counts are not timings and are left out.
+static void report_variants(const BenchOptions* opt) {
+    static BenchResult loaded[MAX_VARIANTS][MAX_RESULTS];
+    char names[MAX_VARIANTS][64];
+    int counts[MAX_VARIANTS];
+    for (int v = 0; v < opt->num_variants; v++) {
+        counts[v] = load_results(opt->variant_paths[v], loaded[v], names[v], sizeof(names[v]));
+    }
+
+    printf("=== SPEEDUP VS %s (%s) ===\n", names[0], opt->variant_paths[0]);
+    printf("%-26s %6s", "Result", "Cars");
+    for (int v = 1; v < opt->num_variants; v++) printf(" %10.10s", names[v]);
+    printf("\n");
+
+    double log_sum[MAX_VARIANTS] = {0};
+    int compared[MAX_VARIANTS] = {0};
+    for (int i = 0; i < counts[0]; i++) {
+        const BenchResult* ref = &loaded[0][i];
+        if (strncmp(ref->unit, "bytes", 5) == 0 || ref->value <= 0.0) continue;
+        printf("%-26s %6d", ref->name, ref->cars);
+        for (int v = 1; v < opt->num_variants; v++) {
+            const BenchResult* r = find_result(loaded[v], counts[v], ref);
+            if (!r || r->value <= 0.0) {
+                printf(" %10s", "-");
+                continue;
+            }
+            double speedup = higher_is_better(ref->unit) ? r->value / ref->value : ref->value / r->value;
+            log_sum[v] += log(speedup);
+            compared[v]++;
+            printf(" %9.2fx", speedup);
+        }
+        printf("\n");
+    }
+
+    printf("%-33s", "Geometric mean");
+    int best = 0;
+    double best_mean = 1.0;
+    for (int v = 1; v < opt->num_variants; v++) {
+        double mean = compared[v] > 0 ? exp(log_sum[v] / compared[v]) : 0.0;
+        printf(" %9.2fx", mean);
+        if (mean > best_mean) {
+            best_mean = mean;
+            best = v;
+        }
+    }
+    printf("\n");
+    if (best > 0) printf("Fastest: %s (%.2fx %s)\n", names[best], best_mean, names[0]);
+    else printf("No variant is faster than %s\n", names[0]);
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --json FILE        Write results to FILE (default: bench.json)\n");
+    printf("  --baseline FILE    Compare against an earlier results file; exit 1 on regressions\n");
+    printf("  --threshold PCT    Change counted as a regression (default: 10)\n");
+    printf("  --variants REF FILE...  Report the speedup of each results file over REF (no benchmarks run)\n");
+    printf("  --reps N           Repetitions per measurement, best kept (default: 3)\n");
+    printf("  --tick-threads T   Threads for the parallel-tick and analysis benchmarks (default: one per core)\n");
+    printf("  --quick            A tenth of the work per measurement\n");
+    printf("  --help             Show this message\n");
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt = { 3, 1.0, "bench.json", NULL, { NULL }, 0, 10.0, pool_default_threads() };
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (strcmp(arg, "--json") == 0 && has_value) {
+            opt.json_path = argv[++i];
+        } else if (strcmp(arg, "--baseline") == 0 && has_value) {
+            opt.baseline_path = argv[++i];
+        } else if (strcmp(arg, "--variants") == 0 && i + 2 < argc) {
+            while (i + 1 < argc && argv[i + 1][0] != '-' && opt.num_variants < MAX_VARIANTS) {
+                opt.variant_paths[opt.num_variants++] = argv[++i];
+            }
+        } else if (strcmp(arg, "--threshold") == 0 && has_value) {
+            opt.threshold = atof(argv[++i]);
+        } else if (strcmp(arg, "--reps") == 0 && has_value) {
+            opt.reps = atoi(argv[++i]);
+            if (opt.reps < 1) opt.reps = 1;
+        } else if (strcmp(arg, "--tick-threads") == 0 && has_value) {
+            opt.tick_threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--quick") == 0) {
+            opt.work_scale = 0.1;
+        } else if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Error: Unknown or incomplete option '%s'.\n", arg);
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opt.num_variants > 0) {
+        report_variants(&opt);
+        return 0;
+    }
+
+    printf("=== LE MANS SIM BENCHMARKS (revision %s, %s build, seed %d) ===\n", BENCH_REVISION, BENCH_VARIANT, BENCH_SEED);
+    printf("CFLAGS: %s\n\n", BENCH_CFLAGS);
+
+    for (int s = 0; s < NUM_FIELD_SIZES; s++) {
+        bench_car_update(&opt, FIELD_SIZES[s]);
+    }
+    bench_weather(&opt);
+
+    // Race-level benchmarks: the 2025 list, padded with synthetic entries for bigger fields
+    for (int s = 0; s < NUM_FIELD_SIZES; s++) {
+        EntryList entries;
+        entry_list_builtin(&entries);
+        entry_list_resize(&entries, FIELD_SIZES[s]);
+
+        bench_order(&opt, &entries);
+        bench_track(&opt, &entries);
+        bench_race_step(&opt, &entries, ENGINE_SCALAR, 1);
+        bench_race_step(&opt, &entries, ENGINE_SIMD, 1);
+        bench_race_step(&opt, &entries, ENGINE_EVENT, 1);
+        bench_race_step(&opt, &entries, ENGINE_ADAPTIVE, 1);
+        // Parallel ticks only pay off once each thread gets several chunks
+        if (opt.tick_threads > 1 && FIELD_SIZES[s] >= 4096) {
+            bench_race_step(&opt, &entries, ENGINE_SCALAR, opt.tick_threads);
+            bench_race_step(&opt, &entries, ENGINE_SIMD, opt.tick_threads);
+        }
+        // Whole 24h races are only timed where a handful of them takes seconds, not minutes
+        if (FIELD_SIZES[s] <= 4096) {
+            bench_races(&opt, &entries, ENGINE_SCALAR);
+            bench_races(&opt, &entries, ENGINE_SIMD);
+            bench_races(&opt, &entries, ENGINE_EVENT);
+            bench_races(&opt, &entries, ENGINE_ADAPTIVE);
+        }
+        bench_print_status(&opt, &entries);
+        // One race's records are kept in memory: the biggest fields would need gigabytes
+        if (FIELD_SIZES[s] <= 512) {
+            bench_recording(&opt, &entries);
+            bench_analysis(&opt, &entries, 1);
+            if (opt.tick_threads > 1) bench_analysis(&opt, &entries, opt.tick_threads);
+        }
+
+        entry_list_free(&entries);
+    }
+
+    write_json(opt.json_path);
+
+    if (opt.baseline_path && compare_baseline(opt.baseline_path, opt.threshold) > 0) {
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
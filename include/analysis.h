@@ -0,0 +1,140 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "car.h"
+#include "pool.h"
+#include "telemetry.h"
+
+// --- LAP ANALYSIS ---
+// Stints, tire degradation, pace percentiles and pit losses over recorded sectors, worked
+// out in one pass over telemetry records (from files, or straight from ensemble races
+// through a recorder sink), however many races are added.
+// Records are taken a chunk at a time and turned into columns; each worker owns a block of
+// car indices, picks its rows out of the car column, and runs its cars' laps and stints
+// forward. The laps it completes go through a second columnar pass that bins them into
+// sketches. Memory is the chunk, the per-car state and fixed-size totals: nothing grows
+// with the number of records or races.
+
+#define ANALYSIS_CHUNK      32768   // Records per pass
+#define ANALYSIS_MAX_AGE    32      // Degradation curve: laps of tire age, the last bucket takes older
+#define ANALYSIS_TIRES      4       // Indexed by TireCompound
+
+// Quantile sketch: a histogram with 512 bins per power of two from 1 s to 16384 s, so any
+// quantile comes out within 0.1% of the true value (a tenth of a second on a lap). Bins are
+// cut straight from the bits of the float. Sketches add up, so workers and races merge by
+// summing counts.
+#define SKETCH_SUB_BITS     9
+#define SKETCH_BINS         (14 << SKETCH_SUB_BITS)
+
+typedef struct {
+    uint64_t count;
+    double sum;
+    uint64_t bins[SKETCH_BINS];
+} QuantileSketch;
+
+// Everything the report is made of; it only ever adds up
+typedef struct {
+    uint64_t records;
+    uint64_t laps[CAR_CATEGORIES];              // Laps completed
+    uint64_t pit_stops[CAR_CATEGORIES];
+    uint64_t retirements[CAR_CATEGORIES];
+
+    // Clean laps: all three sectors green, no stop, the same weather throughout
+    QuantileSketch pace[CAR_CATEGORIES][2];     // [dry, wet]
+    // Clean laps on tires that suit the weather (slicks dry, wets wet), by laps of tire age
+    double age_sum[CAR_CATEGORIES][ANALYSIS_TIRES][ANALYSIS_MAX_AGE];
+    uint64_t age_laps[CAR_CATEGORIES][ANALYSIS_TIRES][ANALYSIS_MAX_AGE];
+
+    // Stints end at a stop, a retirement or the end of the race. The slope is fitted within
+    // each stint (so car-to-car pace cancels out) and pooled: sxy / sxx seconds per lap.
+    uint64_t stints[CAR_CATEGORIES][ANALYSIS_TIRES];
+    uint64_t stint_laps[CAR_CATEGORIES][ANALYSIS_TIRES];
+    double stint_sxy[CAR_CATEGORIES][ANALYSIS_TIRES];
+    double stint_sxx[CAR_CATEGORIES][ANALYSIS_TIRES];
+
+    // Pit sector minus the car's last green time through the same sector
+    QuantileSketch pit_loss[CAR_CATEGORIES];
+} AnalysisTotals;
+
+// State of one car within the current race
+typedef struct {
+    float lap_time;         // Sectors of the lap so far
+    float last_green[3];    // Last clean time through each sector, 0 for none yet
+    uint8_t green_wet;      // Bit s: last_green[s] was on a wet track
+    uint8_t lap_sectors;    // Sectors of the lap seen (a recording may start mid-lap)
+    uint8_t lap_flags;      // TLM_ flags of the lap's sectors, or-ed
+    uint8_t lap_wet;        // Sectors of the lap on a wet track
+    uint8_t tires;          // Compound of the stint
+    bool active;            // Seen this race, not retired
+    bool age_known;         // The stint was seen from its start (a recording may begin mid-stint)
+    uint16_t tire_age;      // Laps completed on this set
+    uint16_t stint_laps;
+    // Sums for the stint's degradation fit over its clean laps
+    uint16_t fit_n;
+    double fit_x, fit_y, fit_xy, fit_xx;
+} AnalysisCar;
+
+// Workers sit a cache line apart: each writes its own large totals
+typedef struct {
+    _Alignas(64) AnalysisTotals totals;
+    int first_car, end_car;     // Cars [first_car, end_car) of the current race
+
+    // Scratch for one chunk
+    uint32_t* rows;             // Rows of the chunk belonging to our cars
+    float* lap_time;            // Laps completed in the chunk, as columns
+    uint8_t* lap_sketch;        // category * 2 + wet, 0xFF for a lap that is not clean
+    uint8_t* lap_curve;         // category * ANALYSIS_TIRES + tires, 0xFF for none
+    uint8_t* lap_age;
+    float* pit_loss;            // Pit stops in the chunk
+    uint8_t* pit_category;
+    int32_t* bins;
+    int num_laps, num_pits;
+} AnalysisWorker;
+
+typedef struct {
+    int num_threads;
+    WorkerTeam team;
+    AnalysisWorker* workers;
+
+    AnalysisCar* cars;
+    unsigned char* categories;
+    int num_cars, car_capacity;
+    bool race_open;
+    long races;
+
+    // The chunk being worked on, as it came and then as columns
+    TelemetryRecord* buffer;            // For reading files, allocated by the first one
+    const TelemetryRecord* chunk;
+    size_t chunk_rows;
+    uint16_t* col_car;
+    uint8_t* col_flags;
+    uint8_t* col_sector;
+    uint8_t* col_tires;
+    uint8_t* col_state;
+    uint16_t* col_laps;
+    float* col_time;
+} Analysis;
+
+// Function Prototypes
+// 'num_threads' workers share every chunk (0 = one per core)
+void analysis_init(Analysis* an, int num_threads);
+// A new race of 'num_cars' with these categories: the previous one, if any, is closed first
+void analysis_begin_race(Analysis* an, int num_cars, const unsigned char* categories);
+// Records of the current race, in the order they were recorded
+void analysis_add(Analysis* an, const TelemetryRecord* records, size_t count);
+// Closes the open stints of the current race
+void analysis_end_race(Analysis* an);
+// Streams a telemetry file through as one race
+bool analysis_add_file(Analysis* an, const char* path);
+// Adds everything 'src' has seen (closed races only) to 'dst'
+void analysis_merge(Analysis* dst, const Analysis* src);
+void analysis_print(const Analysis* an);
+void analysis_free(Analysis* an);
+
+// 'q' in [0, 1]; 0 for an empty sketch
+double sketch_quantile(const QuantileSketch* sk, double q);
+
+#endif
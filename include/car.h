@@ -2,6 +2,9 @@
 #define CAR_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "utils.h"
+#include "weather.h"
 
 // Enumeration for car categories
 typedef enum {
@@ -10,6 +13,8 @@ typedef enum {
     LMGT3   // Le Mans GT3
 } CarCategory;
 
+#define CAR_CATEGORIES 3
+
 // Enumeration for car state
 typedef enum {
     RACING,
@@ -26,10 +31,16 @@ typedef enum {
     TIRE_WET
 } TireCompound;
 
+// Cold per-car data, kept out of Car so the tick never drags it through cache.
+// Indexed by car id - 1 (see RaceContext.info).
+// The names point into the race's entry list (see entries.h) and are never copied.
+typedef struct {
+    const char* team_name;
+    const char* driver_name;
+} CarInfo;
+
 typedef struct {
     int id;                 
-    char team_name[64];
-    char driver_name[64];   
     CarCategory category;
     
     // State
@@ -57,8 +68,110 @@ typedef struct {
 
 } Car;
 
+// Structure-of-arrays copy of the fields car_update() actually touches.
+// Lane i is the car with id i + 1. Capacity is padded to a multiple of CAR_SOA_LANES;
+// padding lanes are RETIRED so the batched kernel never needs a scalar tail.
+#define CAR_SOA_LANES 4
+
+typedef struct {
+    int capacity;
+    double* fuel_level;
+    double* tire_wear;
+    double* reliability;
+    double* current_lap_time;
+    double* last_lap_time;
+    double* total_race_time;
+    double* sector_times[3];
+    int32_t* category;
+    int32_t* state;
+    int32_t* current_tires;
+    int32_t* current_sector;
+    int32_t* laps_completed;
+} CarSoA;
+
+// Time lost in the pit lane, added to the sector in which the car stops
+#define PIT_STOP_TIME 45.0
+
+// Local cautions (see race.h): bit s of a caution mask is set while sector s is a slow zone.
+// A green-flag car adds CAUTION_TIME to a sector run under caution; a full course yellow
+// is all three bits at once.
+#define CAUTION_TIME 12.0
+#define CAUTION_ALL  0x7u
+
+// What a car_update() ran into, for the race to raise cautions from: 0 for a quiet sector.
+// Bit s: a car stopped on track in sector s (failure or worn out); CAR_INCIDENT_CRASH: one
+// went off on a wet track (slicks in the water).
+#define CAR_INCIDENT_CRASH 0x8u
+
+// Random draws consumed by one car_update() call.
+// Every slot is drawn each tick whether or not it is used, so a car's stream
+// never depends on which branch the physics took.
+typedef enum {
+    DRAW_SC_PACE,       // Lap time variance behind the safety car
+    DRAW_LAP_VARIANCE,  // Green flag sector time variance
+    DRAW_TIRE_WEAR,     // Extra tire wear
+    DRAW_FAILURE,       // Catastrophic failure roll
+    DRAW_PIT_COMPOUND,  // Dry compound picked at a pit stop
+    CAR_DRAWS_PER_UPDATE
+} CarDrawSlot;
+
+// Pit decision, taken once per car_update() after the sector's fuel and wear are used.
+// 'is_raining': the track is wet enough for wets (TrackConditions.wet).
+// Returns true to stop in this sector and sets '*compound' to the tires to fit.
+typedef bool (*PitRule)(const Car* car, bool is_raining, void* ctx, TireCompound* compound);
+
+// car_update() with the built-in pit rule on cars[index[0..count)], specialized for one
+// category, wet or dry track and safety car state; 'cond' must match the wet flag it was
+// picked for. Draws for car i start at draws[i * CAR_DRAWS_PER_UPDATE].
+// Returns the cars' incidents, or-ed.
+typedef unsigned (*CarKernel)(Car* cars, const int* index, int count, const uint32_t* draws,
+                              const TrackConditions* cond, unsigned caution);
+
+// How car_update_batch() runs its lanes
+typedef enum {
+    CAR_BATCH_AUTO,         // AVX2 where the CPU has it, otherwise portable
+    CAR_BATCH_PORTABLE,     // car_update() lane by lane
+    CAR_BATCH_AVX2
+} CarBatchPath;
+
 // Function Prototypes
-void car_init(Car* car, int id, const char* team, const char* driver, CarCategory cat);
-void car_update(Car* car, double delta_time, bool is_safety_car, int weather_state);
+void car_init(Car* car, int id, CarCategory cat, Rng* rng);
+void car_info_init(CarInfo* info, const char* team, const char* driver);
+// Scalar reference physics for one sector run in conditions 'cond' (see weather.h) with the
+// sectors of 'caution' under local caution. 'draws' holds CAR_DRAWS_PER_UPDATE values from
+// the race's batch (see race_run_step). Returns the CAR_INCIDENT_ bits of the sector.
+unsigned car_update(Car* car, double delta_time, bool is_safety_car, unsigned caution,
+                    const TrackConditions* cond, const uint32_t* draws);
+// Same physics with the pit decision taken by 'rule' (NULL = the built-in rule car_update() uses)
+unsigned car_update_with_rule(Car* car, double delta_time, bool is_safety_car, unsigned caution,
+                              const TrackConditions* cond, const uint32_t* draws, PitRule rule, void* rule_ctx);
+
+// SoA storage and the batched (SIMD) kernel, in car_batch.c
+void car_soa_alloc(CarSoA* soa, int num_cars);
+void car_soa_free(CarSoA* soa);
+void car_soa_load(CarSoA* soa, int lane, const Car* car);
+void car_soa_store(const CarSoA* soa, int lane, Car* car);
+// Lanes [first, first + count) of 'soa' as a CarSoA of their own (first: multiple of CAR_SOA_LANES).
+// The view shares the storage and must not be freed.
+void car_soa_view(const CarSoA* soa, int first, int count, CarSoA* view);
+// Same results as car_update() on every lane; draws for lane i start at draws[i * CAR_DRAWS_PER_UPDATE].
+// Returns the lanes' incidents, or-ed.
+unsigned car_update_batch(CarSoA* soa, int num_cars, bool is_safety_car, unsigned caution,
+                          const TrackConditions* cond, const uint32_t* draws);
+// Pins car_update_batch() to one path, so each can be checked on a machine that has both (not
+// while a batch runs). False, and nothing changed, if this build or CPU lacks that path.
+bool car_batch_set_path(CarBatchPath path);
+
+// Specialized kernels, in car_kernels.c: same results as car_update() on every car of 'category'
+CarKernel car_kernel(CarCategory category, bool is_wet, bool is_safety_car);
+
+// Green-flag sectors in one go, for the adaptive engine. The car (RACING, built-in pit rule)
+// runs from race time 'start' through 'weather' for every sector that starts before 'until'
+// on the wet flag of 'start' and certainly needs no stop (see car.c). Its state becomes that
+// at the end of the run; '*best_lap' gets the fastest lap completed on it. A car that breaks
+// down or crashes on the way is left RETIRED at the start of the sector it stops in.
+// Returns the sectors run, or -1 (car and rng untouched) when not even one qualifies.
+int car_advance_green(Car* car, const WeatherTimeline* weather, double start, double until, Rng* rng,
+                      double* best_lap);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "entries.h"
+#include "race.h"
+
+// --- FILE FORMAT ---
+// [CheckpointHeader][CheckpointCar x num_cars][CheckpointEvent x num_events]
+// [TrackConditions x weather_slots][names]
+// Names are "team\0driver\0" per car. Everything a resumed race needs to carry on exactly
+// where the saved one would have: car state, race clock, safety car and local cautions, the
+// weather timeline (as run, which a branched race could not rebuild from its seed), the random stream
+// position, each car's best lap and, for the event engines, the pending events (and the green runs the
+// adaptive engine's cars are on).
+// Running order, standings and track positions are recomputed from the cars. Fields are little-endian, fixed size.
+
+#define CHECKPOINT_MAGIC "LMCKP01"
+#define CHECKPOINT_VERSION 5
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_cars;
+    uint64_t seed;
+    uint64_t rng_key;
+    uint64_t rng_counter;
+    double elapsed_time;
+    double caution_end[3];      // See RaceContext
+    int32_t engine;
+    uint32_t weather_size;      // sizeof(TrackConditions)
+    uint32_t weather_slots;
+    int32_t safety_car_timer;
+    uint8_t safety_car_active;
+    uint8_t traffic;
+    uint8_t reserved[6];
+    uint32_t car_size;
+    uint32_t event_size;
+    uint32_t num_events;
+    uint32_t next_event_seq;
+    uint32_t names_size;
+    uint32_t checksum;          // FNV-1a of everything after the header
+} CheckpointHeader;
+
+// 112 bytes
+typedef struct {
+    double fuel_level;
+    double tire_wear;
+    double reliability;
+    double speed_kmh;
+    double current_lap_time;
+    double last_lap_time;
+    double sector_times[3];
+    double total_race_time;
+    double best_lap;            // For the fastest-lap standings
+    double green_run_from;      // Adaptive engine: see RaceContext
+    int32_t laps_completed;
+    uint8_t category;
+    uint8_t state;
+    uint8_t current_tires;
+    uint8_t current_sector;
+    uint8_t has_pitted_this_lap;
+    uint8_t reserved[7];
+} CheckpointCar;
+
+typedef struct {
+    double time;
+    uint32_t seq;
+    int32_t car;
+    int32_t type;
+    uint32_t reserved;
+} CheckpointEvent;
+
+// Function Prototypes
+// Written to a temporary file and renamed over 'path', so a crash mid-save never
+// leaves a torn checkpoint behind
+bool checkpoint_save(const RaceContext* race, const char* path);
+// Rebuilds the entry list and the race from 'path'. 'entries' must outlive 'race'.
+// The race has no worker team, recorder or pit rule.
+bool checkpoint_load(const char* path, EntryList* entries, RaceContext* race);
+
+#endif
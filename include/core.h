@@ -17,4 +17,7 @@
 // 1 = Real time, 60 = 1 minute per tick, etc.
 #define SIMULATION_STEP_SECONDS 1 
 
+// Race clock advance per race_run_step() (one "tick" of the fixed-step engines)
+#define RACE_TICK_SECONDS 40.0
+
 #endif
\ No newline at end of file
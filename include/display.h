@@ -0,0 +1,19 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "render.h"
+#include "snapshot.h"
+
+// Screen layout
+#define STATUS_HEADER_ROWS 9     // Title, weather, fastest laps, flag area, table header and separator
+#define STATUS_COLS 125
+
+// Function Prototypes
+// Screen rows needed to show a field of 'num_cars'
+int status_screen_rows(int num_cars);
+// Draws the live leaderboard into the screen's back buffer and presents it
+void print_status(Screen* screen, const RaceSnapshot* race);
+// Plain-text final result (no ANSI codes, safe to pipe into files)
+void print_classification(const RaceSnapshot* race);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "analysis.h"
+#include "car.h"
+#include "entries.h"
+#include "race.h"
+
+typedef struct {
+    int num_races;
+    int num_threads;
+    const EntryList* entries;   // The field every race starts with
+    uint64_t base_seed;         // Race i uses seed base_seed + i, so results are reproducible
+    RaceEngine engine;
+    bool traffic;               // Cars lose time in traffic (see track.h)
+    Analysis* analysis;         // Optional: every race's sectors are analysed into this as well
+    const WeatherTimeline* scenarios;   // Optional: race i runs in scenarios[i % num_scenarios],
+    int num_scenarios;                  // shared read-only, instead of weather of its own seed
+} EnsembleConfig;
+
+// Aggregated outcome statistics, indexed by entry (car id - 1)
+typedef struct {
+    int num_entries;
+    long num_races;
+
+    const char** team_names;    // Into the entry list's string pool
+    const char** driver_names;
+    CarCategory* categories;
+
+    long* wins;             // Highest-placed running car at the flag
+    long* dnfs;
+    long* laps_sum;
+    long* position_sum;
+
+    long category_starts[3];
+    long category_dnfs[3];
+
+    double wall_seconds;
+} EnsembleStats;
+
+// Function Prototypes
+void ensemble_run(const EnsembleConfig* config, EnsembleStats* stats);
+void ensemble_print(const EnsembleStats* stats);
+void ensemble_free(EnsembleStats* stats);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef ENTRIES_H
+#define ENTRIES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "car.h"
+
+// One entry of the field. Names are offsets into the list's string pool.
+typedef struct {
+    uint32_t team;
+    uint32_t driver;
+    CarCategory category;
+} Entry;
+
+// Entry list with interned names: every distinct team or driver name is stored once
+// in 'strings', however many entries share it. Races point straight into the pool,
+// so the list must outlive (and not be changed under) every race built from it.
+typedef struct {
+    char source[64];        // Where the list came from, for messages
+    Entry* entries;
+    int num_entries;
+    int capacity;
+
+    char* strings;          // NUL-terminated names, back to back
+    size_t strings_size;
+    size_t strings_cap;
+
+    uint32_t* intern;       // Open-addressing table of string offsets + 1 (0 = empty)
+    size_t intern_cap;      // Power of two
+    size_t intern_count;
+} EntryList;
+
+// Function Prototypes
+void entry_list_init(EntryList* list);
+void entry_list_free(EntryList* list);
+// The 2025 Le Mans entry list compiled into the program
+void entry_list_builtin(EntryList* list);
+// CSV, one entry per line: team,driver,category (HYPER|LMH, LMP2, LMGT3|GT3).
+// Fields may be double-quoted; blank lines, '#' comments and a header line before the first
+// entry whose first field is "team" in any case (e.g. Team,Driver,Category) are skipped.
+bool entry_list_load(EntryList* list, const char* path);
+void entry_list_add(EntryList* list, const char* team, const char* driver, CarCategory category);
+// Truncates the list, or pads it with synthetic entries (two cars per team, classes in turn)
+void entry_list_resize(EntryList* list, int num_entries);
+
+static inline const char* entry_team(const EntryList* list, int i) {
+    return list->strings + list->entries[i].team;
+}
+
+static inline const char* entry_driver(const EntryList* list, int i) {
+    return list->strings + list->entries[i].driver;
+}
+
+#endif
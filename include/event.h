@@ -0,0 +1,47 @@
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Things that can happen in the event-driven engine
+typedef enum {
+    EVENT_SECTOR,           // Car starts its next sector (runs car_update)
+    EVENT_PIT_ENTRY,        // Car turns into the pit lane
+    EVENT_PIT_EXIT,         // Car rejoins the track
+    EVENT_SAFETY_CAR_OUT,   // Safety car deployed
+    EVENT_SAFETY_CAR_IN     // Safety car returns to the pits
+} EventType;
+
+typedef struct {
+    double time;        // Race time (seconds) at which the event fires
+    uint32_t seq;       // Insertion order, breaks ties so the run is deterministic
+    int car;            // Index into RaceContext.cars, -1 for race-wide events
+    EventType type;
+} RaceEvent;
+
+// Binary min-heap on (time, seq)
+typedef struct {
+    RaceEvent* heap;
+    int size;
+    int capacity;
+    uint32_t next_seq;
+} EventQueue;
+
+// Function Prototypes
+void event_queue_init(EventQueue* queue, int capacity);
+void event_queue_free(EventQueue* queue);
+// Makes 'dst' (initialised, or zeroed) an exact copy of 'src', reusing its storage when it is big enough
+void event_queue_copy(EventQueue* dst, const EventQueue* src);
+void event_push(EventQueue* queue, double time, EventType type, int car);
+bool event_pop(EventQueue* queue, RaceEvent* out);
+// Pop + push in one sift: replaces the earliest event. The queue must not be empty,
+// and the new event must not be earlier than the one it replaces.
+void event_replace_top(EventQueue* queue, double time, EventType type, int car);
+
+// Earliest pending event, or NULL if the queue is empty
+static inline const RaceEvent* event_peek(const EventQueue* queue) {
+    return queue->size > 0 ? &queue->heap[0] : NULL;
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef FEED_H
+#define FEED_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "race.h"
+#include "snapshot.h"
+
+// --- LIVE TIMING FEED ---
+// Streams the race to local subscribers over a Unix domain socket or a localhost TCP port.
+// The simulation only hands snapshots to the feed thread (the same triple buffer the live
+// display uses), so it never waits for the network. The feed thread diffs each snapshot
+// against the previous one, serializes the frame once and copies it to every client's own
+// fixed-size buffer. A client too slow to take a frame skips it and, once it has drained,
+// gets one full frame with the current state instead: missed frames are coalesced, never queued.
+// Frames are built in buffers allocated when the feed opens (per client: when it connects).
+//
+// Frames are diffs of snapshots, so when the simulation outruns the feed several ticks fold
+// into one frame. Events are derived from the state change: a pit stop that kept the same
+// compound and fell between two frames shows up only as a slower sector.
+
+typedef enum {
+    FEED_JSON,      // One JSON object per line
+    FEED_BINARY     // FeedFrameHeader followed by FeedCarRecord x num_cars
+} FeedFormat;
+
+#define FEED_MAX_CLIENTS 64
+
+// --- BINARY FRAMING ---
+// Little-endian, fixed size. A frame is self-delimiting through 'size'.
+
+#define FEED_MAGIC 0x4446544Cu     // "LTFD"
+#define FEED_BINARY_MAX_CARS UINT16_MAX     // Car records hold indices and positions in 16 bits
+
+// Frame types
+#define FEED_FRAME_FULL  1      // Every car: sent on connect and after a client fell behind
+#define FEED_FRAME_DELTA 2      // Cars whose position, lap, sector, state or tires changed
+
+// Frame flags
+#define FEED_SAFETY_CAR 0x01
+#define FEED_RAIN       0x02
+#define FEED_FINISHED   0x04    // Last frame of the run
+
+// Car events since the previous frame (none in full frames)
+#define FEED_EV_POSITION 0x01   // Moved in the running order
+#define FEED_EV_SECTOR   0x02   // Completed at least one sector
+#define FEED_EV_LAP      0x04   // Completed at least one lap
+#define FEED_EV_PIT      0x08   // Stopped in the pits
+#define FEED_EV_DNF      0x10   // Retired
+#define FEED_EV_FASTEST  0x20   // Took its class's fastest lap
+
+// 32 bytes
+typedef struct {
+    uint32_t magic;
+    uint32_t size;              // Bytes in the frame, header included
+    uint64_t sequence;          // Snapshot sequence the frame describes
+    double clock;               // Race clock
+    uint8_t type;
+    uint8_t flags;
+    uint8_t caution;            // Bit s: sector s under local caution, all three = full course yellow
+    uint8_t reserved;
+    uint32_t num_cars;          // Records that follow
+} FeedFrameHeader;
+
+// 48 bytes
+typedef struct {
+    double race_time;           // Car's total_race_time
+    float sector_time;          // Last completed sector
+    float lap_time;             // Last completed lap
+    float best_lap;             // Fastest lap so far, 0 for none
+    float gap;                  // Seconds behind the leader on track
+    float interval;             // Seconds behind the car ahead on track
+    float class_gap;            // Seconds behind the class leader on track
+    uint16_t car;               // Car index (id - 1)
+    uint16_t position;          // 0 = leader
+    uint16_t class_position;    // 0 = class leader
+    uint16_t laps_completed;
+    uint8_t current_sector;
+    uint8_t state;
+    uint8_t tires;
+    uint8_t events;
+    uint32_t reserved;
+} FeedCarRecord;
+
+// --- SERVER ---
+
+// What the previous frame said about one car
+typedef struct {
+    int position;
+    int laps_completed;
+    int current_sector;
+    CarState state;
+    TireCompound tires;
+    double best_lap;
+} FeedCarState;
+
+typedef struct {
+    int fd;
+    char* buffer;               // Bytes not yet sent are [sent, used)
+    size_t sent;
+    size_t used;
+    size_t capacity;
+    bool needs_full;            // Just connected or fell behind: waits for room for a full frame
+} FeedClient;
+
+typedef struct {
+    FeedFormat format;
+    int listen_fd;
+    char unix_path[108];        // Socket file to remove on close ("" for TCP)
+
+    SnapshotBuffer snapshots;   // Simulation -> feed thread
+    pthread_t thread;
+    atomic_bool quit;
+    atomic_int num_clients;
+
+    // Feed thread only
+    FeedClient clients[FEED_MAX_CLIENTS];
+    int num_cars;
+    bool have_last;
+    FeedCarState* last;         // Indexed by car index
+    int last_fastest[CAR_CATEGORIES];   // Fastest-lap holders (car ids) in the previous frame
+    char* frame;                // Delta frame being sent
+    size_t frame_size;
+    char* full;                 // Full frame, built only when a client needs one
+    size_t full_size;
+    size_t frame_capacity;      // Either buffer: the largest possible frame
+    uint64_t frames;            // Frames built
+    uint64_t coalesced;         // Times a client fell behind and was switched to a full frame
+} FeedServer;
+
+// Function Prototypes
+// 'address' is "unix:PATH", "tcp:PORT" (bound to 127.0.0.1) or a bare path (Unix socket).
+// Starts the feed thread; returns false (with a message) if the socket cannot be set up,
+// or for a binary feed of more than FEED_BINARY_MAX_CARS cars.
+bool feed_open(FeedServer* feed, const char* address, FeedFormat format, int num_cars);
+// Blocks until at least 'count' clients are connected
+void feed_wait_clients(FeedServer* feed, int count);
+// Simulation side, after each step: cheap, never blocks. Unless 'finished', skipped while
+// no client is connected or the feed thread still has the previous snapshot unread.
+void feed_publish(FeedServer* feed, RaceContext* race, bool finished);
+// Lets the clients drain what they still have queued, disconnects them and stops the thread.
+// A client still behind after 5 s is cut off, possibly mid-frame. Call after feed_publish(..., true).
+void feed_close(FeedServer* feed);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- HOT-PATH INSTRUMENTATION ---
+// Phase timers and event counters for the tick, compiled in only with -DLEMANS_INSTRUMENT
+// (make INSTRUMENT=1). Without it every macro below expands to nothing and its arguments
+// are never evaluated, so the hot path is exactly the uninstrumented code.
+//
+// Each thread writes only to its own record (found through a thread-local pointer and
+// registered once, lock-free), so timing a worker's chunk never contends with the others.
+// Records are read once the work is done: by instr_print_summary() or instr_write_trace().
+
+typedef enum {
+    PHASE_STEP,         // Whole race_run_step()
+    PHASE_FLAGS,        // Safety car and weather
+    PHASE_TRAFFIC,      // Track positions and traffic losses
+    PHASE_CARS,         // Car update loop, all chunks
+    PHASE_CHUNK,        // One chunk of cars, on the thread that ran it
+    PHASE_EVENTS,       // Event engine: every event up to the new clock
+    PHASE_TELEMETRY,    // Recorder
+    PHASE_SORT,         // Running order
+    PHASE_STANDINGS,    // Class positions, gaps and fastest laps
+    PHASE_SNAPSHOT,     // Snapshot for the live display
+    PHASE_RENDER,       // Leaderboard drawing
+    INSTR_PHASES
+} InstrPhase;
+
+typedef enum {
+    COUNTER_PIT_STOPS,
+    COUNTER_RETIREMENTS,
+    COUNTER_FAILURES,   // Catastrophic failure rolls (instant retirement)
+    COUNTER_CAUTIONS,   // Slow zones and full course yellows raised (per tick or event)
+    COUNTER_GREEN_RUNS, // Adaptive engine: runs of green-flag sectors taken in one event
+    INSTR_COUNTERS
+} InstrCounter;
+
+#ifdef LEMANS_INSTRUMENT
+
+#define INSTR_TRACE_EVENTS 65536    // Trace events kept per thread; later ones are only summed
+
+typedef struct {
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    int32_t phase;
+} InstrTraceEvent;
+
+typedef struct InstrThread {
+    int id;
+    uint64_t phase_calls[INSTR_PHASES];
+    uint64_t phase_ns[INSTR_PHASES];
+    uint64_t counters[INSTR_COUNTERS];
+    InstrTraceEvent* trace;
+    int trace_count;
+    uint64_t trace_dropped;
+    struct InstrThread* next;
+} InstrThread;
+
+uint64_t instr_now(void);
+InstrThread* instr_register_thread(void);
+void instr_record(InstrPhase phase, uint64_t start_ns);
+
+extern _Thread_local InstrThread* instr_self;
+
+static inline InstrThread* instr_thread(void) {
+    return instr_self ? instr_self : instr_register_thread();
+}
+
+#define INSTR_BEGIN(phase)      uint64_t instr_start_##phase = instr_now()
+#define INSTR_END(phase)        instr_record(phase, instr_start_##phase)
+#define INSTR_COUNT(counter, n) (instr_thread()->counters[counter] += (uint64_t)(n))
+
+#else
+
+#define INSTR_BEGIN(phase)      ((void)0)
+#define INSTR_END(phase)        ((void)0)
+#define INSTR_COUNT(counter, n) ((void)0)
+
+#endif
+
+// Function Prototypes
+// False when built without LEMANS_INSTRUMENT (the two below then do nothing)
+bool instr_available(void);
+// Totals over every thread: time per phase and the event counters
+void instr_print_summary(void);
+// Every recorded phase as Chrome trace JSON (chrome://tracing, Perfetto)
+bool instr_write_trace(const char* path);
+
+#endif
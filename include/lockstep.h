@@ -0,0 +1,84 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "entries.h"
+#include "race.h"
+
+// --- LOCKSTEP REGRESSION ---
+// The fixed-step engines must run the same race, bit for bit, however they are driven.
+// For a matrix of field sizes and seeds, every variant below is stepped side by side with
+// the reference (the scalar engine on one thread), and every 'hash_every' ticks a hash of
+// each race's full state (every car, the running order and standings, flags, cautions and
+// the random stream) is compared. A variant that drifts is run again from the start with
+// the reference, hashed after every tick, to find the first tick and car that differ.
+// Odd seeds run with traffic and every third seed gives one car its own pit rule, so those
+// paths are covered too.
+// The event engines only match statistically, and not the fixed-step ones, which run every
+// car one sector per tick. LOCKSTEP_STAT_RACES races of the entry list per seed are run on
+// both: the means of a few outcomes per race must lie within LOCKSTEP_STAT_LIMIT standard
+// errors of the event engine's known values (on the built-in field), and the adaptive
+// engine's within as many of the event engine's on the same seeds.
+
+typedef enum {
+    LOCKSTEP_THREADS,       // Scalar, each tick split across threads
+    LOCKSTEP_SIMD,          // SIMD, one thread
+    LOCKSTEP_SIMD_THREADS,  // SIMD, each tick split across threads
+    LOCKSTEP_SWITCH,        // Scalar and SIMD in turn, a switch every LOCKSTEP_SWITCH_TICKS
+    LOCKSTEP_FORK,          // Carried on in a race_restore() copy every LOCKSTEP_SWITCH_TICKS
+    LOCKSTEP_GENERIC,       // Scalar, every car through car_update() instead of the kernels
+    LOCKSTEP_VARIANTS
+} LockstepVariant;
+
+#define LOCKSTEP_FIELDS         3
+#define LOCKSTEP_SWITCH_TICKS   97
+
+#define LOCKSTEP_STAT_RACES     20      // Per seed, on each engine
+#define LOCKSTEP_STAT_ENGINES   2       // ENGINE_EVENT, ENGINE_ADAPTIVE
+#define LOCKSTEP_STATS          4       // Per race: mean laps of each category's finishers, retirements
+#define LOCKSTEP_STAT_LIMIT     4.0
+
+typedef struct {
+    const EntryList* entries;   // The first field; the others pad or truncate it
+    int num_seeds;              // Seeds for the first field (the bigger ones run fewer, see lockstep.c)
+    uint64_t base_seed;         // Seed s of every field is base_seed + s
+    int hash_every;             // Ticks between state comparisons
+    int tick_threads;           // Threads of the threaded variants (at least 2)
+    int num_threads;            // Races checked side by side (0 = one per core)
+    bool fail_fast;             // Cases not started yet are skipped once a variant has drifted
+    bool builtin_field;         // 'entries' is the built-in list, whose event engine outcomes are known
+} LockstepConfig;
+
+// Where a variant first left the reference
+typedef struct {
+    bool diverged;
+    int num_cars;
+    uint64_t seed;
+    long tick;              // First tick after which the states differ
+    int car;                // First car (index) that differs, -1 when only race-wide state does
+    char detail[192];       // The fields that differ, reference value first
+} LockstepDivergence;
+
+typedef struct {
+    int field_cars[LOCKSTEP_FIELDS];
+    int field_seeds[LOCKSTEP_FIELDS];
+    int diverged[LOCKSTEP_FIELDS][LOCKSTEP_VARIANTS];     // Races in which the variant drifted
+    LockstepDivergence first[LOCKSTEP_VARIANTS];        // Smallest field, then lowest seed
+    uint64_t digest;        // Of every reference race's final state: changes when the physics do
+    int stat_races;         // Per engine; 0 when skipped (fail_fast)
+    bool stat_expected;     // The event engine was checked against its known values
+    double stat_mean[LOCKSTEP_STAT_ENGINES][LOCKSTEP_STATS];
+    double stat_error[LOCKSTEP_STAT_ENGINES][LOCKSTEP_STATS];      // Standard error of the mean
+    double stat_distance[LOCKSTEP_STAT_ENGINES][LOCKSTEP_STATS];   // In standard errors, signed
+    long races_run;         // References and variants
+    int cases_skipped;      // fail_fast: field and seed pairs never run
+    double wall_seconds;
+} LockstepResult;
+
+// Function Prototypes
+void lockstep_run(const LockstepConfig* config, LockstepResult* result);
+// True if every variant matched the reference everywhere
+bool lockstep_print(const LockstepResult* result);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <pthread.h>
+
+// Task callback: 'task' is the task index, 'worker' the index of the thread running it
+// (0 .. num_threads-1), so callers can keep per-worker accumulators without locks.
+typedef void (*PoolTaskFn)(void* ctx, int task, int worker);
+
+// Function Prototypes
+int pool_default_threads(void);
+// Runs tasks [0, num_tasks) on num_threads threads and returns when all are done.
+// Each worker starts on its own contiguous slice and steals from the others once it runs dry.
+void pool_run(int num_threads, int num_tasks, PoolTaskFn fn, void* ctx);
+
+// Persistent team for fork-join work that repeats many times in a row (one race tick
+// after another). The threads are created once and meet at a barrier per run instead
+// of being spawned per call. The calling thread works as worker 0.
+typedef struct {
+    int num_threads;
+    pthread_t* threads;
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+
+    // Current run, written by the caller before the start barrier
+    PoolTaskFn fn;
+    void* ctx;
+    int num_tasks;
+    bool quit;
+} WorkerTeam;
+
+void team_init(WorkerTeam* team, int num_threads);
+// Runs tasks [0, num_tasks) and returns when all are done. The split is static:
+// worker w always gets the w-th contiguous block, so a task never changes threads.
+void team_run(WorkerTeam* team, int num_tasks, PoolTaskFn fn, void* ctx);
+void team_free(WorkerTeam* team);
+
+#endif
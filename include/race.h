@@ -2,33 +2,176 @@
 #define RACE_H
 
 #include "car.h"
+#include "entries.h"
+#include "event.h"
+#include "pool.h"
+#include "standings.h"
+#include "track.h"
+#include "weather.h"
 
-#define MAX_CARS 62 
+// Cars per task of a parallel tick. A multiple of 64, so every chunk of cars, draws and
+// SoA lanes starts on its own cache line and no two threads write to the same line.
+#define RACE_CHUNK_CARS 256
 
-// Weather States
+// Local cautions. A car stopping on track makes its sector a slow zone for SLOW_ZONE_TICKS
+// ticks, about a lap, so the whole field comes through it once (in the fixed-step engines,
+// where every car runs one sector per tick, exactly once); a car going off in the wet brings
+// out a full course yellow (every sector) for FULL_COURSE_YELLOW_TICKS. Later incidents extend
+// a caution, never shorten it. The safety car stays race-wide and takes precedence while out.
+#define SLOW_ZONE_TICKS          3
+#define FULL_COURSE_YELLOW_TICKS 4
+
+// Simulation engines.
+// The fixed-step engines (SCALAR, SIMD) produce identical results for the same seed.
+// EVENT models the same physics in continuous time, so it matches them statistically, not bit for bit.
+// ADAPTIVE is EVENT with fewer events: a car with nothing ahead of it but green-flag sectors is
+// advanced by all of them in one event (see car_advance_green), and goes back to one event per
+// sector near anything that needs one. The sectors of a run are still walked one by one, not
+// summed in closed form. It matches EVENT statistically.
 typedef enum {
-    WEATHER_SUNNY,
-    WEATHER_RAIN
-} WeatherState;
+    ENGINE_SCALAR,  // car_update() on each Car every RACE_TICK_SECONDS, through the specialized kernels
+    ENGINE_SIMD,    // Batched car_update_batch() over the SoA copy
+    ENGINE_EVENT,   // Discrete-event: a car is updated when it starts a sector
+    ENGINE_ADAPTIVE // Discrete-event, with runs of green-flag sectors in one event each
+} RaceEngine;
 
 typedef struct {
-    Car *cars;              
+    void* arena;            // Single allocation holding cars, info, order, draws, the ring and own_weather
+    size_t arena_bytes;     // The race state, ahead of own_weather: what race_restore copies
+    Car *cars;              // Indexed by car id - 1, never reordered
     int num_cars;           
+    int *order;             // Running order: order[pos] is the index into cars
+    int *order_scratch;     // Merge buffer for race_update_positions()
+    CarInfo *info;          // Names (into the entry list's pool), indexed by car id - 1
+    int *category_index;    // Car indices grouped by category within each tick chunk (fixed for the race)
+    int *category_start;    // Chunk k, category c: category_index[category_start[k * (CAR_CATEGORIES + 1) + c] ..]
+
+    RaceEngine engine;
+    bool generic_update;    // Scalar engine: car_update() on every car instead of the kernels (checks them)
+    CarSoA soa;             // Authoritative hot state when engine == ENGINE_SIMD
+    EventQueue events;      // Pending events when race_has_events()
     
     double elapsed_time;    
     bool is_running;        
     bool safety_car_active; 
     int safety_car_timer;    
+    double caution_end[3];  // Race time each sector's caution lasts until (<= clock: green)
+    unsigned caution_mask;  // Bit s: sector s under caution at the race clock (see race_caution_at)
+    double next_safety_car; // Event engines: race time of the pending EVENT_SAFETY_CAR_OUT, if any
     
-    // Weather Context
-    WeatherState weather;
-    int weather_timer; // Prevents weather form changing too fast
+    // Weather Context: conditions come from a timeline fixed for the race (see weather.h)
+    const WeatherTimeline* weather;     // Read-only, possibly shared with other races; NULL until used
+    WeatherTimeline* own_weather;       // In the arena; built from the seed on first use (race_weather)
+
+    // Random state owned by this race (no shared global rand())
+    uint64_t seed;
+    Rng rng;
+    uint32_t* draws;    // Per-tick batch: CAR_DRAWS_PER_UPDATE draws per car
+
+    // Parallel tick for the fixed-step engines, NULL when single-threaded
+    WorkerTeam* team;
+
+    // Where the cars are on the lap (see race_update_track)
+    Track track;
+    TrackPosition* positions;   // Indexed like cars, at race_track_clock()
+    double* ring_m;         // Lap distance (0 .. track.length_m) of each car, projected to the same clock
+    int* ring;              // Car indices sorted by ring_m: neighbours on track are neighbours here
+    int* ring_slot;         // Inverse of ring: ring[ring_slot[i]] == i
+    bool traffic;           // Cars lose time passing the cars just ahead of them
+    double* traffic_loss;   // Seconds added to each car's next sector
+    // Adaptive engine: race time the car's current green run began (its state is already
+    // where the run ends), negative while it goes sector by sector
+    double* green_run_from;
+
+    // Class and overall standings, gaps and fastest laps (see race_update_standings)
+    Standings standings;
+
+    // Optional pit rule for one car (see strategy.h); every other car uses the built-in rule
+    int rule_car;           // Index into cars, -1 for none
+    PitRule rule;
+    void* rule_ctx;
+
+    // Optional sector-by-sector recorder (see telemetry.h), NULL when not recording
+    struct TelemetryRecorder* recorder;
     
 } RaceContext;
 
+// Car currently in position 'pos' (0 = leader)
+static inline Car* race_car_at(const RaceContext* race, int pos) {
+    return &race->cars[race->order[pos]];
+}
+
+// Sectors under caution at race time 't', as a mask for car_update(): three compares, no branch
+static inline unsigned race_caution_at(const RaceContext* race, double t) {
+    return (unsigned)(race->caution_end[0] > t) | (unsigned)(race->caution_end[1] > t) << 1 |
+           (unsigned)(race->caution_end[2] > t) << 2;
+}
+
+// The engine keeps its cars on an event queue (EVENT, ADAPTIVE)
+static inline bool race_has_events(const RaceContext* race) {
+    return race->engine == ENGINE_EVENT || race->engine == ENGINE_ADAPTIVE;
+}
+
+// Track conditions at the race clock (once the race has a timeline, see race_weather)
+static inline const TrackConditions* race_conditions(const RaceContext* race) {
+    return weather_at(race->weather, race->elapsed_time);
+}
+
 // Function Prototypes
-void race_init(RaceContext* race, int num_cars_to_create);
+// One car per entry. 'entries' must outlive the race.
+void race_init(RaceContext* race, const EntryList* entries);
+// Quiet variant used by batch runners: explicit seed, no console output
+void race_init_seeded(RaceContext* race, const EntryList* entries, uint64_t seed);
+void race_set_engine(RaceContext* race, RaceEngine engine);
+// Splits each tick of the fixed-step engines across 'num_threads' threads (0 = one per core,
+// 1 = off). Results are identical for every thread count.
+void race_set_threads(RaceContext* race, int num_threads);
+// Car 'car' (index into cars) takes its pit decisions from 'rule' instead of the built-in rule.
+// 'rule' == NULL restores the built-in rule. Honoured by every engine.
+void race_set_pit_rule(RaceContext* race, int car, PitRule rule, void* ctx);
+// The race's timeline. A race given none builds its own from the seed the first time it is
+// needed (the first step at the latest), so races sharing one never build a private copy.
+const WeatherTimeline* race_weather(RaceContext* race);
+// Runs the race in the conditions of 'timeline' (read-only, must outlive the race) instead of
+// its own. NULL goes back to the race's own timeline.
+void race_set_weather(RaceContext* race, const WeatherTimeline* timeline);
+// From now on the weather follows a new future drawn from 'seed' (see weather_timeline_branch)
+void race_branch_weather(RaceContext* race, uint64_t seed);
+// The race's own timeline becomes the saved 'slots' (WEATHER_SLOTS of them, see checkpoint.h)
+void race_load_weather(RaceContext* race, const TrackConditions* slots);
+// Fork: 'dst' becomes an independent copy of 'src' at the same instant, in one allocation
+// and one copy of the arena. The copy has no worker team, recorder or pit rule, and shares
+// the weather timeline of 'src', which must outlive it.
+void race_clone(RaceContext* dst, const RaceContext* src);
+// Rewinds a clone to 'src' (a race with the same field) without allocating: the cheap
+// way to run many futures from one fork point. Like a clone, the result has no worker team:
+// one dst had is stopped and freed
+void race_restore(RaceContext* dst, const RaceContext* src);
 void race_run_step(RaceContext* race);
+// Steps the race until its clock reaches 't' (or the flag). The adaptive engine, with no
+// traffic or recorder, runs its events straight through and sorts once at the end: the same
+// race, without the running order and standings of the ticks in between.
+void race_run_until(RaceContext* race, double t);
+// Running order: true if car A is ahead of car B
+bool race_car_is_ahead(const Car* carA, const Car* carB);
+// Re-sorts race->order after the cars moved (called by race_run_step)
+void race_update_positions(RaceContext* race);
+// Positions and fastest laps from the running order (called by race_run_step after the sort)
+void race_update_standings(RaceContext* race);
+// Brings the standings' gaps up to date: O(cars) the first time after a step, free after that.
+// Called by whoever is about to show them (snapshots, the feed).
+void race_update_gaps(RaceContext* race);
+bool race_is_finished(const RaceContext* race);
+// Race time the track positions refer to. The event engine keeps every car at the race clock;
+// the fixed-step engines advance each car by a whole sector per tick, so their cars are placed
+// where they would be, at their own pace, when the furthest-simulated car crossed its last line.
+double race_track_clock(const RaceContext* race);
+// Recomputes positions and re-sorts the ring (called by race_run_step when traffic is on)
+void race_update_track(RaceContext* race);
+// Running cars within 'behind_m' metres behind and 'ahead_m' metres ahead of car 'idx' on track,
+// any lap, nearest first per direction. Reads the ring as of the last race_update_track().
+// O(cars found). Returns how many were written to 'out' (at most 'max').
+int race_cars_near(const RaceContext* race, int idx, double behind_m, double ahead_m, int* out, int max);
 void race_cleanup(RaceContext* race); 
 
 #endif
\ No newline at end of file
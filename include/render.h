@@ -0,0 +1,58 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Colors available to the renderer (see SGR table in render.c)
+typedef enum {
+    COLOR_DEFAULT,
+    COLOR_RED,
+    COLOR_GREEN,
+    COLOR_YELLOW,
+    COLOR_BLUE,
+    COLOR_MAGENTA,
+    COLOR_CYAN,
+    COLOR_WHITE,
+    COLOR_GRAY,
+    COLOR_BANNER,   // Black on yellow (safety car)
+    COLOR_COUNT
+} ScreenColor;
+
+// One terminal cell. A wide glyph (emoji) stores its bytes in the first cell
+// and leaves the next one as a continuation (len == 0).
+typedef struct {
+    char glyph[8];      // UTF-8 bytes
+    uint8_t len;
+    uint8_t color;      // ScreenColor
+} ScreenCell;
+
+// Double-buffered terminal: frames are drawn into 'back', and screen_present()
+// sends only the cells that differ from 'front' (what the terminal already shows).
+typedef struct {
+    int rows;
+    int cols;
+    ScreenCell* front;
+    ScreenCell* back;
+
+    char* out;              // Preallocated escape-sequence buffer, one write() per frame
+    size_t out_cap;
+    int fd;
+
+    bool full_redraw;       // Next frame clears and repaints everything
+    size_t last_frame_bytes;
+} Screen;
+
+// Function Prototypes
+void screen_init(Screen* screen, int rows, int cols, int fd);
+void screen_free(Screen* screen);
+void screen_clear(Screen* screen);
+// Draws text at (row, col) and returns the column after it. Text past the edge is clipped.
+int screen_put(Screen* screen, int row, int col, ScreenColor color, const char* text);
+int screen_printf(Screen* screen, int row, int col, ScreenColor color, const char* fmt, ...)
+    __attribute__((format(printf, 5, 6)));
+// Emits the changes since the previous frame; returns the number of bytes written
+size_t screen_present(Screen* screen);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "race.h"
+
+// What the leaderboard needs to know about one car
+typedef struct {
+    int id;
+    CarCategory category;
+    CarState state;
+    TireCompound current_tires;
+    int laps_completed;
+    int current_sector;
+    double total_race_time;
+    double sector_time;         // Last completed sector
+    double last_lap_time;       // Last completed lap
+    double reliability;
+    double gap;                 // Seconds behind the leader on track (see track_gap)
+    double interval;            // Seconds behind the car ahead on track, 0 for the leader
+    double class_gap;           // Seconds behind the class leader on track
+    double best_lap;            // Fastest lap so far, 0 for none
+    int class_position;         // 0 = class leader
+} SnapshotCar;
+
+// Immutable copy of the race as seen at one instant, cars in running order
+typedef struct {
+    uint64_t sequence;          // Increases with every published snapshot
+    double elapsed_time;
+    TrackConditions conditions;     // At elapsed_time
+    bool safety_car_active;
+    unsigned caution_mask;      // Sectors under local caution (see race.h)
+    bool finished;              // Last snapshot of the run
+    int num_cars;
+    SnapshotCar* cars;
+    int fastest[CAR_CATEGORIES];    // Car id holding each category's fastest lap, 0 for none
+    double fastest_lap[CAR_CATEGORIES];
+    const CarInfo* info;        // Names (never change during a race), indexed by id - 1
+} RaceSnapshot;
+
+// Single-producer / single-consumer triple buffer. The producer always has a private slot to
+// fill, the consumer always has a private slot to read, and the third is swapped atomically
+// between them. Neither side ever waits for the other.
+typedef struct {
+    RaceSnapshot slots[3];
+    atomic_int middle;          // Slot index of the shared buffer, plus SNAPSHOT_FRESH if unread
+    int write_slot;             // Owned by the producer
+    int read_slot;              // Owned by the consumer
+    uint64_t next_sequence;
+} SnapshotBuffer;
+
+// Function Prototypes
+void snapshot_alloc(RaceSnapshot* snap, int num_cars);
+void snapshot_free(RaceSnapshot* snap);
+// Brings the race's gaps up to date first (see race_update_gaps), the only change it makes to 'race'
+void snapshot_capture(RaceSnapshot* snap, RaceContext* race);
+
+void snapshot_buffer_init(SnapshotBuffer* buf, int num_cars);
+void snapshot_buffer_free(SnapshotBuffer* buf);
+
+// Producer side
+bool snapshot_consumer_behind(SnapshotBuffer* buf);     // True if the last publish is still unread
+void snapshot_publish(SnapshotBuffer* buf, RaceContext* race, bool finished);
+
+// Consumer side: the newest snapshot if one arrived since the last call, else NULL.
+// The returned pointer stays valid until the next call.
+const RaceSnapshot* snapshot_acquire(SnapshotBuffer* buf);
+
+#endif
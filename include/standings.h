@@ -0,0 +1,71 @@
+#ifndef STANDINGS_H
+#define STANDINGS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "car.h"
+#include "track.h"
+
+// --- STANDINGS ---
+// Overall and class positions, gaps and fastest laps, kept by the race so that no view has
+// to work them out from the whole field again.
+// After every step one pass in running order over small index arrays updates the positions:
+// a car's class position is how many cars of its class were met before it. Fastest laps
+// only look at the cars that completed a lap since the previous step.
+// Gaps move with the clock for every car, so they are the one O(cars) part: they are worked
+// out at most once per step, the first time a view asks for them (see race_update_gaps),
+// and a race nobody watches never pays for them.
+// Every query is O(1). The arrays live in the race's arena, indexed by car index.
+
+typedef struct {
+    int* position;          // Overall, 0 = leader
+    int* class_position;    // Within the car's category, 0 = class leader
+    int* class_order;       // class_order[class_start[c] + k]: car in class position k of category c
+    int class_start[CAR_CATEGORIES + 1];     // Fixed for the race: categories never change
+    double* gap;            // Seconds behind the overall leader on track (see track_gap); gaps are
+                            // only current after race_update_gaps()
+    double* interval;       // Seconds behind the car ahead on track, 0 for the leader
+    double* class_gap;      // Seconds behind the class leader on track
+    double* best_lap;       // Car's fastest lap, 0 before its first
+    int* laps_seen;         // laps_completed at the last pass
+    unsigned char* category;    // Copy of each car's category, so the running-order walk stays off the Car structs
+    int fastest[CAR_CATEGORIES];    // Car holding each category's fastest lap, -1 for none yet
+    int fastest_overall;            // -1 for none yet
+    bool gaps_stale;                // The cars moved since the gaps were last worked out
+} Standings;
+
+// Function Prototypes
+// Bytes of arena the arrays need for 'num_cars' (a multiple of 64)
+size_t standings_bytes(int num_cars);
+// Points the arrays into 'block' (standings_bytes() long, 64-byte aligned) and sets up the
+// classes of 'cars'. No laps, everyone where the starting grid puts them.
+void standings_init(Standings* st, void* block, const Car* cars, int num_cars);
+// Positions and fastest laps after the cars moved and 'order' was re-sorted. Marks the gaps stale.
+void standings_update(Standings* st, const Car* cars, const int* order, int num_cars);
+// Gaps with every car placed on track at 'clock'; 'positions' (indexed like cars) receives
+// each car's TrackPosition
+void standings_update_gaps(Standings* st, const Car* cars, const int* order, int num_cars,
+                           const Track* track, double clock, TrackPosition* positions);
+// Resumed race: car 'car' already has 'best_lap' (0 for none) from its completed laps
+void standings_restore_lap(Standings* st, const Car* cars, int car, double best_lap);
+// A lap of car 'car' that last_lap_time no longer shows (the adaptive engine runs several
+// laps between two passes)
+void standings_add_lap(Standings* st, const Car* cars, int car, double lap);
+
+// Car in class position 'pos' of 'category'
+static inline int standings_class_car(const Standings* st, CarCategory category, int pos) {
+    return st->class_order[st->class_start[category] + pos];
+}
+
+// Cars entered in 'category' (running or not)
+static inline int standings_class_size(const Standings* st, CarCategory category) {
+    return st->class_start[category + 1] - st->class_start[category];
+}
+
+// Fastest lap of 'category' in seconds, 0 before anyone completed a lap
+static inline double standings_class_fastest_lap(const Standings* st, CarCategory category) {
+    int car = st->fastest[category];
+    return car >= 0 ? st->best_lap[car] : 0.0;
+}
+
+#endif
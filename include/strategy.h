@@ -0,0 +1,64 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "car.h"
+#include "race.h"
+
+// --- STRATEGY SEARCH ---
+// Finds the pit plan that gives one car the best expected finishing position from a
+// given point of a race. Every candidate plan is run on the same set of futures (the race
+// forked and re-seeded per sample), so plans are compared on identical weather, safety
+// cars and rival luck. Each future's weather is branched from the fork's timeline once and
+// shared read-only by every plan that runs it. Plans that are clearly behind after a few futures are dropped
+// before they are given more. The pick is the plan the search futures happened to suit best, so
+// its mean there flatters it: the pick and the baseline are run again on as many fresh futures,
+// and those are the numbers the gain is reported on.
+
+// One candidate plan. Stops for fuel or worn-out tires still happen whatever the plan says.
+typedef struct {
+    int first_stint_laps;           // Laps from the fork to the first planned stop
+    int stint_laps;                 // Laps between later stops
+    TireCompound first_compound;    // Dry compound fitted at the first stop
+    TireCompound compound;          // Dry compound fitted at every later stop
+    int rain_delay;                 // Sectors run on the wrong tires before pitting for a weather change
+} StrategyPlan;
+
+typedef struct {
+    StrategyPlan plan;
+    bool is_baseline;       // The built-in pit rule, run on the same futures for comparison
+    int samples;            // Futures run so far
+    double position_sum;
+    double position_sq_sum;
+    int dnfs;
+    int pruned_round;       // Round after which the plan was dropped, -1 if it survived
+} StrategyCandidate;
+
+typedef struct {
+    const RaceContext* fork;    // Race state to search from (left untouched)
+    int car;                    // Index into fork->cars of the car whose plan is searched
+    int num_samples;            // Futures given to each surviving plan in the end
+    int num_threads;            // 0 = one per core
+    uint64_t base_seed;         // Future s re-seeds the fork (and its weather) with base_seed + s;
+                                // the check's futures follow, from base_seed + num_samples
+} StrategyConfig;
+
+typedef struct {
+    int num_candidates;
+    StrategyCandidate* candidates;  // Best first once the search is done; [0] is the pick
+    StrategyCandidate baseline;
+    StrategyCandidate checked;  // The pick and the baseline again, on futures the search did not see
+    StrategyCandidate checked_baseline;
+    int rounds;
+    long races_run;             // Search and check
+    long races_unpruned;        // Races an exhaustive search with the same samples and check would have run
+    double wall_seconds;
+} StrategyResult;
+
+// Function Prototypes
+void strategy_search(const StrategyConfig* config, StrategyResult* result);
+void strategy_print(const StrategyResult* result, const RaceContext* fork, int car);
+void strategy_free(StrategyResult* result);
+
+#endif
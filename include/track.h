@@ -0,0 +1,69 @@
+#ifndef TRACK_H
+#define TRACK_H
+
+#include <stdbool.h>
+#include "car.h"
+
+// --- CIRCUIT MODEL ---
+// The lap is a table of straights and corners, each with the speed a car can carry
+// through it. The physics still produce one time per sector; the table decides where
+// inside the sector a car is after a given share of that time (slow corners take a
+// bigger share of the time than of the distance).
+
+typedef enum {
+    SEGMENT_STRAIGHT,
+    SEGMENT_CORNER
+} SegmentType;
+
+typedef struct {
+    const char* name;
+    SegmentType type;
+    int sector;
+    double length_m;
+    double speed_kmh;       // Top speed on a straight, apex speed in a corner
+} TrackSegment;
+
+#define TRACK_MAX_SEGMENTS 32
+
+typedef struct {
+    const TrackSegment* segments;
+    int num_segments;
+    double length_m;
+
+    // Precomputed from the table
+    double sector_start_m[4];           // [3] is the lap length
+    int sector_first[4];                // Segments of sector s: sector_first[s] .. sector_first[s + 1] - 1
+    double segment_start_m[TRACK_MAX_SEGMENTS];
+    double segment_time_share[TRACK_MAX_SEGMENTS];  // Share of its sector's time spent in the segment
+} Track;
+
+// Where a car is: metres covered since the start, and the race time at which it was there.
+// A car between two sector lines at the current clock has time == clock; one that has not
+// yet been simulated past a line sits on it with the time it crossed.
+typedef struct {
+    double distance;
+    double time;
+} TrackPosition;
+
+// --- TRAFFIC ---
+// Optional: a car loses time for every car it has to pass within TRAFFIC_RANGE_M ahead
+#define TRAFFIC_RANGE_M 150.0
+#define TRAFFIC_LOSS_SLOWER_CLASS 0.4   // Lapping a slower class (blue flag)
+#define TRAFFIC_LOSS_SAME_CLASS 0.2     // Fighting a car of the same class
+#define TRAFFIC_MAX_LOSS 3.0            // Per sector
+
+// Function Prototypes
+// Circuit de la Sarthe
+void track_init(Track* track);
+// Metres from the start line to the point reached after 'time_fraction' (0..1) of sector 's'
+double track_sector_distance(const Track* track, int sector, double time_fraction);
+// Segment containing a point 'lap_distance' metres after the line
+const TrackSegment* track_segment_at(const Track* track, double lap_distance);
+// Position of 'car' at race time 'clock'
+TrackPosition track_car_position(const Track* track, const Car* car, double clock);
+// Average speed of 'car' in m/s, from its last lap (or its current one, or a nominal lap)
+double track_car_speed(const Track* track, const Car* car);
+// Seconds 'behind' needs to reach where 'ahead' is, minus the time 'ahead' was there
+double track_gap(const Track* track, const Car* behind, TrackPosition behind_pos, TrackPosition ahead_pos);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <stdint.h>
+
+// --- Counter-based random number generator ---
+// Draw k of a stream is a pure function of (key, k): there is no hidden global state,
+// any stream can be replayed bit for bit from its seed, and a batch of draws is an
+// independent loop over k that the compiler can vectorize.
+typedef struct {
+    uint64_t key;       // Derived from the seed
+    uint64_t counter;   // Index of the next draw
+} Rng;
+
+// Function Prototypes
+void rng_seed(Rng* rng, uint64_t seed);
+uint32_t rng_next(Rng* rng);
+// Fills out[0..n) with the next n draws of the stream (same values as n calls to rng_next)
+void rng_fill(Rng* rng, uint32_t* out, int n);
+// Fills out[0..n) with draws index .. index + n - 1 without moving the stream, so
+// threads can each fill their own window of one batch
+void rng_fill_at(const Rng* rng, uint64_t index, uint32_t* out, int n);
+
+// Maps a 32-bit draw onto [0, n) without the bias or cost of '%'
+static inline uint32_t rng_below(uint32_t draw, uint32_t n) {
+    return (uint32_t)(((uint64_t)draw * n) >> 32);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef WEATHER_H
+#define WEATHER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "core.h"
+
+// --- WEATHER AND TRACK CONDITIONS ---
+// Rain showers, track wetness, temperatures, rubber and daylight across the 24 hours,
+// worked out once per seed into a timeline of fixed slots. Each slot also holds what the
+// physics need for every tire compound (sector time, wear and crash risk), so a sector on
+// any engine costs one table lookup by race time, whatever the model behind it.
+// A timeline is never written once built: any number of races can share one (see
+// race_set_weather), and forks of a race branch their own future from it.
+
+#define WEATHER_SLOT_SECONDS RACE_TICK_SECONDS
+#define WEATHER_SLOTS ((int)(TOTAL_RACE_TIME / WEATHER_SLOT_SECONDS) + 1)     // Last one holds the flag
+#define WEATHER_COMPOUNDS 4     // Indexed by TireCompound
+
+typedef enum {
+    TIME_DAY,
+    TIME_DUSK,
+    TIME_NIGHT,
+    TIME_DAWN
+} DayPhase;
+
+// One slot. The per-compound values are what the cars read; the rest is there to show
+// and to carry the model on when a timeline is branched. 76 bytes.
+typedef struct {
+    float tire_time[WEATHER_COMPOUNDS];     // Seconds added to a green-flag sector
+    float tire_wear[WEATHER_COMPOUNDS];     // Wear per sector before the random part (percent)
+    float danger[WEATHER_COMPOUNDS];        // Extra reliability lost per sector (crash risk)
+    float wetness;          // 0 = dry .. 1 = standing water
+    float rain;             // Intensity of the shower, 0 when dry
+    float grip;             // Dry-line grip: rubber and track temperature, 1 = nominal
+    float air_temp;         // Celsius
+    float track_temp;
+    float rubber;           // Grip from rubber laid down, washed away by rain
+    uint16_t lockout;       // Slots before the rain may start or stop again
+    uint8_t wet;            // Wets are the fastest tire: the built-in pit rule fits them
+    uint8_t phase;          // DayPhase
+} TrackConditions;
+
+typedef struct {
+    uint64_t seed;              // Seed of the stretch generated last
+    float air_base;             // Mean air temperature of the day
+    int num_slots;              // WEATHER_SLOTS
+    TrackConditions* slots;     // Slot k covers race time [k, k + 1) * WEATHER_SLOT_SECONDS
+    int* wet_change;            // First slot after k with the other wet flag, num_slots if none
+} WeatherTimeline;
+
+// Conditions at race time 't' (clamped to the race)
+static inline const TrackConditions* weather_at(const WeatherTimeline* tl, double t) {
+    int k = t > 0.0 ? (int)(t / WEATHER_SLOT_SECONDS) : 0;
+    return &tl->slots[k < tl->num_slots ? k : tl->num_slots - 1];
+}
+
+// Function Prototypes
+// The whole race for 'seed', starting dry at 16:00
+void weather_timeline_build(WeatherTimeline* tl, uint64_t seed);
+// 'dst' (zeroed, or a timeline of its own) becomes 'src' up to race time 'from_time'
+// and a new future drawn from 'seed' after it, carrying on from the conditions at that time
+void weather_timeline_branch(WeatherTimeline* dst, const WeatherTimeline* src, double from_time, uint64_t seed);
+// The timeline of 'seed' with its WEATHER_SLOTS slots as saved (a checkpoint): the slots
+// are copied, the rest is worked out from the seed, and nothing is generated
+void weather_timeline_load(WeatherTimeline* tl, uint64_t seed, const TrackConditions* slots);
+// Frees a timeline that allocated its own slots; not for one placed in storage of the caller's
+void weather_timeline_free(WeatherTimeline* tl);
+// Bytes a timeline's slots and index need in storage of the caller's (see weather_timeline_place)
+size_t weather_timeline_bytes(void);
+// An empty timeline (num_slots 0 until built) whose slots will live in 'storage', 64-byte aligned
+// and weather_timeline_bytes() long: build, branch and load then fill it without allocating
+void weather_timeline_place(WeatherTimeline* tl, void* storage);
+// Brings wet_change up to date after the slots were written
+void weather_timeline_index(WeatherTimeline* tl);
+// Race time at which the wet flag first differs from its value at 't' (HUGE_VAL if it never does)
+double weather_wet_change(const WeatherTimeline* tl, double t);
+// Local time of day in hours (0 .. 24) at race time 't'
+double weather_time_of_day(double t);
+DayPhase weather_day_phase(double hour);
+const char* weather_phase_name(DayPhase phase);
+
+#endif
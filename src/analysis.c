@@ -0,0 +1,535 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "analysis.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ANALYSIS_HAVE_AVX2 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#define NO_CURVE 0xFF
+#define PARTIAL_LAP 4   // More sectors than a lap has: the lap in progress is not timed
+
+static const char* const CATEGORY_NAMES[CAR_CATEGORIES] = { "HYPER", "LMP2", "LMGT3" };
+static const char* const TIRE_NAMES[ANALYSIS_TIRES] = { "Soft", "Medium", "Hard", "Wet" };
+
+// --- SKETCHES ---
+
+// Bin of 1.0 s: the float's exponent and top mantissa bits are the bin
+#define SKETCH_BASE (127 << SKETCH_SUB_BITS)
+#define SKETCH_SHIFT (23 - SKETCH_SUB_BITS)
+
+static void bins_reference(const float* values, int count, int32_t* bins) {
+    for (int i = 0; i < count; i++) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        int32_t bin = (bits >> 31) ? 0 : (int32_t)(bits >> SKETCH_SHIFT) - SKETCH_BASE;
+        bins[i] = bin < 0 ? 0 : (bin >= SKETCH_BINS ? SKETCH_BINS - 1 : bin);
+    }
+}
+
+#ifdef ANALYSIS_HAVE_AVX2
+// Eight at a time; negative values shift to negative bins and clamp to 0 like the reference
+static AVX2_TARGET void bins_avx2(const float* values, int count, int32_t* bins) {
+    const __m256i base = _mm256_set1_epi32(SKETCH_BASE);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i last = _mm256_set1_epi32(SKETCH_BINS - 1);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i bits = _mm256_loadu_si256((const __m256i*)&values[i]);
+        __m256i bin = _mm256_sub_epi32(_mm256_srai_epi32(bits, SKETCH_SHIFT), base);
+        bin = _mm256_min_epi32(_mm256_max_epi32(bin, zero), last);
+        _mm256_storeu_si256((__m256i*)&bins[i], bin);
+    }
+    bins_reference(values + i, count - i, bins + i);
+}
+#endif
+
+static void sketch_bins(const float* values, int count, int32_t* bins) {
+#ifdef ANALYSIS_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        bins_avx2(values, count, bins);
+        return;
+    }
+#endif
+    bins_reference(values, count, bins);
+}
+
+// Middle of a bin, in seconds
+static double bin_value(int bin) {
+    uint32_t bits = ((uint32_t)(bin + SKETCH_BASE) << SKETCH_SHIFT) | (1u << (SKETCH_SHIFT - 1));
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double sketch_quantile(const QuantileSketch* sk, double q) {
+    if (sk->count == 0) return 0.0;
+    uint64_t rank = (uint64_t)(q * (sk->count - 1) + 0.5);
+    uint64_t seen = 0;
+    for (int b = 0; b < SKETCH_BINS; b++) {
+        seen += sk->bins[b];
+        if (seen > rank) return bin_value(b);
+    }
+    return bin_value(SKETCH_BINS - 1);
+}
+
+static void sketch_add(QuantileSketch* dst, const QuantileSketch* src) {
+    dst->count += src->count;
+    dst->sum += src->sum;
+    for (int b = 0; b < SKETCH_BINS; b++) dst->bins[b] += src->bins[b];
+}
+
+static void totals_add(AnalysisTotals* dst, const AnalysisTotals* src) {
+    dst->records += src->records;
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        dst->laps[c] += src->laps[c];
+        dst->pit_stops[c] += src->pit_stops[c];
+        dst->retirements[c] += src->retirements[c];
+        sketch_add(&dst->pace[c][0], &src->pace[c][0]);
+        sketch_add(&dst->pace[c][1], &src->pace[c][1]);
+        sketch_add(&dst->pit_loss[c], &src->pit_loss[c]);
+        for (int t = 0; t < ANALYSIS_TIRES; t++) {
+            for (int a = 0; a < ANALYSIS_MAX_AGE; a++) {
+                dst->age_sum[c][t][a] += src->age_sum[c][t][a];
+                dst->age_laps[c][t][a] += src->age_laps[c][t][a];
+            }
+            dst->stints[c][t] += src->stints[c][t];
+            dst->stint_laps[c][t] += src->stint_laps[c][t];
+            dst->stint_sxy[c][t] += src->stint_sxy[c][t];
+            dst->stint_sxx[c][t] += src->stint_sxx[c][t];
+        }
+    }
+}
+
+// --- SETUP ---
+
+static void* alloc_or_die(size_t bytes) {
+    void* p = malloc(bytes > 0 ? bytes : 1);
+    if (!p) {
+        fprintf(stderr, "Error: Failed to allocate lap analysis.\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+void analysis_init(Analysis* an, int num_threads) {
+    memset(an, 0, sizeof(*an));
+    an->num_threads = num_threads > 0 ? num_threads : pool_default_threads();
+    team_init(&an->team, an->num_threads);
+
+    size_t worker_bytes = an->num_threads * sizeof(AnalysisWorker);     // A multiple of 64
+    an->workers = (AnalysisWorker*)aligned_alloc(64, worker_bytes);
+    if (!an->workers) {
+        fprintf(stderr, "Error: Failed to allocate lap analysis.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(an->workers, 0, worker_bytes);
+    for (int w = 0; w < an->num_threads; w++) {
+        AnalysisWorker* wk = &an->workers[w];
+        // A record completes at most one lap and one stop
+        wk->rows = (uint32_t*)alloc_or_die(ANALYSIS_CHUNK * sizeof(uint32_t));
+        wk->lap_time = (float*)alloc_or_die(ANALYSIS_CHUNK * sizeof(float));
+        wk->lap_sketch = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+        wk->lap_curve = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+        wk->lap_age = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+        wk->pit_loss = (float*)alloc_or_die(ANALYSIS_CHUNK * sizeof(float));
+        wk->pit_category = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+        wk->bins = (int32_t*)alloc_or_die(ANALYSIS_CHUNK * sizeof(int32_t));
+    }
+
+    an->col_car = (uint16_t*)alloc_or_die(ANALYSIS_CHUNK * sizeof(uint16_t));
+    an->col_flags = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+    an->col_sector = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+    an->col_tires = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+    an->col_state = (uint8_t*)alloc_or_die(ANALYSIS_CHUNK);
+    an->col_laps = (uint16_t*)alloc_or_die(ANALYSIS_CHUNK * sizeof(uint16_t));
+    an->col_time = (float*)alloc_or_die(ANALYSIS_CHUNK * sizeof(float));
+}
+
+void analysis_free(Analysis* an) {
+    team_free(&an->team);
+    for (int w = 0; w < an->num_threads; w++) {
+        AnalysisWorker* wk = &an->workers[w];
+        free(wk->rows);
+        free(wk->lap_time);
+        free(wk->lap_sketch);
+        free(wk->lap_curve);
+        free(wk->lap_age);
+        free(wk->pit_loss);
+        free(wk->pit_category);
+        free(wk->bins);
+    }
+    free(an->workers);
+    free(an->cars);
+    free(an->categories);
+    free(an->buffer);
+    free(an->col_car);
+    free(an->col_flags);
+    free(an->col_sector);
+    free(an->col_tires);
+    free(an->col_state);
+    free(an->col_laps);
+    free(an->col_time);
+    memset(an, 0, sizeof(*an));
+}
+
+void analysis_begin_race(Analysis* an, int num_cars, const unsigned char* categories) {
+    if (an->race_open) analysis_end_race(an);
+    if (num_cars > an->car_capacity) {
+        free(an->cars);
+        free(an->categories);
+        an->cars = (AnalysisCar*)alloc_or_die(num_cars * sizeof(AnalysisCar));
+        an->categories = (unsigned char*)alloc_or_die(num_cars);
+        an->car_capacity = num_cars;
+    }
+    an->num_cars = num_cars;
+    memset(an->cars, 0, num_cars * sizeof(AnalysisCar));
+    memcpy(an->categories, categories, num_cars);
+
+    // Contiguous blocks of cars: a worker's rows come out of the car column in one compare
+    for (int w = 0; w < an->num_threads; w++) {
+        an->workers[w].first_car = (int)((long)num_cars * w / an->num_threads);
+        an->workers[w].end_car = (int)((long)num_cars * (w + 1) / an->num_threads);
+    }
+    an->race_open = true;
+    an->races++;
+}
+
+// --- COLUMNS ---
+
+static void transpose_task(void* ctx, int task, int worker) {
+    (void)worker;
+    Analysis* an = (Analysis*)ctx;
+    size_t start = an->chunk_rows * task / an->num_threads;
+    size_t end = an->chunk_rows * (task + 1) / an->num_threads;
+    for (size_t r = start; r < end; r++) {
+        const TelemetryRecord* rec = &an->chunk[r];
+        an->col_car[r] = rec->car;
+        an->col_flags[r] = rec->flags;
+        an->col_sector[r] = rec->current_sector;
+        an->col_tires[r] = rec->tires;
+        an->col_state[r] = rec->state;
+        an->col_laps[r] = rec->laps_completed;
+        an->col_time[r] = rec->sector_time;
+    }
+}
+
+// Rows whose car is in [first, end), in order. One unsigned compare: car - first < end - first.
+static int select_reference(const uint16_t* cars, int start, int count, int first, int end, uint32_t* rows) {
+    int n = 0;
+    for (int r = start; r < count; r++) {
+        if ((uint16_t)(cars[r] - first) < (uint16_t)(end - first)) rows[n++] = (uint32_t)r;
+    }
+    return n;
+}
+
+#ifdef ANALYSIS_HAVE_AVX2
+// Sixteen cars per compare; the unsigned compare is a signed one with the sign bits flipped
+static AVX2_TARGET int select_avx2(const uint16_t* cars, int count, int first, int end, uint32_t* rows) {
+    const __m256i lo = _mm256_set1_epi16((short)first);
+    const __m256i flip = _mm256_set1_epi16((short)0x8000);
+    const __m256i span = _mm256_xor_si256(_mm256_set1_epi16((short)(end - first)), flip);
+    int n = 0;
+    int r = 0;
+    for (; r + 16 <= count; r += 16) {
+        __m256i car = _mm256_loadu_si256((const __m256i*)&cars[r]);
+        __m256i offset = _mm256_xor_si256(_mm256_sub_epi16(car, lo), flip);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi16(span, offset)) & 0x55555555u;
+        while (mask) {
+            rows[n++] = (uint32_t)(r + __builtin_ctz(mask) / 2);
+            mask &= mask - 1;
+        }
+    }
+    return n + select_reference(cars, r, count, first, end, rows + n);
+}
+#endif
+
+static int select_rows(const uint16_t* cars, int count, int first, int end, uint32_t* rows) {
+    if (end <= first) return 0;
+#ifdef ANALYSIS_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) return select_avx2(cars, count, first, end, rows);
+#endif
+    return select_reference(cars, 0, count, first, end, rows);
+}
+
+// --- LAPS AND STINTS ---
+
+static void start_stint(AnalysisCar* car, int tires, bool age_known) {
+    car->tires = (uint8_t)(tires < ANALYSIS_TIRES ? tires : TIRE_MEDIUM);
+    car->age_known = age_known;
+    car->tire_age = 0;
+    car->stint_laps = 0;
+    car->fit_n = 0;
+    car->fit_x = car->fit_y = car->fit_xy = car->fit_xx = 0.0;
+}
+
+static void close_stint(AnalysisTotals* tot, AnalysisCar* car, int category) {
+    if (car->stint_laps == 0) return;
+    tot->stints[category][car->tires]++;
+    tot->stint_laps[category][car->tires] += car->stint_laps;
+    if (car->fit_n >= 2) {
+        // Centred on the stint's own means
+        double n = car->fit_n;
+        tot->stint_sxy[category][car->tires] += car->fit_xy - car->fit_x * car->fit_y / n;
+        tot->stint_sxx[category][car->tires] += car->fit_xx - car->fit_x * car->fit_x / n;
+    }
+}
+
+// Car at the start of the race or of the recording
+static void start_car(AnalysisCar* car, const Analysis* an, uint32_t r) {
+    memset(car, 0, sizeof(*car));
+    car->active = (an->col_state[r] != RETIRED);
+    bool from_start = (an->col_laps[r] == 0 && an->col_sector[r] == 0);
+    start_stint(car, an->col_tires[r], from_start);
+    // A lap is only timed when all three of its sectors were seen
+    car->lap_sectors = from_start ? 0 : PARTIAL_LAP;
+}
+
+static void lap_done(AnalysisWorker* wk, AnalysisCar* car, int category) {
+    AnalysisTotals* tot = &wk->totals;
+    tot->laps[category]++;
+    car->stint_laps++;
+    bool pitted = car->lap_flags & TLM_PIT;
+    car->tire_age = pitted ? 0 : car->tire_age + 1;
+
+    bool wet = car->lap_wet == 3;
+    bool clean = car->lap_sectors == 3 && !(car->lap_flags & (TLM_PIT | TLM_SAFETY_CAR | TLM_CAUTION)) &&
+                 (car->lap_wet == 0 || wet);
+    if (clean) {
+        int k = wk->num_laps++;
+        wk->lap_time[k] = car->lap_time;
+        wk->lap_sketch[k] = (uint8_t)(category * 2 + wet);
+        wk->lap_curve[k] = NO_CURVE;
+        if (car->age_known && wet == (car->tires == TIRE_WET)) {
+            int age = car->tire_age < ANALYSIS_MAX_AGE ? car->tire_age : ANALYSIS_MAX_AGE;
+            wk->lap_curve[k] = (uint8_t)(category * ANALYSIS_TIRES + car->tires);
+            wk->lap_age[k] = (uint8_t)(age - 1);
+
+            double x = car->tire_age, y = car->lap_time;
+            car->fit_n++;
+            car->fit_x += x;
+            car->fit_y += y;
+            car->fit_xy += x * y;
+            car->fit_xx += x * x;
+        }
+    }
+    car->lap_time = 0.0f;
+    car->lap_sectors = 0;
+    car->lap_flags = 0;
+    car->lap_wet = 0;
+}
+
+// One record of a car owned by this worker
+static void step_car(Analysis* an, AnalysisWorker* wk, uint32_t r) {
+    int c = an->col_car[r];
+    AnalysisCar* car = &an->cars[c];
+    int category = an->categories[c];
+    uint8_t flags = an->col_flags[r];
+    wk->totals.records++;
+
+    if (flags & TLM_START) {
+        start_car(car, an, r);
+        return;
+    }
+    if (flags & TLM_RETIRED) {
+        if (car->active) {
+            wk->totals.retirements[category]++;
+            close_stint(&wk->totals, car, category);
+            car->active = false;
+        }
+        return;
+    }
+    if (!car->active) {
+        // No start marker for this car: picked up mid-race
+        if (an->col_state[r] == RETIRED) return;
+        start_car(car, an, r);
+    }
+
+    int sector = (an->col_sector[r] + 2) % 3;
+    float time = an->col_time[r];
+    bool wet = flags & TLM_RAIN;
+    car->lap_time += time;
+    car->lap_sectors++;
+    car->lap_flags |= flags;
+    car->lap_wet += wet;
+
+    if (flags & TLM_PIT) {
+        AnalysisTotals* tot = &wk->totals;
+        tot->pit_stops[category]++;
+        // Against the same sector on the same kind of track, both green
+        if (!(flags & (TLM_SAFETY_CAR | TLM_CAUTION)) && car->last_green[sector] > 0.0f &&
+            ((car->green_wet >> sector) & 1) == wet) {
+            int k = wk->num_pits++;
+            wk->pit_loss[k] = time - car->last_green[sector];
+            wk->pit_category[k] = (uint8_t)category;
+        }
+        close_stint(tot, car, category);
+        start_stint(car, an->col_tires[r], true);
+    } else if (!(flags & (TLM_SAFETY_CAR | TLM_CAUTION))) {
+        car->last_green[sector] = time;
+        car->green_wet = (uint8_t)((car->green_wet & ~(1u << sector)) | ((unsigned)wet << sector));
+    }
+
+    if (flags & TLM_LAP_DONE) lap_done(wk, car, category);
+}
+
+// The laps and stops a worker collected in this chunk, into its totals
+static void bin_laps(AnalysisWorker* wk) {
+    AnalysisTotals* tot = &wk->totals;
+    sketch_bins(wk->lap_time, wk->num_laps, wk->bins);
+    for (int k = 0; k < wk->num_laps; k++) {
+        int s = wk->lap_sketch[k];
+        QuantileSketch* sk = &tot->pace[s >> 1][s & 1];
+        sk->count++;
+        sk->sum += wk->lap_time[k];
+        sk->bins[wk->bins[k]]++;
+        int curve = wk->lap_curve[k];
+        if (curve != NO_CURVE) {
+            int category = curve / ANALYSIS_TIRES, tires = curve % ANALYSIS_TIRES;
+            tot->age_sum[category][tires][wk->lap_age[k]] += wk->lap_time[k];
+            tot->age_laps[category][tires][wk->lap_age[k]]++;
+        }
+    }
+
+    sketch_bins(wk->pit_loss, wk->num_pits, wk->bins);
+    for (int k = 0; k < wk->num_pits; k++) {
+        QuantileSketch* sk = &tot->pit_loss[wk->pit_category[k]];
+        sk->count++;
+        sk->sum += wk->pit_loss[k];
+        sk->bins[wk->bins[k]]++;
+    }
+    wk->num_laps = 0;
+    wk->num_pits = 0;
+}
+
+static void process_task(void* ctx, int task, int worker) {
+    (void)worker;
+    Analysis* an = (Analysis*)ctx;
+    AnalysisWorker* wk = &an->workers[task];
+    int count = select_rows(an->col_car, (int)an->chunk_rows, wk->first_car, wk->end_car, wk->rows);
+    for (int i = 0; i < count; i++) {
+        step_car(an, wk, wk->rows[i]);
+    }
+    bin_laps(wk);
+}
+
+void analysis_add(Analysis* an, const TelemetryRecord* records, size_t count) {
+    if (!an->race_open) {
+        fprintf(stderr, "Error: Lap analysis got records outside a race.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t done = 0; done < count; done += an->chunk_rows) {
+        an->chunk = records + done;
+        an->chunk_rows = (count - done < ANALYSIS_CHUNK) ? count - done : ANALYSIS_CHUNK;
+        team_run(&an->team, an->num_threads, transpose_task, an);
+        team_run(&an->team, an->num_threads, process_task, an);
+    }
+}
+
+void analysis_end_race(Analysis* an) {
+    if (!an->race_open) return;
+    for (int w = 0; w < an->num_threads; w++) {
+        AnalysisWorker* wk = &an->workers[w];
+        for (int c = wk->first_car; c < wk->end_car; c++) {
+            if (an->cars[c].active) close_stint(&wk->totals, &an->cars[c], an->categories[c]);
+        }
+    }
+    an->race_open = false;
+}
+
+bool analysis_add_file(Analysis* an, const char* path) {
+    TelemetryReader reader;
+    if (!telemetry_reader_open(&reader, path)) return false;
+    if (!an->buffer) an->buffer = (TelemetryRecord*)alloc_or_die(ANALYSIS_CHUNK * sizeof(TelemetryRecord));
+    analysis_begin_race(an, (int)reader.header.num_cars, reader.categories);
+    size_t count;
+    while ((count = telemetry_reader_next(&reader, an->buffer, ANALYSIS_CHUNK)) > 0) {
+        analysis_add(an, an->buffer, count);
+    }
+    analysis_end_race(an);
+    telemetry_reader_close(&reader);
+    return true;
+}
+
+void analysis_merge(Analysis* dst, const Analysis* src) {
+    for (int w = 0; w < src->num_threads; w++) {
+        totals_add(&dst->workers[0].totals, &src->workers[w].totals);
+    }
+    dst->races += src->races;
+}
+
+// --- REPORT ---
+
+void analysis_print(const Analysis* an) {
+    AnalysisTotals* tot = (AnalysisTotals*)calloc(1, sizeof(AnalysisTotals));
+    if (!tot) {
+        fprintf(stderr, "Error: Failed to allocate lap analysis.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int w = 0; w < an->num_threads; w++) totals_add(tot, &an->workers[w].totals);
+
+    printf("=== LAP ANALYSIS: %ld RACES, %llu SECTOR RECORDS ===\n", an->races, (unsigned long long)tot->records);
+
+    static const double QUANTILES[] = { 0.05, 0.25, 0.50, 0.75, 0.95 };
+    printf("\nPace on clean laps (s)\n");
+    printf("%-6s | %-5s | %9s | %7s | %7s | %7s | %7s | %7s | %7s\n",
+           "Class", "Track", "Laps", "p5", "p25", "p50", "p75", "p95", "Mean");
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        for (int wet = 0; wet < 2; wet++) {
+            const QuantileSketch* sk = &tot->pace[c][wet];
+            if (sk->count == 0) continue;
+            printf("%-6s | %-5s | %9llu", CATEGORY_NAMES[c], wet ? "Wet" : "Dry", (unsigned long long)sk->count);
+            for (int q = 0; q < 5; q++) printf(" | %7.2f", sketch_quantile(sk, QUANTILES[q]));
+            printf(" | %7.2f\n", sk->sum / sk->count);
+        }
+    }
+
+    // The curve as time lost against the first lap on the set
+    static const int AGES[] = { 5, 10, 15, 20, 25, 30 };
+    printf("\nTire degradation (clean laps; s lost per lap of tire age, and against lap 1 of the set)\n");
+    printf("%-6s | %-6s | %7s | %7s | %7s | %7s", "Class", "Tire", "Stints", "Laps", "s/lap", "Lap 1");
+    for (int a = 0; a < 6; a++) printf(" | %6s%-2d", "+", AGES[a]);
+    printf("\n");
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        for (int t = 0; t < ANALYSIS_TIRES; t++) {
+            if (tot->stints[c][t] == 0) continue;
+            printf("%-6s | %-6s | %7llu | %7.1f", CATEGORY_NAMES[c], TIRE_NAMES[t], (unsigned long long)tot->stints[c][t],
+                   (double)tot->stint_laps[c][t] / tot->stints[c][t]);
+            if (tot->stint_sxx[c][t] > 0.0) printf(" | %+7.3f", tot->stint_sxy[c][t] / tot->stint_sxx[c][t]);
+            else printf(" | %7s", "-");
+            const uint64_t* laps = tot->age_laps[c][t];
+            const double* sums = tot->age_sum[c][t];
+            if (laps[0] == 0) {
+                printf(" | %7s\n", "-");
+                continue;
+            }
+            double first = sums[0] / laps[0];
+            printf(" | %7.2f", first);
+            for (int a = 0; a < 6; a++) {
+                int k = AGES[a] - 1;
+                if (laps[k] > 0) printf(" | %+8.2f", sums[k] / laps[k] - first);
+                else printf(" | %8s", "-");
+            }
+            printf("\n");
+        }
+    }
+
+    printf("\nPit stops (loss: pit sector against the car's last green time through it, s)\n");
+    printf("%-6s | %9s | %7s | %7s | %7s | %7s | %11s\n", "Class", "Laps", "Stops", "p50", "p90", "Mean", "Retirements");
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        if (tot->laps[c] == 0 && tot->retirements[c] == 0) continue;
+        const QuantileSketch* sk = &tot->pit_loss[c];
+        printf("%-6s | %9llu | %7llu", CATEGORY_NAMES[c], (unsigned long long)tot->laps[c],
+               (unsigned long long)tot->pit_stops[c]);
+        if (sk->count > 0) {
+            printf(" | %7.2f | %7.2f | %7.2f", sketch_quantile(sk, 0.5), sketch_quantile(sk, 0.9), sk->sum / sk->count);
+        } else {
+            printf(" | %7s | %7s | %7s", "-", "-", "-");
+        }
+        printf(" | %11llu\n", (unsigned long long)tot->retirements[c]);
+    }
+    free(tot);
+}
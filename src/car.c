@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "car.h"
 #include "core.h"
+#include "instrument.h"
 
 // Constants for simulation (approximate sector times in seconds)
 #define BASE_TIME_LMH  38.0 // Fast sector
@@ -17,11 +19,9 @@
 // Tire wear per sector (percentage)
 #define TIRE_WEAR_RATE 0.8 
 
-void car_init(Car* car, int id, const char* team, const char* driver, CarCategory cat) {
+void car_init(Car* car, int id, CarCategory cat, Rng* rng) {
     if (!car) return;
     car->id = id;
-    strncpy(car->team_name, team, 63);
-    strncpy(car->driver_name, driver, 63);
     car->category = cat;
     car->state = RACING;
 
@@ -32,7 +32,7 @@ void car_init(Car* car, int id, const char* team, const char* driver, CarCategor
     car->reliability = 100.0;
     
     // Start on Slick tires (Randomly Soft or Medium)
-    car->current_tires = (rand() % 2 == 0) ? TIRE_SOFT : TIRE_MEDIUM;
+    car->current_tires = (rng_below(rng_next(rng), 2) == 0) ? TIRE_SOFT : TIRE_MEDIUM;
     
     car->current_lap_time = 0.0;
     car->last_lap_time = 0.0;
@@ -44,6 +44,12 @@ void car_init(Car* car, int id, const char* team, const char* driver, CarCategor
     for(int i=0; i<3; i++) car->sector_times[i] = 0.0;
 }
 
+void car_info_init(CarInfo* info, const char* team, const char* driver) {
+    if (!info) return;
+    info->team_name = team;
+    info->driver_name = driver;
+}
+
 // Internal helper to get base time
 static double get_base_sector_time(CarCategory cat) {
     switch (cat) {
@@ -54,13 +60,45 @@ static double get_base_sector_time(CarCategory cat) {
     }
 }
 
-void car_update(Car* car, double delta_time, bool is_safety_car, int weather_state) {
+// The built-in pit rule: stop when short of fuel or tires, or on the wrong tires for
+// the weather; a dry compound is picked at random
+static bool default_pit_rule(const Car* car, bool is_raining, const uint32_t* draws, TireCompound* compound) {
+    bool need_pit = false;
+    
+    // 1. Check Resources
+    if (car->fuel_level < 5.0 || car->tire_wear > 85.0) need_pit = true;
+
+    // 2. Check Strategy (Wrong Tires)
+    if (car->state == RACING) {
+        if (is_raining && car->current_tires != TIRE_WET) need_pit = true;
+        else if (!is_raining && car->current_tires == TIRE_WET) need_pit = true;
+    }
+    if (!need_pit) return false;
+
+    // Tire selection logic
+    if (is_raining) *compound = TIRE_WET;
+    else {
+        int r = rng_below(draws[DRAW_PIT_COMPOUND], 3);
+        if (r == 0) *compound = TIRE_SOFT;
+        else if (r == 1) *compound = TIRE_MEDIUM;
+        else *compound = TIRE_HARD;
+    }
+    return true;
+}
+
+unsigned car_update(Car* car, double delta_time, bool is_safety_car, unsigned caution,
+                    const TrackConditions* cond, const uint32_t* draws) {
+    return car_update_with_rule(car, delta_time, is_safety_car, caution, cond, draws, NULL, NULL);
+}
+
+unsigned car_update_with_rule(Car* car, double delta_time, bool is_safety_car, unsigned caution,
+                              const TrackConditions* cond, const uint32_t* draws, PitRule rule, void* rule_ctx) {
     (void)delta_time; 
 
     // NEW: Early Exit if Retired
     // If the car is out, it stops updating completely.
     if (car->state == RETIRED) {
-        return;
+        return 0;
     }
 
     // 0. Reset Pit State
@@ -69,51 +107,30 @@ void car_update(Car* car, double delta_time, bool is_safety_car, int weather_sta
     }
 
     double time = get_base_sector_time(car->category);
-    bool is_raining = (weather_state == 1); 
+    bool is_raining = cond->wet;
 
     // --- PHYSICS ENGINE ---
 
     if (is_safety_car) {
-        time = 80.0 + ((rand() % 100) / 100.0);
+        time = 80.0 + (rng_below(draws[DRAW_SC_PACE], 100) / 100.0);
         car->fuel_level -= 0.2;
         car->tire_wear += 0.05; 
         // Reliability stays stable under SC
     } 
     else {
-        // ... (Keep existing Tire Physics Logic) ...
-        double tire_perf_mod = 0.0;
-        double wear_rate_mod = 1.0;
-        
-        // NEW: Dangerous Driving Flag
-        bool dangerous_conditions = false;
-
-        if (is_raining) {
-            // RAIN PHYSICS
-            if (car->current_tires == TIRE_WET) {
-                tire_perf_mod = 5.0; 
-                wear_rate_mod = 1.0;
-            } else {
-                // SLICKS IN RAIN
-                tire_perf_mod = 25.0; 
-                wear_rate_mod = 0.5;  
-                dangerous_conditions = true; // High risk!
-            }
-        } else {
-             // ... (Keep existing Dry Physics) ...
-            if (car->current_tires == TIRE_SOFT) { tire_perf_mod = -0.5; wear_rate_mod = 1.2; }
-            else if (car->current_tires == TIRE_MEDIUM) { tire_perf_mod = 0.0; wear_rate_mod = 1.0; }
-            else if (car->current_tires == TIRE_HARD) { tire_perf_mod = 0.6; wear_rate_mod = 0.7; }
-            else if (car->current_tires == TIRE_WET) { tire_perf_mod = 3.0; wear_rate_mod = 3.0; }
-        }
+        // Tires, water, grip, temperature and daylight: one lookup in the conditions
+        int tires = car->current_tires;
 
         // Apply Time Logic
-        double random_var = (rand() % 200) / 100.0; 
+        double random_var = rng_below(draws[DRAW_LAP_VARIANCE], 200) / 100.0; 
         double wear_penalty = (car->tire_wear / 100.0) * 4.0; 
-        time += random_var + wear_penalty + tire_perf_mod;
+        time += random_var + wear_penalty + cond->tire_time[tires];
+        // Slow zone through this sector (one bit test, almost never taken)
+        if ((caution >> car->current_sector) & 1) time += CAUTION_TIME;
 
         // Resources
         car->fuel_level -= 2.0; 
-        car->tire_wear += (0.8 * wear_rate_mod) + ((rand() % 50)/100.0);
+        car->tire_wear += cond->tire_wear[tires] + (rng_below(draws[DRAW_TIRE_WEAR], 50) / 100.0);
         
         // --- NEW: RELIABILITY LOGIC ---
         
@@ -123,55 +140,41 @@ void car_update(Car* car, double delta_time, bool is_safety_car, int weather_sta
         else if (car->category == LMP2) decay = 0.03;
         else decay = 0.01; // GT3 are tanks
         
-        // 2. Danger Penalty (Simulates crash risk)
-        if (dangerous_conditions) {
-            decay += 2.5; // Massive hit to reliability (represents probability of crash)
-        }
-        
-        car->reliability -= decay;
+        // 2. Danger Penalty (Simulates crash risk: slicks on a wet track)
+        car->reliability -= decay + cond->danger[tires];
 
         // 3. Catastrophic Failure (Random Event)
         // 0.01% chance per tick to blow an engine instantly
-        if ((rand() % 10000) == 0) {
+        bool failure = rng_below(draws[DRAW_FAILURE], 10000) == 0;
+        if (failure) {
             car->reliability = -10.0; // Instant kill
+            INSTR_COUNT(COUNTER_FAILURES, 1);
         }
         
         // 4. Check Failure
         if (car->reliability <= 0.0) {
             car->state = RETIRED;
+            INSTR_COUNT(COUNTER_RETIREMENTS, 1);
             // We do NOT update times, the car stops here.
-            return; 
+            // Off the road in the wet, or stopped where it broke down
+            return (!failure && cond->danger[tires] > 0.0f) ? CAR_INCIDENT_CRASH : 1u << car->current_sector;
         }
     }
 
     // --- AI STRATEGY (PIT STOPS) ---
     // (Only if still running)
-    
-    bool need_pit = false;
-    
-    // 1. Check Resources
-    if (car->fuel_level < 5.0 || car->tire_wear > 85.0) need_pit = true;
-
-    // 2. Check Strategy (Wrong Tires)
-    if (car->state == RACING) {
-        if (is_raining && car->current_tires != TIRE_WET) need_pit = true;
-        else if (!is_raining && car->current_tires == TIRE_WET) need_pit = true;
-    }
+    TireCompound compound = car->current_tires;
+    bool need_pit = rule ? rule(car, is_raining, rule_ctx, &compound)
+                         : default_pit_rule(car, is_raining, draws, &compound);
 
     // Execute Pit Stop
     if (car->state == RACING && need_pit) {
         car->state = PIT_STOP;
-        time += 45.0; 
+        INSTR_COUNT(COUNTER_PIT_STOPS, 1);
+        time += PIT_STOP_TIME; 
         car->fuel_level = 100.0;
         car->tire_wear = 0.0;
-        // Tire selection logic
-        if (is_raining) car->current_tires = TIRE_WET;
-        else {
-            int r = rand() % 3;
-            if (r == 0) car->current_tires = TIRE_SOFT;
-            else if (r == 1) car->current_tires = TIRE_MEDIUM;
-            else car->current_tires = TIRE_HARD;
-        }
+        car->current_tires = compound;
     }
 
     // --- TELEMETRY UPDATE ---
@@ -186,4 +189,89 @@ void car_update(Car* car, double delta_time, bool is_safety_car, int weather_sta
         car->current_lap_time = 0.0;
         car->current_sector = 0;
     }
+    return 0;
+}
+
+// --- GREEN RUNS (adaptive engine) ---
+// What car_update() would do over a run of green-flag sectors, without the event queue in
+// between: each sector reads the conditions at its start, and its variance, extra wear and
+// fuel are as in car_update() (a draw gives the variances or the extra wear of three sectors).
+// The first catastrophic failure is one geometric draw for the whole run.
+// A run stops short of any sector that could bring the car in, so the pit rule never fires.
+// This is not closed-form lap or stint stepping: every sector is still walked. A sector's time
+// carries the wear of every sector before it, and its wear and pace come from its own weather
+// slot (slots are as long as a sector), so a run's time is no sum of like draws; summing over
+// the run's mean conditions drifted from the event engine. The walk is about 40% of an
+// adaptive race's time in a profile, so even dropping it entirely would not give the 10x that
+// closed-form stepping was meant for.
+
+#define WEAR_DRAW_MAX   0.49        // rng_below(draw, 50) / 100 at most
+
+int car_advance_green(Car* car, const WeatherTimeline* weather, double start, double until, Rng* rng,
+                      double* best_lap) {
+    *best_lap = 0.0;
+    int tires = car->current_tires;
+    const TrackConditions* cond = weather_at(weather, start);
+    // The wrong tires for the track mean a stop
+    if (car->state != RACING || cond->wet != (tires == TIRE_WET)) return -1;
+
+    // Sectors until the fuel runs low, all on the wet flag of the start
+    double limit = fmin(until, weather_wet_change(weather, start));
+    int fuel_sectors = (int)floor((car->fuel_level - 5.0) / 2.0);
+    if (fuel_sectors < 1 || start >= limit || car->tire_wear + cond->tire_wear[tires] + WEAR_DRAW_MAX > 85.0) return -1;
+
+    double base = get_base_sector_time(car->category);
+    double decay = car->category == LMH ? 0.05 : (car->category == LMP2 ? 0.03 : 0.01);
+    double failure_at = -1.0;     // Drawn with the first sector, so a run of none draws nothing
+
+    // The slot is walked forward rather than looked up: a sector rarely crosses more than one
+    int slot = (int)(cond - weather->slots);
+    double slot_end = (slot + 1) * WEATHER_SLOT_SECONDS;
+    uint32_t variance = 0, extra_wear = 0;
+    int run = 0;
+    while (run < fuel_sectors && car->total_race_time < limit) {
+        while (car->total_race_time >= slot_end && slot < weather->num_slots - 1) {
+            slot++;
+            slot_end += WEATHER_SLOT_SECONDS;
+        }
+        cond = &weather->slots[slot];
+        if (car->tire_wear + cond->tire_wear[tires] + WEAR_DRAW_MAX > 85.0) break;
+        if (run == 0) failure_at = floor(log((rng_next(rng) + 1.0) / 4294967296.0) / log(1.0 - 1.0 / 10000.0));
+        if (run % 3 == 0) {
+            variance = rng_below(rng_next(rng), 200 * 200 * 200);
+            extra_wear = rng_below(rng_next(rng), 50 * 50 * 50);
+        }
+        double time = base + (variance % 200) / 100.0 + (car->tire_wear / 100.0) * 4.0 + cond->tire_time[tires];
+        variance /= 200;
+        car->fuel_level -= 2.0;
+        car->tire_wear += cond->tire_wear[tires] + (extra_wear % 50) / 100.0;
+        extra_wear /= 50;
+        car->reliability -= decay + cond->danger[tires];
+
+        // Stopped in this sector: its fuel and wear are used, its time never comes
+        bool failure = run == failure_at;
+        if (failure || car->reliability <= 0.0) {
+            if (failure) {
+                car->reliability = -10.0;
+                INSTR_COUNT(COUNTER_FAILURES, 1);
+            }
+            car->state = RETIRED;
+            INSTR_COUNT(COUNTER_RETIREMENTS, 1);
+            return run;
+        }
+
+        car->sector_times[car->current_sector] = time;
+        car->current_lap_time += time;
+        car->total_race_time += time;
+        car->current_sector++;
+        if (car->current_sector > 2) {
+            car->laps_completed++;
+            car->last_lap_time = car->current_lap_time;
+            car->current_lap_time = 0.0;
+            car->current_sector = 0;
+            if (*best_lap == 0.0 || car->last_lap_time < *best_lap) *best_lap = car->last_lap_time;
+        }
+        run++;
+    }
+    return run > 0 ? run : -1;
 }
\ No newline at end of file
@@ -0,0 +1,357 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "car.h"
+#include "instrument.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CAR_BATCH_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+// --- SoA STORAGE ---
+
+void car_soa_alloc(CarSoA* soa, int num_cars) {
+    int cap = (num_cars + CAR_SOA_LANES - 1) / CAR_SOA_LANES * CAR_SOA_LANES;
+    if (cap == 0) cap = CAR_SOA_LANES;
+
+    // One block: 9 double columns then 5 int columns, each starting on a cache line
+    // (so parallel ticks can split the lanes into chunks that never share a line)
+    size_t dbl_bytes = ((size_t)cap * sizeof(double) + 63) / 64 * 64;
+    size_t int_bytes = ((size_t)cap * sizeof(int32_t) + 63) / 64 * 64;
+    size_t total = 9 * dbl_bytes + 5 * int_bytes;
+    char* block = aligned_alloc(64, total);
+    if (!block) {
+        fprintf(stderr, "Error: Failed to allocate SoA car state.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(block, 0, total);
+
+    soa->capacity = cap;
+    soa->fuel_level       = (double*)(block + 0 * dbl_bytes);
+    soa->tire_wear        = (double*)(block + 1 * dbl_bytes);
+    soa->reliability      = (double*)(block + 2 * dbl_bytes);
+    soa->current_lap_time = (double*)(block + 3 * dbl_bytes);
+    soa->last_lap_time    = (double*)(block + 4 * dbl_bytes);
+    soa->total_race_time  = (double*)(block + 5 * dbl_bytes);
+    for (int s = 0; s < 3; s++) {
+        soa->sector_times[s] = (double*)(block + (6 + s) * dbl_bytes);
+    }
+
+    char* ints = block + 9 * dbl_bytes;
+    soa->category       = (int32_t*)(ints + 0 * int_bytes);
+    soa->state          = (int32_t*)(ints + 1 * int_bytes);
+    soa->current_tires  = (int32_t*)(ints + 2 * int_bytes);
+    soa->current_sector = (int32_t*)(ints + 3 * int_bytes);
+    soa->laps_completed = (int32_t*)(ints + 4 * int_bytes);
+
+    // Padding lanes stay parked
+    for (int i = 0; i < cap; i++) soa->state[i] = RETIRED;
+}
+
+void car_soa_view(const CarSoA* soa, int first, int count, CarSoA* view) {
+    view->capacity = (count + CAR_SOA_LANES - 1) / CAR_SOA_LANES * CAR_SOA_LANES;
+    view->fuel_level       = soa->fuel_level + first;
+    view->tire_wear        = soa->tire_wear + first;
+    view->reliability      = soa->reliability + first;
+    view->current_lap_time = soa->current_lap_time + first;
+    view->last_lap_time    = soa->last_lap_time + first;
+    view->total_race_time  = soa->total_race_time + first;
+    for (int s = 0; s < 3; s++) {
+        view->sector_times[s] = soa->sector_times[s] + first;
+    }
+    view->category       = soa->category + first;
+    view->state          = soa->state + first;
+    view->current_tires  = soa->current_tires + first;
+    view->current_sector = soa->current_sector + first;
+    view->laps_completed = soa->laps_completed + first;
+}
+
+void car_soa_free(CarSoA* soa) {
+    // fuel_level is the start of the block
+    free(soa->fuel_level);
+    memset(soa, 0, sizeof(*soa));
+}
+
+void car_soa_load(CarSoA* soa, int lane, const Car* car) {
+    soa->fuel_level[lane] = car->fuel_level;
+    soa->tire_wear[lane] = car->tire_wear;
+    soa->reliability[lane] = car->reliability;
+    soa->current_lap_time[lane] = car->current_lap_time;
+    soa->last_lap_time[lane] = car->last_lap_time;
+    soa->total_race_time[lane] = car->total_race_time;
+    for (int s = 0; s < 3; s++) soa->sector_times[s][lane] = car->sector_times[s];
+    soa->category[lane] = car->category;
+    soa->state[lane] = car->state;
+    soa->current_tires[lane] = car->current_tires;
+    soa->current_sector[lane] = car->current_sector;
+    soa->laps_completed[lane] = car->laps_completed;
+}
+
+void car_soa_store(const CarSoA* soa, int lane, Car* car) {
+    car->fuel_level = soa->fuel_level[lane];
+    car->tire_wear = soa->tire_wear[lane];
+    car->reliability = soa->reliability[lane];
+    car->current_lap_time = soa->current_lap_time[lane];
+    car->last_lap_time = soa->last_lap_time[lane];
+    car->total_race_time = soa->total_race_time[lane];
+    for (int s = 0; s < 3; s++) car->sector_times[s] = soa->sector_times[s][lane];
+    car->category = (CarCategory)soa->category[lane];
+    car->state = (CarState)soa->state[lane];
+    car->current_tires = (TireCompound)soa->current_tires[lane];
+    car->current_sector = soa->current_sector[lane];
+    car->laps_completed = soa->laps_completed[lane];
+}
+
+// --- PORTABLE PATH ---
+// Runs the scalar reference on each lane. Used when the CPU has no AVX2.
+
+static unsigned update_batch_reference(CarSoA* soa, int num_cars, bool is_safety_car, unsigned caution,
+                                       const TrackConditions* cond, const uint32_t* draws) {
+    Car tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    unsigned incidents = 0;
+    for (int i = 0; i < num_cars; i++) {
+        car_soa_store(soa, i, &tmp);
+        incidents |= car_update(&tmp, 1.0, is_safety_car, caution, cond, &draws[i * CAR_DRAWS_PER_UPDATE]);
+        car_soa_load(soa, i, &tmp);
+    }
+    return incidents;
+}
+
+#ifdef CAR_BATCH_HAVE_AVX2
+
+// --- AVX2 KERNEL ---
+// Four cars per iteration. Every branch of car_update() becomes a lane mask and a blend,
+// and the per-category constants and the conditions' per-tire values become table gathers
+// (the conditions are floats, widened exactly to double as in car_update()). The arithmetic is the
+// same sequence of IEEE operations as the scalar path, so results match bit for bit.
+// Tables must be kept in sync with car_update() in car.c.
+
+static const double BASE_TIME[4]   = { 38.0, 41.0, 46.0, 50.0 };   // LMH, LMP2, LMGT3, fallback
+static const double DECAY[4]       = { 0.05, 0.03, 0.01, 0.01 };
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// Lossless uint32 -> double for four lanes
+static inline AVX2_TARGET __m256d u32_to_pd(__m128i v) {
+    __m128i flipped = _mm_xor_si128(v, _mm_set1_epi32((int)0x80000000u));
+    return _mm256_add_pd(_mm256_cvtepi32_pd(flipped), _mm256_set1_pd(2147483648.0));
+}
+
+// rng_below(draw, n) computed exactly in double: floor(draw * n / 2^32)
+static inline AVX2_TARGET __m256d below_pd(__m256d draw, double n) {
+    __m256d scaled = _mm256_mul_pd(_mm256_mul_pd(draw, _mm256_set1_pd(n)), _mm256_set1_pd(1.0 / 4294967296.0));
+    return _mm256_floor_pd(scaled);
+}
+
+// 4 x int32 lane mask -> 4 x 64-bit double mask
+static inline AVX2_TARGET __m256d mask_i2d(__m128i m) {
+    return _mm256_castsi256_pd(_mm256_cvtepi32_epi64(m));
+}
+
+// 4 x 64-bit double mask -> 4 x int32 lane mask
+static inline AVX2_TARGET __m128i mask_d2i(__m256d m) {
+    __m256i packed = _mm256_permutevar8x32_epi32(_mm256_castpd_si256(m), _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+    return _mm256_castsi256_si128(packed);
+}
+
+static inline AVX2_TARGET __m256d blend(__m256d if_false, __m256d if_true, __m256d mask) {
+    return _mm256_blendv_pd(if_false, if_true, mask);
+}
+
+// Plain bit select: GCC 12 turns _mm_blendv_epi8 on these masks into wrong AVX-512BW/VL
+// code under -march=native, and the lane masks here are always all-ones or all-zeros
+static inline AVX2_TARGET __m128i blend_i(__m128i if_false, __m128i if_true, __m128i mask) {
+    return _mm_or_si128(_mm_and_si128(mask, if_true), _mm_andnot_si128(mask, if_false));
+}
+
+// Per-tire value of the conditions for each lane
+static inline AVX2_TARGET __m256d gather_tire(const float* table, __m128i tires) {
+    return _mm256_cvtps_pd(_mm_i32gather_ps(table, tires, 4));
+}
+
+static AVX2_TARGET unsigned update_batch_avx2(CarSoA* soa, int num_cars, bool is_safety_car, unsigned caution,
+                                              const TrackConditions* cond, const uint32_t* draws) {
+    const int raining = cond->wet;
+    const __m128i v_caution = _mm_set1_epi32((int)caution);
+    unsigned incidents = 0;
+    const __m256d sc = _mm256_castsi256_pd(_mm256_set1_epi64x(is_safety_car ? -1 : 0));
+    const __m128i v_raining = _mm_set1_epi32(raining ? -1 : 0);
+    const __m128i stride = _mm_setr_epi32(0, CAR_DRAWS_PER_UPDATE, 2 * CAR_DRAWS_PER_UPDATE, 3 * CAR_DRAWS_PER_UPDATE);
+    const __m128i i_racing = _mm_set1_epi32(RACING);
+    const __m128i i_pit = _mm_set1_epi32(PIT_STOP);
+    const __m128i i_retired = _mm_set1_epi32(RETIRED);
+    const __m128i i_wet = _mm_set1_epi32(TIRE_WET);
+    const __m128i i_one = _mm_set1_epi32(1);
+    const __m256d zero = _mm256_setzero_pd();
+
+    for (int i = 0; i < num_cars; i += CAR_SOA_LANES) {
+        // --- Load lane state ---
+        __m128i state = _mm_load_si128((const __m128i*)&soa->state[i]);
+        __m128i cat = _mm_load_si128((const __m128i*)&soa->category[i]);
+        __m128i tires = _mm_load_si128((const __m128i*)&soa->current_tires[i]);
+        __m128i sector = _mm_load_si128((const __m128i*)&soa->current_sector[i]);
+        __m128i laps = _mm_load_si128((const __m128i*)&soa->laps_completed[i]);
+        __m256d fuel = _mm256_load_pd(&soa->fuel_level[i]);
+        __m256d wear = _mm256_load_pd(&soa->tire_wear[i]);
+        __m256d rel = _mm256_load_pd(&soa->reliability[i]);
+
+        // Draws: lane k reads draws[(i + k) * CAR_DRAWS_PER_UPDATE + slot]
+        // (lanes past num_cars are RETIRED, so their values are never used; clamp the index instead)
+        __m128i draw_idx = stride;
+        if (i + CAR_SOA_LANES > num_cars) {
+            int last = num_cars - 1 - i;
+            draw_idx = _mm_min_epi32(draw_idx, _mm_set1_epi32(last * CAR_DRAWS_PER_UPDATE));
+        }
+        const int* lane_draws = (const int*)&draws[i * CAR_DRAWS_PER_UPDATE];
+        __m256d d_sc   = u32_to_pd(_mm_i32gather_epi32(lane_draws + DRAW_SC_PACE, draw_idx, 4));
+        __m256d d_var  = u32_to_pd(_mm_i32gather_epi32(lane_draws + DRAW_LAP_VARIANCE, draw_idx, 4));
+        __m256d d_wear = u32_to_pd(_mm_i32gather_epi32(lane_draws + DRAW_TIRE_WEAR, draw_idx, 4));
+        __m256d d_fail = u32_to_pd(_mm_i32gather_epi32(lane_draws + DRAW_FAILURE, draw_idx, 4));
+        __m256d d_pit  = u32_to_pd(_mm_i32gather_epi32(lane_draws + DRAW_PIT_COMPOUND, draw_idx, 4));
+
+        // 0. Retired cars do nothing; pit state resets to racing
+        __m128i alive_i = _mm_xor_si128(_mm_cmpeq_epi32(state, i_retired), _mm_set1_epi32(-1));
+        __m256d alive = mask_i2d(alive_i);
+        state = blend_i(state, i_racing, _mm_cmpeq_epi32(state, i_pit));
+
+        __m128i cat_idx = _mm_min_epu32(cat, _mm_set1_epi32(3));
+        __m256d time = _mm256_i32gather_pd(BASE_TIME, cat_idx, 8);
+
+        // --- Safety car lanes ---
+        __m256d sc_time = _mm256_add_pd(_mm256_set1_pd(80.0), _mm256_div_pd(below_pd(d_sc, 100.0), _mm256_set1_pd(100.0)));
+        __m256d sc_fuel = _mm256_sub_pd(fuel, _mm256_set1_pd(0.2));
+        __m256d sc_wear = _mm256_add_pd(wear, _mm256_set1_pd(0.05));
+
+        // --- Green flag lanes ---
+        __m256d tire_perf = gather_tire(cond->tire_time, tires);
+        __m256d tire_wear = gather_tire(cond->tire_wear, tires);
+        __m256d danger = gather_tire(cond->danger, tires);
+
+        __m256d random_var = _mm256_div_pd(below_pd(d_var, 200.0), _mm256_set1_pd(100.0));
+        __m256d wear_penalty = _mm256_mul_pd(_mm256_div_pd(wear, _mm256_set1_pd(100.0)), _mm256_set1_pd(4.0));
+        __m256d gf_time = _mm256_add_pd(time, _mm256_add_pd(_mm256_add_pd(random_var, wear_penalty), tire_perf));
+        if (caution) {
+            // Lanes whose sector is a slow zone; the others add 0.0, which leaves them as they were
+            __m128i slow_i = _mm_cmpeq_epi32(_mm_and_si128(_mm_srlv_epi32(v_caution, sector), i_one), i_one);
+            gf_time = _mm256_add_pd(gf_time, blend(zero, _mm256_set1_pd(CAUTION_TIME), mask_i2d(slow_i)));
+        }
+        __m256d gf_fuel = _mm256_sub_pd(fuel, _mm256_set1_pd(2.0));
+        __m256d extra_wear = _mm256_div_pd(below_pd(d_wear, 50.0), _mm256_set1_pd(100.0));
+        __m256d gf_wear = _mm256_add_pd(wear, _mm256_add_pd(tire_wear, extra_wear));
+
+        __m256d decay = _mm256_i32gather_pd(DECAY, cat_idx, 8);
+        __m256d gf_rel = _mm256_sub_pd(rel, _mm256_add_pd(decay, danger));
+        __m256d failure = _mm256_cmp_pd(below_pd(d_fail, 10000.0), zero, _CMP_EQ_OQ);
+        gf_rel = blend(gf_rel, _mm256_set1_pd(-10.0), failure);
+
+        time = blend(gf_time, sc_time, sc);
+        fuel = blend(fuel, blend(gf_fuel, sc_fuel, sc), alive);
+        wear = blend(wear, blend(gf_wear, sc_wear, sc), alive);
+        rel = blend(rel, blend(gf_rel, rel, sc), alive);
+
+        // 4. Check failure (never under the safety car)
+        __m256d retire_now = _mm256_andnot_pd(sc, _mm256_and_pd(alive, _mm256_cmp_pd(rel, zero, _CMP_LE_OQ)));
+        __m256d running = _mm256_andnot_pd(retire_now, alive);
+        INSTR_COUNT(COUNTER_RETIREMENTS, __builtin_popcount(_mm256_movemask_pd(retire_now)));
+        INSTR_COUNT(COUNTER_FAILURES, __builtin_popcount(_mm256_movemask_pd(_mm256_andnot_pd(sc, _mm256_and_pd(alive, failure)))));
+        __m128i running_i = mask_d2i(running);
+
+        // Cars that stopped: rare, so the lanes are looked at one by one (tires and sector
+        // are still the ones of this sector)
+        int stopped = _mm256_movemask_pd(retire_now);
+        if (__builtin_expect(stopped != 0, 0)) {
+            int failed = _mm256_movemask_pd(failure);
+            for (int k = 0; k < CAR_SOA_LANES; k++) {
+                if (!((stopped >> k) & 1)) continue;
+                bool crash = !((failed >> k) & 1) && cond->danger[soa->current_tires[i + k]] > 0.0f;
+                incidents |= crash ? CAR_INCIDENT_CRASH : 1u << soa->current_sector[i + k];
+            }
+        }
+
+        // --- AI strategy (pit stops) ---
+        __m128i racing_i = _mm_and_si128(running_i, _mm_cmpeq_epi32(state, i_racing));
+        __m256d racing = mask_i2d(racing_i);
+        __m256d low_res = _mm256_or_pd(_mm256_cmp_pd(fuel, _mm256_set1_pd(5.0), _CMP_LT_OQ),
+                                       _mm256_cmp_pd(wear, _mm256_set1_pd(85.0), _CMP_GT_OQ));
+        __m128i on_wets = _mm_cmpeq_epi32(tires, i_wet);
+        __m128i wrong_tires = _mm_xor_si128(on_wets, v_raining);    // Wets in the dry or slicks in the rain
+        __m256d pit = _mm256_and_pd(racing, _mm256_or_pd(low_res, mask_i2d(wrong_tires)));
+        __m128i pit_i = mask_d2i(pit);
+        INSTR_COUNT(COUNTER_PIT_STOPS, __builtin_popcount(_mm256_movemask_pd(pit)));
+
+        time = blend(time, _mm256_add_pd(time, _mm256_set1_pd(PIT_STOP_TIME)), pit);
+        fuel = blend(fuel, _mm256_set1_pd(100.0), pit);
+        wear = blend(wear, zero, pit);
+        __m128i new_tires = raining ? i_wet : _mm256_cvttpd_epi32(below_pd(d_pit, 3.0));
+        tires = blend_i(tires, new_tires, pit_i);
+
+        state = blend_i(state, _mm_set1_epi32(PIT_STOP), pit_i);
+        state = blend_i(state, i_retired, _mm_xor_si128(running_i, _mm_set1_epi32(-1)));
+
+        // --- Telemetry update (running lanes only) ---
+        for (int s = 0; s < 3; s++) {
+            __m256d in_sector = _mm256_and_pd(running, mask_i2d(_mm_cmpeq_epi32(sector, _mm_set1_epi32(s))));
+            __m256d st = _mm256_load_pd(&soa->sector_times[s][i]);
+            _mm256_store_pd(&soa->sector_times[s][i], blend(st, time, in_sector));
+        }
+
+        __m256d lap_time = _mm256_load_pd(&soa->current_lap_time[i]);
+        __m256d last_lap = _mm256_load_pd(&soa->last_lap_time[i]);
+        __m256d total = _mm256_load_pd(&soa->total_race_time[i]);
+        __m256d new_lap_time = _mm256_add_pd(lap_time, time);
+        total = blend(total, _mm256_add_pd(total, time), running);
+
+        __m128i next_sector = _mm_add_epi32(sector, i_one);
+        __m128i wrap_i = _mm_and_si128(running_i, _mm_cmpgt_epi32(next_sector, _mm_set1_epi32(2)));
+        __m256d wrap = mask_i2d(wrap_i);
+        sector = blend_i(sector, next_sector, running_i);
+        sector = blend_i(sector, _mm_setzero_si128(), wrap_i);
+        laps = blend_i(laps, _mm_add_epi32(laps, i_one), wrap_i);
+        last_lap = blend(last_lap, new_lap_time, wrap);
+        lap_time = blend(lap_time, blend(new_lap_time, zero, wrap), running);
+
+        // --- Store ---
+        _mm256_store_pd(&soa->fuel_level[i], fuel);
+        _mm256_store_pd(&soa->tire_wear[i], wear);
+        _mm256_store_pd(&soa->reliability[i], rel);
+        _mm256_store_pd(&soa->current_lap_time[i], lap_time);
+        _mm256_store_pd(&soa->last_lap_time[i], last_lap);
+        _mm256_store_pd(&soa->total_race_time[i], total);
+        _mm_store_si128((__m128i*)&soa->state[i], state);
+        _mm_store_si128((__m128i*)&soa->current_tires[i], tires);
+        _mm_store_si128((__m128i*)&soa->current_sector[i], sector);
+        _mm_store_si128((__m128i*)&soa->laps_completed[i], laps);
+    }
+    return incidents;
+}
+
+#endif // CAR_BATCH_HAVE_AVX2
+
+// --- PATH SELECTION ---
+
+static CarBatchPath batch_path = CAR_BATCH_AUTO;
+
+bool car_batch_set_path(CarBatchPath path) {
+    if (path == CAR_BATCH_AVX2) {
+#ifdef CAR_BATCH_HAVE_AVX2
+        if (!__builtin_cpu_supports("avx2")) return false;
+#else
+        return false;
+#endif
+    }
+    batch_path = path;
+    return true;
+}
+
+unsigned car_update_batch(CarSoA* soa, int num_cars, bool is_safety_car, unsigned caution,
+                          const TrackConditions* cond, const uint32_t* draws) {
+    if (num_cars <= 0) return 0;
+#ifdef CAR_BATCH_HAVE_AVX2
+    if (batch_path != CAR_BATCH_PORTABLE && __builtin_cpu_supports("avx2")) {
+        return update_batch_avx2(soa, num_cars, is_safety_car, caution, cond, draws);
+    }
+#endif
+    return update_batch_reference(soa, num_cars, is_safety_car, caution, cond, draws);
+}
@@ -0,0 +1,109 @@
+#include "car.h"
+#include "instrument.h"
+
+// --- SPECIALIZED KERNELS ---
+// car_update() decides the category, wet or dry and the safety car for every car on
+// every tick. Within one tick of one category all three are the same for every car, so
+// each combination gets its own loop with them folded in as constants: the compiler drops
+// the dead branches and the per-category lookups, leaving only the decisions that really
+// differ from car to car (tires, failures, pit stops). The tick's conditions are one slot
+// of the weather timeline, read through the same pointer by every car. The caution mask
+// depends on the car's sector, so it stays an argument: one shift and test per car.
+// Same sequence of IEEE operations as car_update(), so results match bit for bit.
+// Constants must be kept in sync with car_update() in car.c.
+
+#define KERNEL_INLINE static inline __attribute__((always_inline))
+
+// One car. The arguments between 'draws' and 'cond' are compile-time constants in the kernels below.
+KERNEL_INLINE unsigned update_one(Car* car, const uint32_t* draws, double base_time, double decay,
+                                  bool is_raining, bool is_safety_car, const TrackConditions* cond,
+                                  unsigned caution) {
+    if (car->state == RETIRED) return 0;
+    if (car->state == PIT_STOP) car->state = RACING;
+
+    double time;
+    if (is_safety_car) {
+        time = 80.0 + (rng_below(draws[DRAW_SC_PACE], 100) / 100.0);
+        car->fuel_level -= 0.2;
+        car->tire_wear += 0.05;
+    } else {
+        int tires = car->current_tires;
+        double random_var = rng_below(draws[DRAW_LAP_VARIANCE], 200) / 100.0;
+        double wear_penalty = (car->tire_wear / 100.0) * 4.0;
+        time = base_time + (random_var + wear_penalty + cond->tire_time[tires]);
+        if ((caution >> car->current_sector) & 1) time += CAUTION_TIME;
+
+        car->fuel_level -= 2.0;
+        car->tire_wear += cond->tire_wear[tires] + (rng_below(draws[DRAW_TIRE_WEAR], 50) / 100.0);
+
+        car->reliability -= decay + cond->danger[tires];
+        bool failure = rng_below(draws[DRAW_FAILURE], 10000) == 0;
+        car->reliability = failure ? -10.0 : car->reliability;
+        INSTR_COUNT(COUNTER_FAILURES, failure);
+        if (car->reliability <= 0.0) {
+            car->state = RETIRED;
+            INSTR_COUNT(COUNTER_RETIREMENTS, 1);
+            return (!failure && cond->danger[tires] > 0.0f) ? CAR_INCIDENT_CRASH : 1u << car->current_sector;
+        }
+    }
+
+    // The built-in pit rule
+    bool wrong_tires = is_raining ? car->current_tires != TIRE_WET : car->current_tires == TIRE_WET;
+    bool racing = car->state == RACING;
+    if (racing && (car->fuel_level < 5.0 || car->tire_wear > 85.0 || wrong_tires)) {
+        car->state = PIT_STOP;
+        INSTR_COUNT(COUNTER_PIT_STOPS, 1);
+        time += PIT_STOP_TIME;
+        car->fuel_level = 100.0;
+        car->tire_wear = 0.0;
+        // rng_below(draw, 3) is 0, 1 or 2: TIRE_SOFT, TIRE_MEDIUM or TIRE_HARD
+        car->current_tires = is_raining ? TIRE_WET : (TireCompound)rng_below(draws[DRAW_PIT_COMPOUND], 3);
+    }
+
+    car->sector_times[car->current_sector] = time;
+    car->current_lap_time += time;
+    car->total_race_time += time;
+
+    car->current_sector++;
+    if (car->current_sector > 2) {
+        car->laps_completed++;
+        car->last_lap_time = car->current_lap_time;
+        car->current_lap_time = 0.0;
+        car->current_sector = 0;
+    }
+    return 0;
+}
+
+#define DEFINE_KERNEL(name, base_time, decay, is_raining, is_safety_car)                      \
+    static unsigned name(Car* cars, const int* index, int count, const uint32_t* draws,       \
+                         const TrackConditions* cond, unsigned caution) {                     \
+        unsigned incidents = 0;                                                               \
+        for (int k = 0; k < count; k++) {                                                     \
+            int i = index[k];                                                                 \
+            incidents |= update_one(&cars[i], &draws[i * CAR_DRAWS_PER_UPDATE], base_time,    \
+                                    decay, is_raining, is_safety_car, cond, caution);         \
+        }                                                                                     \
+        return incidents;                                                                     \
+    }
+
+// Green flag: base sector time and reliability decay per category (LMH, LMP2, LMGT3)
+DEFINE_KERNEL(kernel_lmh_dry,   38.0, 0.05, false, false)
+DEFINE_KERNEL(kernel_lmh_rain,  38.0, 0.05, true,  false)
+DEFINE_KERNEL(kernel_lmp2_dry,  41.0, 0.03, false, false)
+DEFINE_KERNEL(kernel_lmp2_rain, 41.0, 0.03, true,  false)
+DEFINE_KERNEL(kernel_gt3_dry,   46.0, 0.01, false, false)
+DEFINE_KERNEL(kernel_gt3_rain,  46.0, 0.01, true,  false)
+// Behind the safety car every category runs the same pace
+DEFINE_KERNEL(kernel_sc_dry,    0.0,  0.0,  false, true)
+DEFINE_KERNEL(kernel_sc_rain,   0.0,  0.0,  true,  true)
+
+// [category][is_wet][is_safety_car]
+static const CarKernel KERNELS[CAR_CATEGORIES][2][2] = {
+    { { kernel_lmh_dry,  kernel_sc_dry }, { kernel_lmh_rain,  kernel_sc_rain } },
+    { { kernel_lmp2_dry, kernel_sc_dry }, { kernel_lmp2_rain, kernel_sc_rain } },
+    { { kernel_gt3_dry,  kernel_sc_dry }, { kernel_gt3_rain,  kernel_sc_rain } }
+};
+
+CarKernel car_kernel(CarCategory category, bool is_wet, bool is_safety_car) {
+    return KERNELS[category][is_wet][is_safety_car];
+}
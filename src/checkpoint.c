@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "checkpoint.h"
+
+// FNV-1a over a byte range, continuing from 'hash'
+static uint32_t fnv1a(uint32_t hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// --- SAVE ---
+
+bool checkpoint_save(const RaceContext* race, const char* path) {
+    int n = race->num_cars;
+    int num_events = race_has_events(race) ? race->events.size : 0;
+
+    size_t names_size = 0;
+    for (int i = 0; i < n; i++) {
+        names_size += strlen(race->info[i].team_name) + 1 + strlen(race->info[i].driver_name) + 1;
+    }
+    int num_slots = WEATHER_SLOTS;
+    size_t weather_bytes = (size_t)num_slots * sizeof(TrackConditions);
+    size_t payload_size = n * sizeof(CheckpointCar) + num_events * sizeof(CheckpointEvent) + weather_bytes + names_size;
+    char* payload = (char*)calloc(payload_size > 0 ? payload_size : 1, 1);
+    if (!payload) {
+        fprintf(stderr, "Error: Failed to allocate checkpoint buffer.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    CheckpointCar* cars = (CheckpointCar*)payload;
+    for (int i = 0; i < n; i++) {
+        const Car* car = &race->cars[i];
+        CheckpointCar* out = &cars[i];
+        out->fuel_level = car->fuel_level;
+        out->tire_wear = car->tire_wear;
+        out->reliability = car->reliability;
+        out->speed_kmh = car->speed_kmh;
+        out->current_lap_time = car->current_lap_time;
+        out->last_lap_time = car->last_lap_time;
+        for (int s = 0; s < 3; s++) out->sector_times[s] = car->sector_times[s];
+        out->total_race_time = car->total_race_time;
+        out->best_lap = race->standings.best_lap[i];
+        out->green_run_from = race->green_run_from[i];
+        out->laps_completed = car->laps_completed;
+        out->category = (uint8_t)car->category;
+        out->state = (uint8_t)car->state;
+        out->current_tires = (uint8_t)car->current_tires;
+        out->current_sector = (uint8_t)car->current_sector;
+        out->has_pitted_this_lap = car->has_pitted_this_lap;
+    }
+
+    CheckpointEvent* events = (CheckpointEvent*)(cars + n);
+    for (int i = 0; i < num_events; i++) {
+        const RaceEvent* ev = &race->events.heap[i];
+        events[i].time = ev->time;
+        events[i].seq = ev->seq;
+        events[i].car = ev->car;
+        events[i].type = (int32_t)ev->type;
+    }
+
+    char* weather = (char*)(events + num_events);
+    if (race->weather) {
+        memcpy(weather, race->weather->slots, weather_bytes);
+    } else {
+        // Saved before its first step: the race has not built its timeline yet
+        WeatherTimeline built = { 0 };
+        weather_timeline_build(&built, race->seed);
+        memcpy(weather, built.slots, weather_bytes);
+        weather_timeline_free(&built);
+    }
+
+    char* names = weather + weather_bytes;
+    for (int i = 0; i < n; i++) {
+        size_t len = strlen(race->info[i].team_name) + 1;
+        memcpy(names, race->info[i].team_name, len);
+        names += len;
+        len = strlen(race->info[i].driver_name) + 1;
+        memcpy(names, race->info[i].driver_name, len);
+        names += len;
+    }
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.num_cars = n;
+    header.seed = race->seed;
+    header.rng_key = race->rng.key;
+    header.rng_counter = race->rng.counter;
+    header.elapsed_time = race->elapsed_time;
+    for (int s = 0; s < 3; s++) header.caution_end[s] = race->caution_end[s];
+    header.engine = race->engine;
+    header.weather_size = sizeof(TrackConditions);
+    header.weather_slots = (uint32_t)num_slots;
+    header.safety_car_timer = race->safety_car_timer;
+    header.safety_car_active = race->safety_car_active;
+    header.traffic = race->traffic;
+    header.car_size = sizeof(CheckpointCar);
+    header.event_size = sizeof(CheckpointEvent);
+    header.num_events = num_events;
+    header.next_event_seq = race_has_events(race) ? race->events.next_seq : 0;
+    header.names_size = (uint32_t)names_size;
+    header.checksum = fnv1a(2166136261u, payload, payload_size);
+
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE* file = fopen(tmp_path, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot write checkpoint '%s'.\n", tmp_path);
+        free(payload);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(payload, 1, payload_size, file) == payload_size &&
+              fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = (fclose(file) == 0) && ok;
+    free(payload);
+    if (!ok || rename(tmp_path, path) != 0) {
+        fprintf(stderr, "Error: Failed to write checkpoint '%s'.\n", path);
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+// --- LOAD ---
+
+bool checkpoint_load(const char* path, EntryList* entries, RaceContext* race) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open checkpoint '%s'.\n", path);
+        return false;
+    }
+    CheckpointHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 ||
+        header.version != CHECKPOINT_VERSION || header.car_size != sizeof(CheckpointCar) ||
+        header.event_size != sizeof(CheckpointEvent) || header.weather_size != sizeof(TrackConditions) ||
+        header.weather_slots != WEATHER_SLOTS || header.engine < ENGINE_SCALAR ||
+        header.engine > ENGINE_ADAPTIVE) {
+        fprintf(stderr, "Error: '%s' is not a supported checkpoint.\n", path);
+        fclose(file);
+        return false;
+    }
+
+    int n = header.num_cars;
+    size_t payload_size = (size_t)n * sizeof(CheckpointCar) +
+                          (size_t)header.num_events * sizeof(CheckpointEvent) +
+                          (size_t)header.weather_slots * sizeof(TrackConditions) + header.names_size;
+    char* payload = (char*)malloc(payload_size + 1);
+    if (!payload) {
+        fprintf(stderr, "Error: Failed to allocate checkpoint buffer.\n");
+        exit(EXIT_FAILURE);
+    }
+    bool ok = fread(payload, 1, payload_size, file) == payload_size;
+    fclose(file);
+    if (!ok || fnv1a(2166136261u, payload, payload_size) != header.checksum) {
+        fprintf(stderr, "Error: Checkpoint '%s' is truncated or corrupt.\n", path);
+        free(payload);
+        return false;
+    }
+    payload[payload_size] = '\0';   // The last name is terminated even in a damaged file
+
+    const CheckpointCar* cars = (const CheckpointCar*)payload;
+    const CheckpointEvent* events = (const CheckpointEvent*)(cars + n);
+    for (uint32_t i = 0; i < header.num_events; i++) {
+        if (events[i].car < -1 || events[i].car >= n || events[i].type < EVENT_SECTOR ||
+            events[i].type > EVENT_SAFETY_CAR_IN) {
+            fprintf(stderr, "Error: Checkpoint '%s' is truncated or corrupt.\n", path);
+            free(payload);
+            return false;
+        }
+    }
+
+    // The entry list, so the race can point into its pool as usual
+    entry_list_init(entries);
+    snprintf(entries->source, sizeof(entries->source), "%s", path);
+    const TrackConditions* weather = (const TrackConditions*)(events + header.num_events);
+    const char* names = (const char*)(weather + header.weather_slots);
+    const char* names_end = names + header.names_size;
+    for (int i = 0; i < n; i++) {
+        const char* team = names;
+        const char* driver = (team < names_end) ? team + strlen(team) + 1 : names_end;
+        names = (driver < names_end) ? driver + strlen(driver) + 1 : names_end + 1;
+        if (names > names_end || cars[i].category > LMGT3 || cars[i].state > RETIRED ||
+            cars[i].current_tires > TIRE_WET || cars[i].current_sector > 2) {
+            fprintf(stderr, "Error: Checkpoint '%s' is truncated or corrupt.\n", path);
+            entry_list_free(entries);
+            free(payload);
+            return false;
+        }
+        entry_list_add(entries, team, driver, (CarCategory)cars[i].category);
+    }
+
+    race_init_seeded(race, entries, header.seed);
+    for (int i = 0; i < n; i++) {
+        const CheckpointCar* in = &cars[i];
+        Car* car = &race->cars[i];
+        car->fuel_level = in->fuel_level;
+        car->tire_wear = in->tire_wear;
+        car->reliability = in->reliability;
+        car->speed_kmh = in->speed_kmh;
+        car->current_lap_time = in->current_lap_time;
+        car->last_lap_time = in->last_lap_time;
+        for (int s = 0; s < 3; s++) car->sector_times[s] = in->sector_times[s];
+        car->total_race_time = in->total_race_time;
+        car->laps_completed = in->laps_completed;
+        car->state = (CarState)in->state;
+        car->current_tires = (TireCompound)in->current_tires;
+        car->current_sector = in->current_sector;
+        car->has_pitted_this_lap = in->has_pitted_this_lap;
+        standings_restore_lap(&race->standings, race->cars, i, in->best_lap);
+        race->green_run_from[i] = in->green_run_from;
+    }
+    race->rng.key = header.rng_key;
+    race->rng.counter = header.rng_counter;
+    race->elapsed_time = header.elapsed_time;
+    race_load_weather(race, weather);
+    race->safety_car_active = header.safety_car_active;
+    race->safety_car_timer = header.safety_car_timer;
+    for (int s = 0; s < 3; s++) race->caution_end[s] = header.caution_end[s];
+    race->caution_mask = race_caution_at(race, race->elapsed_time);
+    race->traffic = header.traffic;
+    race_update_positions(race);
+
+    if (header.engine == ENGINE_EVENT || header.engine == ENGINE_ADAPTIVE) {
+        // The pending events as saved: starting the engine afresh would draw new ones
+        event_queue_init(&race->events, header.num_events > 0 ? header.num_events : 1);
+        for (uint32_t i = 0; i < header.num_events; i++) {
+            RaceEvent* ev = &race->events.heap[i];
+            ev->time = events[i].time;
+            ev->seq = events[i].seq;
+            ev->car = events[i].car;
+            ev->type = (EventType)events[i].type;
+            if (ev->type == EVENT_SAFETY_CAR_OUT) race->next_safety_car = ev->time;
+        }
+        race->events.size = header.num_events;
+        race->events.next_seq = header.next_event_seq;
+        race->engine = (RaceEngine)header.engine;
+    } else {
+        race_set_engine(race, (RaceEngine)header.engine);
+    }
+    race_update_standings(race);
+
+    free(payload);
+    return true;
+}
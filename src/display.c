@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <math.h>
+#include "display.h"
+
+static const char* const SEPARATOR =
+    "----------------------------------------------------------------------------------------------------------------------------";
+
+static const char* category_name(CarCategory category) {
+    if (category == LMH) return "HYPER";
+    if (category == LMP2) return "LMP2";
+    return "LMGT3";
+}
+
+// "3:27.4", or "---" before the first lap
+static void format_lap(char* out, size_t size, double lap_time) {
+    if (lap_time <= 0.0) {
+        snprintf(out, size, "---");
+        return;
+    }
+    // Rounded to tenths before the split, so 119.97 s is "2:00.0", never "1:60.0"
+    long tenths = lround(lap_time * 10.0);
+    snprintf(out, size, "%ld:%02ld.%ld", tenths / 600, (tenths % 600) / 10, tenths % 10);
+}
+
+// Screen rows needed to show a field of 'num_cars'
+int status_screen_rows(int num_cars) {
+    return STATUS_HEADER_ROWS + num_cars;
+}
+
+// Draws the live leaderboard into the screen's back buffer and presents it.
+// Only cells that changed since the previous frame reach the terminal.
+void print_status(Screen* screen, const RaceSnapshot* race) {
+    screen_clear(screen);
+
+    int hours = (int)race->elapsed_time / 3600;
+    int minutes = ((int)race->elapsed_time % 3600) / 60;
+    int seconds = (int)race->elapsed_time % 60;
+
+    screen_put(screen, 0, 0, COLOR_DEFAULT, "=== LE MANS 24H SIMULATION ===");
+
+    // Weather Display
+    const TrackConditions* cond = &race->conditions;
+    bool night = cond->phase == TIME_NIGHT;
+    const char* sky = cond->rain > 0.0f ? "RAIN" : (night ? "CLEAR" : "SUNNY");
+    const char* track = cond->wet ? "WET TRACK" : (cond->wetness > 0.0f ? "DAMP TRACK" : "DRY TRACK");
+    int col = screen_put(screen, 1, 0, COLOR_DEFAULT, "Weather: ");
+    col = screen_put(screen, 1, col, COLOR_DEFAULT, cond->rain > 0.0f ? "🌧️  " : (night ? "🌙  " : "☀️  "));
+    col = screen_printf(screen, 1, col, cond->wet ? COLOR_BLUE : COLOR_YELLOW, "%s / %s", sky, track);
+    col = screen_printf(screen, 1, col, COLOR_DEFAULT, "  Time: %02dh %02dm %02ds", hours, minutes, seconds);
+
+    double local = weather_time_of_day(race->elapsed_time);
+    col = screen_printf(screen, 1, col, COLOR_DEFAULT, "  (%02d:%02d %s)", (int)local, (int)(local * 60.0) % 60,
+                        weather_phase_name((DayPhase)cond->phase));
+    // Replays record only the wet flag (grip 0)
+    if (cond->grip > 0.0f) {
+        screen_printf(screen, 1, col, COLOR_DEFAULT, "  Air %.0fC  Track %.0fC  Water %.0f%%  Grip %.1f%%",
+                      cond->air_temp, cond->track_temp, 100.0 * cond->wetness, 100.0 * cond->grip);
+    }
+
+    // Fastest lap of each class (row 2)
+    col = screen_put(screen, 2, 0, COLOR_DEFAULT, "Fastest laps:");
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        char lap_str[16];
+        format_lap(lap_str, sizeof(lap_str), race->fastest_lap[c]);
+        if (race->fastest[c] > 0) {
+            col = screen_printf(screen, 2, col, COLOR_DEFAULT, "  %s #%d %s", category_name((CarCategory)c), race->fastest[c], lap_str);
+        } else {
+            col = screen_printf(screen, 2, col, COLOR_DEFAULT, "  %s %s", category_name((CarCategory)c), lap_str);
+        }
+    }
+
+    // Safety Car Alert (rows 3-5)
+    if (race->safety_car_active) {
+        screen_put(screen, 3, 0, COLOR_BANNER, "************************************************************************");
+        screen_put(screen, 4, 0, COLOR_BANNER, "   SAFETY CAR DEPLOYED  -  NO OVERTAKING  -  SLOW DOWN  -  SC IN LAP   ");
+        screen_put(screen, 5, 0, COLOR_BANNER, "************************************************************************");
+    } else if (race->caution_mask == CAUTION_ALL) {
+        screen_put(screen, 3, 0, COLOR_BANNER, "Status: FULL COURSE YELLOW - 80 KM/H EVERYWHERE");
+    } else if (race->caution_mask) {
+        col = screen_put(screen, 3, 0, COLOR_BANNER, "Status: SLOW ZONE");
+        for (int s = 0; s < 3; s++) {
+            if ((race->caution_mask >> s) & 1) col = screen_printf(screen, 3, col, COLOR_BANNER, " S%d", s + 1);
+        }
+    } else {
+        screen_put(screen, 3, 0, COLOR_DEFAULT, "Status: GREEN FLAG");
+    }
+
+    // Header
+    screen_printf(screen, 7, 0, COLOR_DEFAULT, "%-4s | %-25s | %-10s | %-8s | %-12s | %-10s | %-10s | %-10s | %-6s",
+                  "Pos", "Team", "Cat", "Laps", "Gap", "Int", "State", "Tire", "Rel%");
+    screen_put(screen, 8, 0, COLOR_DEFAULT, SEPARATOR);
+
+    if (race->num_cars == 0) {
+        screen_present(screen);
+        return;
+    }
+    const SnapshotCar* leader = &race->cars[0];
+
+    for (int i = 0; i < race->num_cars; i++) {
+        const SnapshotCar* c = &race->cars[i];
+        int row = STATUS_HEADER_ROWS + i;
+        
+        // Check if retired to override colors
+        bool is_retired = (c->state == RETIRED);
+        ScreenColor base_color = is_retired ? COLOR_GRAY : COLOR_DEFAULT;
+
+        // 1. Categories, with the position in class
+        ScreenColor cat_color = COLOR_GRAY;
+        char cat_str[20];
+        sprintf(cat_str, "%s P%d", category_name(c->category), c->class_position + 1);
+
+        if (!is_retired) {
+            if (c->category == LMH) cat_color = COLOR_RED;
+            else if (c->category == LMP2) cat_color = COLOR_BLUE;
+            else cat_color = COLOR_YELLOW;
+        }
+
+        // 2. Gap
+        char gap_str[20];
+        if (is_retired) {
+            sprintf(gap_str, "---");
+        } else if (i == 0) {
+            sprintf(gap_str, "LEADER");
+        } else {
+            int lap_diff = leader->laps_completed - c->laps_completed;
+            if (lap_diff > 0) sprintf(gap_str, "+%d Laps", lap_diff);
+            else sprintf(gap_str, "+%.1f s", c->gap);
+        }
+
+        // Interval to the car ahead
+        char int_str[20];
+        if (is_retired || i == 0) {
+            sprintf(int_str, "---");
+        } else {
+            int lap_diff = race->cars[i - 1].laps_completed - c->laps_completed;
+            if (lap_diff > 0) sprintf(int_str, "+%d Laps", lap_diff);
+            else sprintf(int_str, "+%.1f s", c->interval);
+        }
+
+        // 3. State
+        const char* state_str = "RUN";
+        ScreenColor state_color = COLOR_GREEN;
+        
+        if (is_retired) {
+            state_str = "DNF";
+            state_color = COLOR_RED; 
+        } else if (c->state == PIT_STOP) {
+            state_str = "IN PIT";
+            state_color = COLOR_MAGENTA; 
+        } else if (c->state == CRASHED) {
+            state_str = "CRASH";
+            state_color = COLOR_RED;
+        }
+
+        // 4. Tire
+        const char* tire_str = "---";
+        ScreenColor tire_color = COLOR_GRAY;
+        
+        if (!is_retired) {
+            switch(c->current_tires) {
+                case TIRE_SOFT:   tire_str = "(S)oft";   tire_color = COLOR_RED; break;
+                case TIRE_MEDIUM: tire_str = "(M)edium"; tire_color = COLOR_YELLOW; break;
+                case TIRE_HARD:   tire_str = "(H)ard";   tire_color = COLOR_WHITE; break;
+                case TIRE_WET:    tire_str = "(W)et";    tire_color = COLOR_BLUE; break;
+            }
+        }
+
+        // Draw Row (%-25.25s pads to 25 and truncates longer team names)
+        col = screen_printf(screen, row, 0, base_color, "%-4d", i + 1);
+        col = screen_printf(screen, row, col, base_color, " | %-25.25s | ", race->info[c->id - 1].team_name);
+        col = screen_printf(screen, row, col, cat_color, "%-10s", cat_str);
+        col = screen_printf(screen, row, col, base_color, " | %-8d | %-12s | %-10.10s | ", c->laps_completed, gap_str, int_str);
+        col = screen_printf(screen, row, col, state_color, "%-10s", state_str);
+        col = screen_put(screen, row, col, COLOR_DEFAULT, " | ");
+        col = screen_printf(screen, row, col, tire_color, "%-10s", tire_str);
+        screen_printf(screen, row, col, base_color, " | %.0f%%", c->reliability);
+    }
+
+    screen_present(screen);
+}
+
+// Plain-text final result (no ANSI codes, safe to pipe into files)
+void print_classification(const RaceSnapshot* race) {
+    int hours = (int)race->elapsed_time / 3600;
+    int minutes = ((int)race->elapsed_time % 3600) / 60;
+
+    printf("=== FINAL CLASSIFICATION (%02dh %02dm) ===\n", hours, minutes);
+    printf("%-4s | %-4s | %-25s | %-20s | %-6s | %-5s | %-6s | %-12s | %-8s\n",
+           "Pos", "No", "Team", "Driver", "Cat", "Class", "Laps", "Gap", "Best");
+    printf("---------------------------------------------------------------------------------------------------------------\n");
+
+    if (race->num_cars == 0) return;
+    const SnapshotCar* leader = &race->cars[0];
+
+    for (int i = 0; i < race->num_cars; i++) {
+        const SnapshotCar* c = &race->cars[i];
+
+        char class_str[16];
+        sprintf(class_str, "P%d", c->class_position + 1);
+        char best_str[16];
+        format_lap(best_str, sizeof(best_str), c->best_lap);
+
+        char gap_str[20];
+        if (c->state == RETIRED) {
+            sprintf(gap_str, "DNF");
+        } else if (i == 0) {
+            sprintf(gap_str, "WINNER");
+        } else {
+            int lap_diff = leader->laps_completed - c->laps_completed;
+            if (lap_diff > 0) sprintf(gap_str, "+%d Laps", lap_diff);
+            else sprintf(gap_str, "+%.1f s", c->gap);
+        }
+
+        printf("%-4d | %-4d | %-25.25s | %-20.20s | %-6s | %-5s | %-6d | %-12s | %-8s\n",
+               i + 1, c->id, race->info[c->id - 1].team_name, race->info[c->id - 1].driver_name,
+               category_name(c->category), class_str, c->laps_completed, gap_str, best_str);
+    }
+}
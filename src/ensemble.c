@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ensemble.h"
+#include "pool.h"
+#include "race.h"
+#include "telemetry.h"
+
+typedef struct {
+    const EnsembleConfig* config;
+    EnsembleStats* partials;    // One accumulator per worker, merged at the end
+    Analysis* analyses;         // One per worker when analysing, NULL otherwise
+} EnsembleJob;
+
+static void stats_alloc(EnsembleStats* stats, int num_entries) {
+    memset(stats, 0, sizeof(*stats));
+    stats->num_entries = num_entries;
+    stats->team_names = calloc(num_entries, sizeof(*stats->team_names));
+    stats->driver_names = calloc(num_entries, sizeof(*stats->driver_names));
+    stats->categories = calloc(num_entries, sizeof(CarCategory));
+    stats->wins = calloc(num_entries, sizeof(long));
+    stats->dnfs = calloc(num_entries, sizeof(long));
+    stats->laps_sum = calloc(num_entries, sizeof(long));
+    stats->position_sum = calloc(num_entries, sizeof(long));
+    if (!stats->team_names || !stats->driver_names || !stats->categories || !stats->wins ||
+        !stats->dnfs || !stats->laps_sum || !stats->position_sum) {
+        fprintf(stderr, "Error: Failed to allocate ensemble statistics.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void analysis_sink(void* ctx, const TelemetryRecord* records, int count) {
+    analysis_add((Analysis*)ctx, records, count);
+}
+
+static void run_one_race(void* ctx, int task, int worker) {
+    EnsembleJob* job = (EnsembleJob*)ctx;
+    EnsembleStats* acc = &job->partials[worker];
+
+    RaceContext race;
+    race_init_seeded(&race, job->config->entries, job->config->base_seed + (uint64_t)task);
+    race_set_engine(&race, job->config->engine);
+    race.traffic = job->config->traffic;
+    if (job->config->num_scenarios > 0) {
+        race_set_weather(&race, &job->config->scenarios[task % job->config->num_scenarios]);
+    }
+
+    // The race's sectors go straight to this worker's analysis, never to a file
+    Analysis* an = job->analyses ? &job->analyses[worker] : NULL;
+    TelemetryRecorder recorder;
+    if (an) {
+        analysis_begin_race(an, race.num_cars, race.standings.category);
+        telemetry_recorder_open_sink(&recorder, &race, analysis_sink, an);
+        race.recorder = &recorder;
+    }
+    race_run_until(&race, TOTAL_RACE_TIME);
+    if (an) {
+        telemetry_recorder_close(&recorder);
+        race.recorder = NULL;
+        analysis_end_race(an);
+    }
+
+    // The position index is the finishing order
+    bool winner_found = false;
+    for (int pos = 0; pos < race.num_cars; pos++) {
+        Car* c = race_car_at(&race, pos);
+        int e = c->id - 1;
+        if (e < 0 || e >= acc->num_entries) continue;
+
+        acc->laps_sum[e] += c->laps_completed;
+        acc->position_sum[e] += pos + 1;
+        acc->category_starts[c->category]++;
+
+        if (c->state == RETIRED) {
+            acc->dnfs[e]++;
+            acc->category_dnfs[c->category]++;
+        } else if (!winner_found) {
+            acc->wins[e]++;
+            winner_found = true;
+        }
+    }
+    acc->num_races++;
+
+    race_cleanup(&race);
+}
+
+void ensemble_run(const EnsembleConfig* config, EnsembleStats* stats) {
+    const EntryList* entries = config->entries;
+    int num_entries = entries->num_entries;
+
+    stats_alloc(stats, num_entries);
+    for (int e = 0; e < num_entries; e++) {
+        stats->team_names[e] = entry_team(entries, e);
+        stats->driver_names[e] = entry_driver(entries, e);
+        stats->categories[e] = entries->entries[e].category;
+    }
+
+    int num_threads = config->num_threads > 0 ? config->num_threads : pool_default_threads();
+    EnsembleStats* partials = malloc(num_threads * sizeof(EnsembleStats));
+    if (!partials) {
+        fprintf(stderr, "Error: Failed to allocate ensemble statistics.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int w = 0; w < num_threads; w++) {
+        stats_alloc(&partials[w], num_entries);
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    // Each worker analyses its own races single-threaded; the workers already fill the cores
+    Analysis* analyses = NULL;
+    if (config->analysis) {
+        analyses = malloc(num_threads * sizeof(Analysis));
+        if (!analyses) {
+            fprintf(stderr, "Error: Failed to allocate ensemble statistics.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int w = 0; w < num_threads; w++) analysis_init(&analyses[w], 1);
+    }
+
+    EnsembleJob job = { config, partials, analyses };
+    pool_run(num_threads, config->num_races, run_one_race, &job);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    stats->wall_seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    // --- Merge per-worker accumulators ---
+    for (int w = 0; w < num_threads; w++) {
+        EnsembleStats* p = &partials[w];
+        stats->num_races += p->num_races;
+        for (int e = 0; e < num_entries; e++) {
+            stats->wins[e] += p->wins[e];
+            stats->dnfs[e] += p->dnfs[e];
+            stats->laps_sum[e] += p->laps_sum[e];
+            stats->position_sum[e] += p->position_sum[e];
+        }
+        for (int c = 0; c < 3; c++) {
+            stats->category_starts[c] += p->category_starts[c];
+            stats->category_dnfs[c] += p->category_dnfs[c];
+        }
+        ensemble_free(p);
+        if (analyses) {
+            analysis_merge(config->analysis, &analyses[w]);
+            analysis_free(&analyses[w]);
+        }
+    }
+    free(partials);
+    free(analyses);
+}
+
+void ensemble_print(const EnsembleStats* stats) {
+    static const char* CATEGORY_NAMES[3] = { "HYPER", "LMP2", "LMGT3" };
+    double n = stats->num_races > 0 ? (double)stats->num_races : 1.0;
+
+    printf("=== MONTE CARLO ENSEMBLE: %ld RACES ===\n", stats->num_races);
+    printf("%-4s | %-25s | %-20s | %-6s | %-7s | %-7s | %-8s | %-7s\n",
+           "No", "Team", "Driver", "Cat", "Win%", "DNF%", "AvgLaps", "AvgPos");
+    printf("-------------------------------------------------------------------------------------------------------\n");
+    for (int e = 0; e < stats->num_entries; e++) {
+        printf("%-4d | %-25.25s | %-20.20s | %-6s | %6.2f%% | %6.2f%% | %8.1f | %7.2f\n",
+               e + 1, stats->team_names[e], stats->driver_names[e], CATEGORY_NAMES[stats->categories[e]],
+               100.0 * stats->wins[e] / n, 100.0 * stats->dnfs[e] / n,
+               stats->laps_sum[e] / n, stats->position_sum[e] / n);
+    }
+
+    printf("\nDNF rate by category:\n");
+    for (int c = 0; c < 3; c++) {
+        if (stats->category_starts[c] == 0) continue;
+        printf("  %-6s %6.2f%%\n", CATEGORY_NAMES[c], 100.0 * stats->category_dnfs[c] / stats->category_starts[c]);
+    }
+
+    printf("\n%ld races in %.3f s (%.1f races/s)\n", stats->num_races, stats->wall_seconds,
+           stats->wall_seconds > 0.0 ? stats->num_races / stats->wall_seconds : 0.0);
+}
+
+void ensemble_free(EnsembleStats* stats) {
+    free(stats->team_names);
+    free(stats->driver_names);
+    free(stats->categories);
+    free(stats->wins);
+    free(stats->dnfs);
+    free(stats->laps_sum);
+    free(stats->position_sum);
+    memset(stats, 0, sizeof(*stats));
+}
@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "event.h"
+
+static inline bool event_before(const RaceEvent* a, const RaceEvent* b) {
+    if (a->time != b->time) return a->time < b->time;
+    return a->seq < b->seq;
+}
+
+void event_queue_init(EventQueue* queue, int capacity) {
+    if (capacity < 1) capacity = 1;
+    queue->heap = (RaceEvent*)malloc(capacity * sizeof(RaceEvent));
+    if (!queue->heap) {
+        fprintf(stderr, "Error: Failed to allocate event queue.\n");
+        exit(EXIT_FAILURE);
+    }
+    queue->size = 0;
+    queue->capacity = capacity;
+    queue->next_seq = 0;
+}
+
+void event_queue_free(EventQueue* queue) {
+    free(queue->heap);
+    memset(queue, 0, sizeof(*queue));
+}
+
+void event_queue_copy(EventQueue* dst, const EventQueue* src) {
+    if (dst->capacity < src->size) {
+        int capacity = src->capacity > 0 ? src->capacity : 1;
+        RaceEvent* heap = (RaceEvent*)realloc(dst->heap, capacity * sizeof(RaceEvent));
+        if (!heap) {
+            fprintf(stderr, "Error: Failed to allocate event queue.\n");
+            exit(EXIT_FAILURE);
+        }
+        dst->heap = heap;
+        dst->capacity = capacity;
+    }
+    memcpy(dst->heap, src->heap, src->size * sizeof(RaceEvent));
+    dst->size = src->size;
+    dst->next_seq = src->next_seq;
+}
+
+void event_push(EventQueue* queue, double time, EventType type, int car) {
+    if (queue->size == queue->capacity) {
+        int new_cap = queue->capacity * 2;
+        RaceEvent* grown = (RaceEvent*)realloc(queue->heap, new_cap * sizeof(RaceEvent));
+        if (!grown) {
+            fprintf(stderr, "Error: Failed to grow event queue.\n");
+            exit(EXIT_FAILURE);
+        }
+        queue->heap = grown;
+        queue->capacity = new_cap;
+    }
+
+    RaceEvent ev = { time, queue->next_seq++, car, type };
+
+    // Sift up
+    int i = queue->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&ev, &queue->heap[parent])) break;
+        queue->heap[i] = queue->heap[parent];
+        i = parent;
+    }
+    queue->heap[i] = ev;
+}
+
+// Places 'ev' at the root and sifts it down into position
+static void sift_down_from_root(EventQueue* queue, RaceEvent ev) {
+    int n = queue->size;
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && event_before(&queue->heap[child + 1], &queue->heap[child])) child++;
+        if (!event_before(&queue->heap[child], &ev)) break;
+        queue->heap[i] = queue->heap[child];
+        i = child;
+    }
+    queue->heap[i] = ev;
+}
+
+bool event_pop(EventQueue* queue, RaceEvent* out) {
+    if (queue->size == 0) return false;
+    *out = queue->heap[0];
+
+    RaceEvent last = queue->heap[--queue->size];
+    if (queue->size > 0) sift_down_from_root(queue, last);
+    return true;
+}
+
+void event_replace_top(EventQueue* queue, double time, EventType type, int car) {
+    RaceEvent ev = { time, queue->next_seq++, car, type };
+    sift_down_from_root(queue, ev);
+}
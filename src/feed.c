@@ -0,0 +1,449 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "feed.h"
+
+#define FEED_POLL_MS 5              // Longest the feed thread sleeps between snapshot checks
+#define FEED_CLIENT_FRAMES 4        // Client buffer size, in largest-possible frames
+#define FEED_DRAIN_SECONDS 5.0      // How long the last frames may take to reach slow clients
+#define FEED_JSON_HEADER_MAX 256
+#define FEED_JSON_CAR_MAX 480
+
+static const char* const STATE_NAMES[] = { "racing", "pit", "crashed", "retired" };
+static const char* const TIRE_NAMES[] = { "soft", "medium", "hard", "wet" };
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// --- FRAME SERIALIZATION ---
+// Into the feed's preallocated buffers: frame_capacity is sized for every car, so a
+// frame never has to grow.
+
+typedef struct {
+    char* buf;
+    size_t size;
+    size_t capacity;
+    uint32_t num_cars;
+} FrameWriter;
+
+static void put(FrameWriter* w, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(w->buf + w->size, w->capacity - w->size, fmt, args);
+    va_end(args);
+    if (len > 0 && (size_t)len < w->capacity - w->size) w->size += len;
+}
+
+static void put_bytes(FrameWriter* w, const void* data, size_t size) {
+    if (size > w->capacity - w->size) return;
+    memcpy(w->buf + w->size, data, size);
+    w->size += size;
+}
+
+static void begin_frame(FrameWriter* w, FeedFormat format, const RaceSnapshot* snap, int type) {
+    w->size = 0;
+    w->num_cars = 0;
+    if (format == FEED_BINARY) {
+        FeedFrameHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = FEED_MAGIC;
+        header.sequence = snap->sequence;
+        header.clock = snap->elapsed_time;
+        header.type = (uint8_t)type;
+        header.flags = (snap->safety_car_active ? FEED_SAFETY_CAR : 0) |
+                       (snap->conditions.wet ? FEED_RAIN : 0) |
+                       (snap->finished ? FEED_FINISHED : 0);
+        header.caution = (uint8_t)snap->caution_mask;
+        put_bytes(w, &header, sizeof(header));
+        return;
+    }
+    put(w, "{\"type\":\"%s\",\"seq\":%llu,\"clock\":%.1f,\"weather\":\"%s\",\"safety_car\":%s,\"caution\":%u,\"finished\":%s,\"cars\":[",
+        type == FEED_FRAME_FULL ? "full" : "delta", (unsigned long long)snap->sequence, snap->elapsed_time,
+        snap->conditions.wet ? "rain" : "sunny", snap->safety_car_active ? "true" : "false",
+        snap->caution_mask, snap->finished ? "true" : "false");
+}
+
+static void add_car(FrameWriter* w, FeedFormat format, const SnapshotCar* c, int pos, uint8_t events) {
+    if (format == FEED_BINARY) {
+        FeedCarRecord r;
+        memset(&r, 0, sizeof(r));
+        r.race_time = c->total_race_time;
+        r.sector_time = (float)c->sector_time;
+        r.lap_time = (float)c->last_lap_time;
+        r.best_lap = (float)c->best_lap;
+        r.gap = (float)c->gap;
+        r.interval = (float)c->interval;
+        r.class_gap = (float)c->class_gap;
+        r.car = (uint16_t)(c->id - 1);
+        r.position = (uint16_t)pos;
+        r.class_position = (uint16_t)c->class_position;
+        r.laps_completed = (uint16_t)c->laps_completed;
+        r.current_sector = (uint8_t)c->current_sector;
+        r.state = (uint8_t)c->state;
+        r.tires = (uint8_t)c->current_tires;
+        r.events = events;
+        put_bytes(w, &r, sizeof(r));
+        w->num_cars++;
+        return;
+    }
+    put(w, "%s{\"id\":%d,\"pos\":%d,\"class_pos\":%d,\"lap\":%d,\"sector\":%d,\"state\":\"%s\",\"tires\":\"%s\","
+           "\"race_time\":%.3f,\"sector_time\":%.3f,\"lap_time\":%.3f,\"best_lap\":%.3f,"
+           "\"gap\":%.3f,\"interval\":%.3f,\"class_gap\":%.3f,\"events\":[",
+        w->num_cars > 0 ? "," : "", c->id, pos + 1, c->class_position + 1, c->laps_completed, c->current_sector,
+        STATE_NAMES[c->state], TIRE_NAMES[c->current_tires], c->total_race_time, c->sector_time,
+        c->last_lap_time, c->best_lap, c->gap, c->interval, c->class_gap);
+    static const struct { uint8_t flag; const char* name; } EVENTS[] = {
+        { FEED_EV_POSITION, "position" }, { FEED_EV_SECTOR, "sector" }, { FEED_EV_LAP, "lap" },
+        { FEED_EV_PIT, "pit" }, { FEED_EV_DNF, "dnf" }, { FEED_EV_FASTEST, "fastest" }
+    };
+    bool first = true;
+    for (size_t e = 0; e < sizeof(EVENTS) / sizeof(EVENTS[0]); e++) {
+        if (!(events & EVENTS[e].flag)) continue;
+        put(w, "%s\"%s\"", first ? "" : ",", EVENTS[e].name);
+        first = false;
+    }
+    put(w, "]}");
+    w->num_cars++;
+}
+
+static void end_frame(FrameWriter* w, FeedFormat format) {
+    if (format == FEED_BINARY) {
+        FeedFrameHeader* header = (FeedFrameHeader*)w->buf;
+        header->size = (uint32_t)w->size;
+        header->num_cars = w->num_cars;
+        return;
+    }
+    put(w, "]}\n");
+}
+
+// What changed for one car since the previous frame
+static uint8_t car_events(const FeedServer* feed, const RaceSnapshot* snap, const SnapshotCar* c, int pos) {
+    const FeedCarState* last = &feed->last[c->id - 1];
+    uint8_t events = 0;
+    bool moved_on = c->laps_completed != last->laps_completed || c->current_sector != last->current_sector;
+    if (pos != last->position) events |= FEED_EV_POSITION;
+    if (moved_on) events |= FEED_EV_SECTOR;
+    if (c->laps_completed != last->laps_completed) events |= FEED_EV_LAP;
+    if ((c->state == PIT_STOP && (last->state != PIT_STOP || moved_on)) || c->current_tires != last->tires) {
+        events |= FEED_EV_PIT;
+    }
+    if (c->state == RETIRED && last->state != RETIRED) events |= FEED_EV_DNF;
+    // New holder, or the holder went faster still
+    if (snap->fastest[c->category] == c->id &&
+        (feed->last_fastest[c->category] != c->id || c->best_lap != last->best_lap)) {
+        events |= FEED_EV_FASTEST;
+    }
+    return events;
+}
+
+static void build_delta(FeedServer* feed, const RaceSnapshot* snap) {
+    FrameWriter w = { feed->frame, 0, feed->frame_capacity, 0 };
+    begin_frame(&w, feed->format, snap, FEED_FRAME_DELTA);
+    for (int pos = 0; pos < snap->num_cars; pos++) {
+        const SnapshotCar* c = &snap->cars[pos];
+        FeedCarState* last = &feed->last[c->id - 1];
+        uint8_t events = feed->have_last ? car_events(feed, snap, c, pos) : 0;
+        if (!feed->have_last || events || c->state != last->state) add_car(&w, feed->format, c, pos, events);
+
+        last->position = pos;
+        last->laps_completed = c->laps_completed;
+        last->current_sector = c->current_sector;
+        last->state = c->state;
+        last->tires = c->current_tires;
+        last->best_lap = c->best_lap;
+    }
+    memcpy(feed->last_fastest, snap->fastest, sizeof(feed->last_fastest));
+    end_frame(&w, feed->format);
+    feed->have_last = true;
+    feed->frame_size = w.size;
+    feed->frames++;
+}
+
+static void build_full(FeedServer* feed, const RaceSnapshot* snap) {
+    FrameWriter w = { feed->full, 0, feed->frame_capacity, 0 };
+    begin_frame(&w, feed->format, snap, FEED_FRAME_FULL);
+    for (int pos = 0; pos < snap->num_cars; pos++) add_car(&w, feed->format, &snap->cars[pos], pos, 0);
+    end_frame(&w, feed->format);
+    feed->full_size = w.size;
+}
+
+// --- CLIENTS ---
+
+// Appends a whole frame or nothing
+static bool client_append(FeedClient* c, const char* data, size_t size) {
+    if (c->sent == c->used) c->sent = c->used = 0;
+    if (c->capacity - c->used < size && c->sent > 0) {
+        memmove(c->buffer, c->buffer + c->sent, c->used - c->sent);
+        c->used -= c->sent;
+        c->sent = 0;
+    }
+    if (c->capacity - c->used < size) return false;
+    memcpy(c->buffer + c->used, data, size);
+    c->used += size;
+    return true;
+}
+
+static void drop_client(FeedServer* feed, int k) {
+    int n = atomic_load(&feed->num_clients);
+    close(feed->clients[k].fd);
+    free(feed->clients[k].buffer);
+    feed->clients[k] = feed->clients[n - 1];
+    atomic_store(&feed->num_clients, n - 1);
+}
+
+static void accept_clients(FeedServer* feed) {
+    while (1) {
+        int fd = accept(feed->listen_fd, NULL, NULL);
+        if (fd < 0) return;     // EAGAIN: nobody else waiting
+        int n = atomic_load(&feed->num_clients);
+        if (n == FEED_MAX_CLIENTS || !set_nonblocking(fd)) {
+            close(fd);
+            continue;
+        }
+        FeedClient* c = &feed->clients[n];
+        c->fd = fd;
+        c->capacity = FEED_CLIENT_FRAMES * feed->frame_capacity;
+        c->buffer = (char*)malloc(c->capacity);
+        if (!c->buffer) {
+            close(fd);
+            continue;
+        }
+        c->sent = c->used = 0;
+        c->needs_full = true;
+        atomic_store(&feed->num_clients, n + 1);
+    }
+}
+
+// Sends what each socket takes without blocking; drops clients that hung up
+static void flush_clients(FeedServer* feed) {
+    for (int k = atomic_load(&feed->num_clients) - 1; k >= 0; k--) {
+        FeedClient* c = &feed->clients[k];
+        // Subscribers have nothing to say: anything they send is read and ignored
+        char discard[256];
+        ssize_t got = recv(c->fd, discard, sizeof(discard), MSG_DONTWAIT);
+        if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            drop_client(feed, k);
+            continue;
+        }
+        if (c->sent == c->used) continue;
+        ssize_t sent = send(c->fd, c->buffer + c->sent, c->used - c->sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent > 0) {
+            c->sent += sent;
+        } else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            drop_client(feed, k);
+        }
+    }
+}
+
+// New frame: every client that is keeping up gets it, the others are marked for a full frame
+static void enqueue_delta(FeedServer* feed) {
+    int n = atomic_load(&feed->num_clients);
+    for (int k = 0; k < n; k++) {
+        FeedClient* c = &feed->clients[k];
+        if (!c->needs_full && !client_append(c, feed->frame, feed->frame_size)) {
+            c->needs_full = true;
+            feed->coalesced++;
+        }
+    }
+}
+
+// Full frames of 'snap' for the clients waiting for one, as soon as they have room
+static void enqueue_full(FeedServer* feed, const RaceSnapshot* snap, uint64_t* full_sequence) {
+    int n = atomic_load(&feed->num_clients);
+    for (int k = 0; k < n; k++) {
+        FeedClient* c = &feed->clients[k];
+        if (!c->needs_full) continue;
+        if (*full_sequence != snap->sequence) {
+            build_full(feed, snap);
+            *full_sequence = snap->sequence;
+        }
+        if (client_append(c, feed->full, feed->full_size)) c->needs_full = false;
+    }
+}
+
+static bool clients_drained(const FeedServer* feed) {
+    int n = atomic_load(&feed->num_clients);
+    for (int k = 0; k < n; k++) {
+        if (feed->clients[k].needs_full || feed->clients[k].sent != feed->clients[k].used) return false;
+    }
+    return true;
+}
+
+// --- FEED THREAD ---
+
+static void* feed_thread(void* arg) {
+    FeedServer* feed = (FeedServer*)arg;
+    struct pollfd fds[FEED_MAX_CLIENTS + 1];
+    const RaceSnapshot* current = NULL;    // Stays valid until the next successful acquire
+    uint64_t full_sequence = 0;
+    double drain_deadline = 0.0;
+
+    while (1) {
+        int n = atomic_load(&feed->num_clients);
+        fds[0].fd = feed->listen_fd;
+        fds[0].events = POLLIN;
+        for (int k = 0; k < n; k++) {
+            fds[k + 1].fd = feed->clients[k].fd;
+            fds[k + 1].events = POLLIN | (feed->clients[k].sent != feed->clients[k].used ? POLLOUT : 0);
+        }
+        poll(fds, n + 1, FEED_POLL_MS);
+
+        accept_clients(feed);
+        const RaceSnapshot* snap = snapshot_acquire(&feed->snapshots);
+        if (snap) {
+            current = snap;
+            build_delta(feed, snap);
+            enqueue_delta(feed);
+            if (snap->finished) drain_deadline = monotonic_seconds() + FEED_DRAIN_SECONDS;
+        }
+        if (current) enqueue_full(feed, current, &full_sequence);
+        flush_clients(feed);
+
+        if (current && current->finished) {
+            if (clients_drained(feed) || monotonic_seconds() > drain_deadline) break;
+        } else if (atomic_load(&feed->quit) && !snapshot_consumer_behind(&feed->snapshots)) {
+            // Closed without a final frame. A snapshot published just before the close
+            // is still in the shared slot: it goes out on the next pass.
+            break;
+        }
+    }
+
+    for (int k = atomic_load(&feed->num_clients) - 1; k >= 0; k--) drop_client(feed, k);
+    return NULL;
+}
+
+// --- SETUP ---
+
+static int open_listener(FeedServer* feed, const char* address) {
+    const char* path = address;
+    if (strncmp(address, "tcp:", 4) == 0) {
+        int port = atoi(address + 4);
+        if (port <= 0 || port > 65535) {
+            fprintf(stderr, "Error: Invalid feed port in '%s'.\n", address);
+            return -1;
+        }
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    if (strncmp(address, "unix:", 5) == 0) path = address + 5;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path[0] == '\0' || strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: Invalid feed socket path '%s'.\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    // A socket left behind by an earlier run is replaced; any other file is not touched
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    snprintf(feed->unix_path, sizeof(feed->unix_path), "%s", path);
+    return fd;
+}
+
+bool feed_open(FeedServer* feed, const char* address, FeedFormat format, int num_cars) {
+    memset(feed, 0, sizeof(*feed));
+    if (format == FEED_BINARY && num_cars > FEED_BINARY_MAX_CARS) {
+        fprintf(stderr, "Error: The binary timing feed carries at most %d cars, the field has %d; use --feed-format json.\n",
+                FEED_BINARY_MAX_CARS, num_cars);
+        return false;
+    }
+    feed->format = format;
+    feed->num_cars = num_cars;
+
+    feed->listen_fd = open_listener(feed, address);
+    if (feed->listen_fd < 0 || listen(feed->listen_fd, 16) != 0 || !set_nonblocking(feed->listen_fd)) {
+        fprintf(stderr, "Error: Cannot open the timing feed on '%s': %s.\n", address, strerror(errno));
+        if (feed->listen_fd >= 0) close(feed->listen_fd);
+        return false;
+    }
+
+    if (format == FEED_BINARY) {
+        feed->frame_capacity = sizeof(FeedFrameHeader) + (size_t)num_cars * sizeof(FeedCarRecord);
+    } else {
+        feed->frame_capacity = FEED_JSON_HEADER_MAX + (size_t)num_cars * FEED_JSON_CAR_MAX;
+    }
+    feed->frame = (char*)malloc(feed->frame_capacity);
+    feed->full = (char*)malloc(feed->frame_capacity);
+    feed->last = (FeedCarState*)calloc(num_cars > 0 ? num_cars : 1, sizeof(FeedCarState));
+    if (!feed->frame || !feed->full || !feed->last) {
+        fprintf(stderr, "Error: Failed to allocate timing feed buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+    snapshot_buffer_init(&feed->snapshots, num_cars);
+    atomic_init(&feed->quit, false);
+    atomic_init(&feed->num_clients, 0);
+
+    if (pthread_create(&feed->thread, NULL, feed_thread, feed) != 0) {
+        fprintf(stderr, "Error: Failed to start timing feed thread.\n");
+        exit(EXIT_FAILURE);
+    }
+    return true;
+}
+
+void feed_wait_clients(FeedServer* feed, int count) {
+    struct timespec pause = { 0, 10 * 1000000L };
+    while (atomic_load(&feed->num_clients) < count) nanosleep(&pause, NULL);
+}
+
+void feed_publish(FeedServer* feed, RaceContext* race, bool finished) {
+    // Nobody listening: nothing to capture. A client that connects later starts from a
+    // full frame of the last snapshot taken, so the diffs stay consistent for it.
+    if (!finished && atomic_load_explicit(&feed->num_clients, memory_order_relaxed) == 0) return;
+    if (!finished && snapshot_consumer_behind(&feed->snapshots)) return;
+    snapshot_publish(&feed->snapshots, race, finished);
+}
+
+void feed_close(FeedServer* feed) {
+    atomic_store(&feed->quit, true);
+    pthread_join(feed->thread, NULL);
+
+    close(feed->listen_fd);
+    if (feed->unix_path[0]) unlink(feed->unix_path);
+    snapshot_buffer_free(&feed->snapshots);
+    free(feed->frame);
+    free(feed->full);
+    free(feed->last);
+    feed->frame = feed->full = NULL;
+    feed->last = NULL;
+}
@@ -0,0 +1,149 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "instrument.h"
+
+#ifdef LEMANS_INSTRUMENT
+
+static const char* const PHASE_NAMES[INSTR_PHASES] = {
+    "step", "flags", "traffic", "cars", "chunk", "events", "telemetry", "sort", "standings", "snapshot", "render"
+};
+static const char* const COUNTER_NAMES[INSTR_COUNTERS] = {
+    "pit stops", "retirements", "catastrophic failures", "cautions raised", "green runs"
+};
+
+_Thread_local InstrThread* instr_self = NULL;
+
+// Every thread that ever recorded anything, newest first. Only ever pushed to.
+static _Atomic(InstrThread*) all_threads = NULL;
+static atomic_int next_thread_id = 0;
+
+uint64_t instr_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+InstrThread* instr_register_thread(void) {
+    InstrThread* self = (InstrThread*)calloc(1, sizeof(InstrThread));
+    if (!self) {
+        fprintf(stderr, "Error: Failed to allocate instrumentation counters.\n");
+        exit(EXIT_FAILURE);
+    }
+    self->trace = (InstrTraceEvent*)malloc(INSTR_TRACE_EVENTS * sizeof(InstrTraceEvent));
+    if (!self->trace) {
+        fprintf(stderr, "Error: Failed to allocate instrumentation trace.\n");
+        exit(EXIT_FAILURE);
+    }
+    self->id = atomic_fetch_add(&next_thread_id, 1);
+
+    InstrThread* head = atomic_load(&all_threads);
+    do {
+        self->next = head;
+    } while (!atomic_compare_exchange_weak(&all_threads, &head, self));
+    instr_self = self;
+    return self;
+}
+
+void instr_record(InstrPhase phase, uint64_t start_ns) {
+    uint64_t end = instr_now();
+    InstrThread* self = instr_thread();
+    self->phase_calls[phase]++;
+    self->phase_ns[phase] += end - start_ns;
+    if (self->trace_count < INSTR_TRACE_EVENTS) {
+        InstrTraceEvent* ev = &self->trace[self->trace_count++];
+        ev->start_ns = start_ns;
+        ev->duration_ns = end - start_ns;
+        ev->phase = phase;
+    } else {
+        self->trace_dropped++;
+    }
+}
+
+bool instr_available(void) {
+    return true;
+}
+
+void instr_print_summary(void) {
+    uint64_t calls[INSTR_PHASES] = {0};
+    uint64_t ns[INSTR_PHASES] = {0};
+    uint64_t counters[INSTR_COUNTERS] = {0};
+    uint64_t dropped = 0;
+    int threads = 0;
+    for (InstrThread* t = atomic_load(&all_threads); t; t = t->next) {
+        for (int p = 0; p < INSTR_PHASES; p++) {
+            calls[p] += t->phase_calls[p];
+            ns[p] += t->phase_ns[p];
+        }
+        for (int c = 0; c < INSTR_COUNTERS; c++) counters[c] += t->counters[c];
+        dropped += t->trace_dropped;
+        threads++;
+    }
+
+    printf("\n=== INSTRUMENTATION (%d threads) ===\n", threads);
+    printf("%-10s %10s %12s %10s %8s\n", "Phase", "Calls", "Total ms", "Mean us", "% step");
+    for (int p = 0; p < INSTR_PHASES; p++) {
+        if (calls[p] == 0) continue;
+        printf("%-10s %10llu %12.3f %10.3f", PHASE_NAMES[p], (unsigned long long)calls[p],
+               ns[p] / 1e6, ns[p] / 1e3 / calls[p]);
+        // Chunks run in parallel and the display outside the step: no share for them
+        if (ns[PHASE_STEP] > 0 && p != PHASE_CHUNK && p != PHASE_SNAPSHOT && p != PHASE_RENDER) {
+            printf(" %7.1f%%", 100.0 * ns[p] / ns[PHASE_STEP]);
+        }
+        printf("\n");
+    }
+    for (int c = 0; c < INSTR_COUNTERS; c++) {
+        printf("%-22s %10llu\n", COUNTER_NAMES[c], (unsigned long long)counters[c]);
+    }
+    if (dropped > 0) printf("Trace events past the per-thread limit (summed only): %llu\n", (unsigned long long)dropped);
+}
+
+bool instr_write_trace(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot write trace '%s'.\n", path);
+        return false;
+    }
+
+    // Timestamps relative to the earliest event, in microseconds
+    uint64_t origin = UINT64_MAX;
+    for (InstrThread* t = atomic_load(&all_threads); t; t = t->next) {
+        for (int i = 0; i < t->trace_count; i++) {
+            if (t->trace[i].start_ns < origin) origin = t->trace[i].start_ns;
+        }
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (InstrThread* t = atomic_load(&all_threads); t; t = t->next) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                first ? "" : ",\n", t->id, t->id);
+        first = false;
+        for (int i = 0; i < t->trace_count; i++) {
+            const InstrTraceEvent* ev = &t->trace[i];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"sim\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    PHASE_NAMES[ev->phase], t->id, (ev->start_ns - origin) / 1e3, ev->duration_ns / 1e3);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = (fclose(file) == 0);
+    if (!ok) fprintf(stderr, "Error: Failed to write trace '%s'.\n", path);
+    return ok;
+}
+
+#else
+
+bool instr_available(void) {
+    return false;
+}
+
+void instr_print_summary(void) {
+}
+
+bool instr_write_trace(const char* path) {
+    (void)path;
+    return false;
+}
+
+#endif
@@ -0,0 +1,507 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lockstep.h"
+#include "pool.h"
+
+// Field sizes: the entry list as given, then sizes that leave a partial SIMD batch and a
+// partial tick chunk, the last spread over several chunks so the threaded variants really
+// split it. Bigger fields cost more per race and run one seed in FIELD_SHARE.
+static const int FIELD_CARS[LOCKSTEP_FIELDS] = { 0, 301, 557 };     // 0 = the entry list
+static const int FIELD_SHARE[LOCKSTEP_FIELDS] = { 1, 8, 32 };
+
+static const char* const VARIANT_NAMES[LOCKSTEP_VARIANTS] = {
+    "threads", "simd", "simd+threads", "switch", "fork", "car_update"
+};
+
+static const RaceEngine STAT_ENGINES[LOCKSTEP_STAT_ENGINES] = { ENGINE_EVENT, ENGINE_ADAPTIVE };
+static const char* const STAT_NAMES[LOCKSTEP_STATS] = {
+    "HYPER finisher laps", "LMP2 finisher laps", "LMGT3 finisher laps", "Retirements"
+};
+
+// The event engine on the built-in entry list, with the options of apply_options(): means
+// and standard errors over seeds 1000001 .. 1004000 (lemans_sim --lockstep 200 --seed 1000001).
+// To be measured again whenever the physics change on purpose.
+static const double EVENT_EXPECTED[LOCKSTEP_STATS] = { 614.10, 578.26, 526.92, 6.42 };
+static const double EVENT_EXPECTED_ERROR[LOCKSTEP_STATS] = { 0.13, 0.11, 0.09, 0.04 };
+
+#define REFERENCE -1    // Variant index of the scalar, single-threaded run
+
+// One race of the matrix: the reference and every variant of one field and seed
+typedef struct {
+    int field;
+    uint64_t seed;
+    bool skipped;           // Not run: an earlier case had drifted (fail_fast)
+    uint64_t final_hash;    // Reference state at the flag
+    LockstepDivergence divergence[LOCKSTEP_VARIANTS];
+} LockstepCase;
+
+typedef struct {
+    const LockstepConfig* config;
+    const EntryList* fields;    // One list per field size
+    LockstepCase* cases;
+    atomic_bool drifted;    // Some variant of some case has
+} LockstepJob;
+
+// --- STATE HASH ---
+
+static uint64_t mix(uint64_t h, uint64_t v) {
+    h ^= v;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+}
+
+static uint64_t mix_double(uint64_t h, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return mix(h, bits);
+}
+
+// Everything about car 'i' a later tick or a view could read
+static uint64_t car_hash(const RaceContext* race, int i) {
+    const Car* c = &race->cars[i];
+    uint64_t h = mix(0x243F6A8885A308D3ULL, (uint64_t)c->id);
+    h = mix(h, (uint64_t)c->category | (uint64_t)c->state << 8 | (uint64_t)c->current_tires << 16 |
+               (uint64_t)c->has_pitted_this_lap << 24);
+    h = mix(h, (uint64_t)(uint32_t)c->current_sector | (uint64_t)(uint32_t)c->laps_completed << 32);
+    h = mix_double(h, c->speed_kmh);
+    h = mix_double(h, c->fuel_level);
+    h = mix_double(h, c->tire_wear);
+    h = mix_double(h, c->reliability);
+    h = mix_double(h, c->current_lap_time);
+    h = mix_double(h, c->last_lap_time);
+    for (int s = 0; s < 3; s++) h = mix_double(h, c->sector_times[s]);
+    h = mix_double(h, c->total_race_time);
+    const Standings* st = &race->standings;
+    h = mix(h, (uint64_t)(uint32_t)st->position[i] | (uint64_t)(uint32_t)st->class_position[i] << 32);
+    return mix_double(h, st->best_lap[i]);
+}
+
+// Race-wide state: clock, flags, cautions, the random stream and the running order
+static uint64_t race_wide_hash(const RaceContext* race) {
+    uint64_t h = mix_double(0x13198A2E03707344ULL, race->elapsed_time);
+    h = mix(h, (uint64_t)race->safety_car_active | (uint64_t)(uint32_t)race->safety_car_timer << 8 |
+               (uint64_t)race->caution_mask << 40);
+    for (int s = 0; s < 3; s++) h = mix_double(h, race->caution_end[s]);
+    h = mix(h, race->rng.key);
+    h = mix(h, race->rng.counter);
+    for (int pos = 0; pos < race->num_cars; pos++) h = mix(h, (uint64_t)race->order[pos]);
+    for (int c = 0; c < CAR_CATEGORIES; c++) h = mix(h, (uint64_t)(uint32_t)race->standings.fastest[c]);
+    return h;
+}
+
+static uint64_t state_hash(const RaceContext* race) {
+    uint64_t h = race_wide_hash(race);
+    for (int i = 0; i < race->num_cars; i++) h = mix(h, car_hash(race, i));
+    return h;
+}
+
+// --- THE RACES ---
+
+// Fixed stints in the dry on hard tires; stops for fuel, wear and the weather still happen
+static bool stint_rule(const Car* car, bool is_raining, void* ctx, TireCompound* compound) {
+    (void)ctx;
+    bool wrong_tires = is_raining != (car->current_tires == TIRE_WET);
+    *compound = is_raining ? TIRE_WET : TIRE_HARD;
+    return car->fuel_level < 5.0 || car->tire_wear > 85.0 || wrong_tires ||
+           (car->current_sector == 2 && car->laps_completed % 9 == 8);
+}
+
+// Seed-dependent options, the same for the reference and every variant. A race_restore()
+// drops the pit rule, so the fork variant sets it again after each copy.
+static void apply_options(RaceContext* race) {
+    race->traffic = race->seed & 1;
+    if (race->seed % 3 == 0) race_set_pit_rule(race, 0, stint_rule, NULL);
+}
+
+static void start_race(RaceContext* race, RaceContext* spare, const EntryList* list, uint64_t seed,
+                       int variant, int tick_threads) {
+    race_init_seeded(race, list, seed);
+    apply_options(race);
+    if (variant == LOCKSTEP_SIMD || variant == LOCKSTEP_SIMD_THREADS) race_set_engine(race, ENGINE_SIMD);
+    if (variant == LOCKSTEP_THREADS || variant == LOCKSTEP_SIMD_THREADS) race_set_threads(race, tick_threads);
+    if (variant == LOCKSTEP_GENERIC) race->generic_update = true;
+    if (variant == LOCKSTEP_FORK) race_clone(spare, race);
+}
+
+// One tick of 'race' (tick: ticks run so far, this one included) and the variant's twist
+static void step_race(RaceContext* race, RaceContext* spare, int variant, long tick) {
+    race_run_step(race);
+    if (tick % LOCKSTEP_SWITCH_TICKS != 0) return;
+    if (variant == LOCKSTEP_SWITCH) {
+        race_set_engine(race, race->engine == ENGINE_SCALAR ? ENGINE_SIMD : ENGINE_SCALAR);
+    } else if (variant == LOCKSTEP_FORK) {
+        // The copy carries on and the old race becomes the next copy's storage
+        race_restore(spare, race);
+        apply_options(spare);
+        RaceContext tmp = *race;
+        *race = *spare;
+        *spare = tmp;
+    }
+}
+
+static void end_race(RaceContext* race, RaceContext* spare, int variant) {
+    race_cleanup(race);
+    if (variant == LOCKSTEP_FORK) race_cleanup(spare);
+}
+
+// --- FINDING THE FIRST DIFFERENCE ---
+
+static void add_detail(LockstepDivergence* d, const char* name, double expected, double got) {
+    size_t used = strlen(d->detail);
+    if (used + 1 >= sizeof(d->detail)) return;
+    snprintf(d->detail + used, sizeof(d->detail) - used, "%s%s %.17g vs %.17g", used ? "; " : "", name, expected, got);
+}
+
+#define CHECK_FIELD(d, ref, var, field) \
+    if ((ref)->field != (var)->field) add_detail(d, #field, (double)(ref)->field, (double)(var)->field)
+
+static void describe_car(LockstepDivergence* d, const RaceContext* ref, const RaceContext* var, int i) {
+    const Car* a = &ref->cars[i];
+    const Car* b = &var->cars[i];
+    CHECK_FIELD(d, a, b, state);
+    CHECK_FIELD(d, a, b, current_tires);
+    CHECK_FIELD(d, a, b, has_pitted_this_lap);
+    CHECK_FIELD(d, a, b, current_sector);
+    CHECK_FIELD(d, a, b, laps_completed);
+    CHECK_FIELD(d, a, b, speed_kmh);
+    CHECK_FIELD(d, a, b, fuel_level);
+    CHECK_FIELD(d, a, b, tire_wear);
+    CHECK_FIELD(d, a, b, reliability);
+    CHECK_FIELD(d, a, b, current_lap_time);
+    CHECK_FIELD(d, a, b, last_lap_time);
+    CHECK_FIELD(d, a, b, sector_times[0]);
+    CHECK_FIELD(d, a, b, sector_times[1]);
+    CHECK_FIELD(d, a, b, sector_times[2]);
+    CHECK_FIELD(d, a, b, total_race_time);
+    CHECK_FIELD(d, &ref->standings, &var->standings, position[i]);
+    CHECK_FIELD(d, &ref->standings, &var->standings, class_position[i]);
+    CHECK_FIELD(d, &ref->standings, &var->standings, best_lap[i]);
+}
+
+static void describe_race(LockstepDivergence* d, const RaceContext* ref, const RaceContext* var) {
+    CHECK_FIELD(d, ref, var, elapsed_time);
+    CHECK_FIELD(d, ref, var, safety_car_active);
+    CHECK_FIELD(d, ref, var, safety_car_timer);
+    CHECK_FIELD(d, ref, var, caution_mask);
+    CHECK_FIELD(d, ref, var, caution_end[0]);
+    CHECK_FIELD(d, ref, var, caution_end[1]);
+    CHECK_FIELD(d, ref, var, caution_end[2]);
+    CHECK_FIELD(d, ref, var, rng.counter);
+    for (int pos = 0; pos < ref->num_cars; pos++) {
+        if (ref->order[pos] != var->order[pos]) {
+            char name[32];
+            snprintf(name, sizeof(name), "order[%d]", pos);
+            add_detail(d, name, ref->order[pos], var->order[pos]);
+            break;
+        }
+    }
+    if (!d->detail[0]) snprintf(d->detail, sizeof(d->detail), "hashes differ, no field does");
+}
+
+// The variant drifted somewhere up to tick 'by': runs the pair again comparing every tick
+static void locate(const LockstepJob* job, const LockstepCase* c, int variant, long by, LockstepDivergence* d) {
+    const EntryList* list = &job->fields[c->field];
+    RaceContext ref, var, spare, unused;
+    start_race(&ref, &unused, list, c->seed, REFERENCE, 1);
+    start_race(&var, &spare, list, c->seed, variant, job->config->tick_threads);
+
+    memset(d, 0, sizeof(*d));
+    d->diverged = true;
+    d->num_cars = ref.num_cars;
+    d->seed = c->seed;
+    d->tick = by;
+    d->car = -1;
+    for (long tick = 1; tick <= by; tick++) {
+        race_run_step(&ref);
+        step_race(&var, &spare, variant, tick);
+        if (state_hash(&ref) == state_hash(&var)) continue;
+
+        d->tick = tick;
+        for (int i = 0; i < ref.num_cars; i++) {
+            if (car_hash(&ref, i) != car_hash(&var, i)) {
+                d->car = i;
+                describe_car(d, &ref, &var, i);
+                break;
+            }
+        }
+        if (d->car < 0) describe_race(d, &ref, &var);
+        break;
+    }
+    end_race(&ref, &unused, REFERENCE);
+    end_race(&var, &spare, variant);
+}
+
+static void run_case(void* ctx, int task, int worker) {
+    (void)worker;
+    LockstepJob* job = (LockstepJob*)ctx;
+    LockstepCase* c = &job->cases[task];
+    if (job->config->fail_fast && atomic_load_explicit(&job->drifted, memory_order_relaxed)) {
+        c->skipped = true;
+        return;
+    }
+    const EntryList* list = &job->fields[c->field];
+    int every = job->config->hash_every;
+
+    RaceContext ref, unused;
+    RaceContext var[LOCKSTEP_VARIANTS], spare[LOCKSTEP_VARIANTS];
+    long drifted[LOCKSTEP_VARIANTS];
+    start_race(&ref, &unused, list, c->seed, REFERENCE, 1);
+    for (int v = 0; v < LOCKSTEP_VARIANTS; v++) {
+        start_race(&var[v], &spare[v], list, c->seed, v, job->config->tick_threads);
+        drifted[v] = 0;
+    }
+
+    // A drifted variant stops there; it is found again exactly below
+    for (long tick = 1; !race_is_finished(&ref); tick++) {
+        race_run_step(&ref);
+        for (int v = 0; v < LOCKSTEP_VARIANTS; v++) {
+            if (!drifted[v]) step_race(&var[v], &spare[v], v, tick);
+        }
+        if (tick % every != 0 && !race_is_finished(&ref)) continue;
+
+        uint64_t h = state_hash(&ref);
+        for (int v = 0; v < LOCKSTEP_VARIANTS; v++) {
+            if (!drifted[v] && state_hash(&var[v]) != h) drifted[v] = tick;
+        }
+    }
+    c->final_hash = state_hash(&ref);
+
+    end_race(&ref, &unused, REFERENCE);
+    for (int v = 0; v < LOCKSTEP_VARIANTS; v++) {
+        end_race(&var[v], &spare[v], v);
+        memset(&c->divergence[v], 0, sizeof(c->divergence[v]));
+        if (drifted[v]) {
+            atomic_store_explicit(&job->drifted, true, memory_order_relaxed);
+            locate(job, c, v, drifted[v], &c->divergence[v]);
+        }
+    }
+}
+
+// --- THE EVENT ENGINES ---
+
+typedef struct {
+    const LockstepConfig* config;
+    double* stats;      // [race][engine][stat], NAN for a category with no finisher
+} StatJob;
+
+static double* stat_at(double* stats, int race, int engine) {
+    return &stats[((size_t)race * LOCKSTEP_STAT_ENGINES + engine) * LOCKSTEP_STATS];
+}
+
+static void run_stat_race(void* ctx, int task, int worker) {
+    (void)worker;
+    const StatJob* job = (const StatJob*)ctx;
+    for (int e = 0; e < LOCKSTEP_STAT_ENGINES; e++) {
+        RaceContext race;
+        race_init_seeded(&race, job->config->entries, job->config->base_seed + (uint64_t)task);
+        apply_options(&race);
+        race_set_engine(&race, STAT_ENGINES[e]);
+        race_run_until(&race, TOTAL_RACE_TIME);
+
+        long laps[CAR_CATEGORIES] = { 0 };
+        int finishers[CAR_CATEGORIES] = { 0 }, retired = 0;
+        for (int i = 0; i < race.num_cars; i++) {
+            const Car* c = &race.cars[i];
+            if (c->state == RETIRED) {
+                retired++;
+            } else {
+                laps[c->category] += c->laps_completed;
+                finishers[c->category]++;
+            }
+        }
+        double* out = stat_at(job->stats, task, e);
+        for (int c = 0; c < CAR_CATEGORIES; c++) out[c] = finishers[c] ? (double)laps[c] / finishers[c] : NAN;
+        out[CAR_CATEGORIES] = retired;
+        race_cleanup(&race);
+    }
+}
+
+// Mean and standard error of the mean of 'values', NANs left out
+static void mean_error(const double* values, int n, double* mean, double* error) {
+    double sum = 0.0, sum_sq = 0.0;
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        if (isnan(values[i])) continue;
+        sum += values[i];
+        sum_sq += values[i] * values[i];
+        count++;
+    }
+    *mean = count ? sum / count : 0.0;
+    double var = count > 1 ? (sum_sq - count * *mean * *mean) / (count - 1) : 0.0;
+    *error = count ? sqrt(fmax(var, 0.0) / count) : 0.0;
+}
+
+static double distance(double diff, double error) {
+    return error > 0.0 ? diff / error : (diff == 0.0 ? 0.0 : HUGE_VAL);
+}
+
+static void run_stats(const LockstepConfig* config, int num_threads, LockstepResult* result) {
+    int n = config->num_seeds * LOCKSTEP_STAT_RACES;
+    double* stats = (double*)malloc((size_t)n * LOCKSTEP_STAT_ENGINES * LOCKSTEP_STATS * sizeof(double));
+    double* values = (double*)malloc((size_t)n * sizeof(double));
+    if (!stats || !values) {
+        fprintf(stderr, "Error: Failed to allocate lockstep statistics.\n");
+        exit(EXIT_FAILURE);
+    }
+    StatJob job = { config, stats };
+    pool_run(num_threads, n, run_stat_race, &job);
+
+    result->stat_races = n;
+    result->stat_expected = config->builtin_field;
+    for (int k = 0; k < LOCKSTEP_STATS; k++) {
+        for (int e = 0; e < LOCKSTEP_STAT_ENGINES; e++) {
+            for (int r = 0; r < n; r++) values[r] = stat_at(stats, r, e)[k];
+            mean_error(values, n, &result->stat_mean[e][k], &result->stat_error[e][k]);
+        }
+        // The event engine against what it is known to give on the built-in field
+        result->stat_distance[0][k] = distance(result->stat_mean[0][k] - EVENT_EXPECTED[k],
+                                               hypot(result->stat_error[0][k], EVENT_EXPECTED_ERROR[k]));
+        // The adaptive engine race by race against the event engine: the weather is the seed's
+        // on both, so the differences vary less than either engine does
+        for (int r = 0; r < n; r++) values[r] = stat_at(stats, r, 1)[k] - stat_at(stats, r, 0)[k];
+        double diff, error;
+        mean_error(values, n, &diff, &error);
+        result->stat_distance[1][k] = distance(diff, error);
+    }
+    free(values);
+    free(stats);
+}
+
+void lockstep_run(const LockstepConfig* config, LockstepResult* result) {
+    memset(result, 0, sizeof(*result));
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    EntryList fields[LOCKSTEP_FIELDS];
+    int num_cases = 0;
+    for (int f = 0; f < LOCKSTEP_FIELDS; f++) {
+        const EntryList* base = config->entries;
+        entry_list_init(&fields[f]);
+        for (int e = 0; e < base->num_entries; e++) {
+            entry_list_add(&fields[f], entry_team(base, e), entry_driver(base, e), base->entries[e].category);
+        }
+        if (FIELD_CARS[f] > 0) entry_list_resize(&fields[f], FIELD_CARS[f]);
+        result->field_cars[f] = fields[f].num_entries;
+        result->field_seeds[f] = (config->num_seeds + FIELD_SHARE[f] - 1) / FIELD_SHARE[f];
+        num_cases += result->field_seeds[f];
+    }
+
+    LockstepCase* cases = (LockstepCase*)calloc(num_cases, sizeof(LockstepCase));
+    if (!cases) {
+        fprintf(stderr, "Error: Failed to allocate lockstep cases.\n");
+        exit(EXIT_FAILURE);
+    }
+    // Biggest fields first, so no worker is left with one of them at the end
+    int next = 0;
+    for (int f = LOCKSTEP_FIELDS - 1; f >= 0; f--) {
+        for (int s = 0; s < result->field_seeds[f]; s++) {
+            cases[next].field = f;
+            cases[next].seed = config->base_seed + (uint64_t)s;
+            next++;
+        }
+    }
+
+    int num_threads = config->num_threads > 0 ? config->num_threads : pool_default_threads();
+    LockstepJob job = { config, fields, cases, false };
+    pool_run(num_threads, num_cases, run_case, &job);
+    if (!config->fail_fast || !atomic_load(&job.drifted)) run_stats(config, num_threads, result);
+
+    // In case order, so the digest does not depend on which worker ran what
+    result->digest = 0xA4093822299F31D0ULL;
+    for (int k = 0; k < num_cases; k++) {
+        const LockstepCase* c = &cases[k];
+        if (c->skipped) {
+            result->cases_skipped++;
+            continue;
+        }
+        result->digest = mix(result->digest, c->final_hash);
+        result->races_run += 1 + LOCKSTEP_VARIANTS;
+        for (int v = 0; v < LOCKSTEP_VARIANTS; v++) {
+            const LockstepDivergence* d = &c->divergence[v];
+            if (!d->diverged) continue;
+            result->diverged[c->field][v]++;
+            LockstepDivergence* first = &result->first[v];
+            if (!first->diverged || d->num_cars < first->num_cars ||
+                (d->num_cars == first->num_cars && d->seed < first->seed)) {
+                *first = *d;
+            }
+        }
+    }
+
+    result->races_run += (long)result->stat_races * LOCKSTEP_STAT_ENGINES;
+
+    free(cases);
+    for (int f = 0; f < LOCKSTEP_FIELDS; f++) entry_list_free(&fields[f]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    result->wall_seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+}
+
+bool lockstep_print(const LockstepResult* result) {
+    printf("=== LOCKSTEP REGRESSION: %d VARIANTS AGAINST THE SCALAR ENGINE ===\n", LOCKSTEP_VARIANTS);
+    printf("%-6s | %-5s", "Cars", "Seeds");
+    for (int v = 0; v < LOCKSTEP_VARIANTS; v++) printf(" | %-12s", VARIANT_NAMES[v]);
+    printf("\n");
+    printf("-----------------------------------------------------------------------------------------\n");
+    bool all_match = true;
+    for (int f = 0; f < LOCKSTEP_FIELDS; f++) {
+        printf("%-6d | %5d", result->field_cars[f], result->field_seeds[f]);
+        for (int v = 0; v < LOCKSTEP_VARIANTS; v++) {
+            int n = result->diverged[f][v];
+            if (n == 0) {
+                printf(" | %-12s", "ok");
+            } else {
+                char cell[24];
+                snprintf(cell, sizeof(cell), "%d DIFFER", n);
+                printf(" | %-12s", cell);
+                all_match = false;
+            }
+        }
+        printf("\n");
+    }
+
+    for (int v = 0; v < LOCKSTEP_VARIANTS; v++) {
+        const LockstepDivergence* d = &result->first[v];
+        if (!d->diverged) continue;
+        printf("\n%s: %d cars, seed %llu: first differs after tick %ld (race time %.0f s)",
+               VARIANT_NAMES[v], d->num_cars, (unsigned long long)d->seed, d->tick, d->tick * RACE_TICK_SECONDS);
+        if (d->car >= 0) printf(", car #%d", d->car + 1);
+        printf("\n  %s\n", d->detail);
+    }
+
+    if (result->stat_races > 0) {
+        printf("\n=== EVENT ENGINES: %d RACES EACH ===\n", result->stat_races);
+        printf("%-20s | %-28s | %-28s\n", "Per race", "event (against expected)", "adaptive (against event)");
+        printf("-----------------------------------------------------------------------------------\n");
+        for (int k = 0; k < LOCKSTEP_STATS; k++) {
+            printf("%-20s", STAT_NAMES[k]);
+            for (int e = 0; e < LOCKSTEP_STAT_ENGINES; e++) {
+                char cell[48];
+                int used = snprintf(cell, sizeof(cell), "%.2f +- %.2f", result->stat_mean[e][k], result->stat_error[e][k]);
+                if (e > 0 || result->stat_expected) {
+                    double z = result->stat_distance[e][k];
+                    bool within = fabs(z) <= LOCKSTEP_STAT_LIMIT;
+                    snprintf(cell + used, sizeof(cell) - used, " (%+.1f se)%s", z, within ? "" : " !");
+                    if (!within) all_match = false;
+                }
+                printf(" | %-28s", cell);
+            }
+            printf("\n");
+        }
+        if (!result->stat_expected) printf("(Not the built-in field: the event engine has nothing to be checked against)\n");
+    }
+
+    double minutes = result->wall_seconds / 60.0;
+    if (result->cases_skipped > 0) {
+        printf("\n%d field and seed pairs and the event engines skipped after the first divergence\n",
+               result->cases_skipped);
+    }
+    printf("\nReference digest: %016llx\n", (unsigned long long)result->digest);
+    printf("%ld races in %.3f s (%.0f races/min): %s\n", result->races_run, result->wall_seconds,
+           minutes > 0.0 ? result->races_run / minutes : 0.0,
+           all_match ? "every variant matches" : "VARIANTS DIVERGED");
+    return all_match;
+}
@@ -1,163 +1,697 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
 #include <unistd.h>
+#include <pthread.h>
 #include "race.h"
+#include "core.h"
+#include "analysis.h"
+#include "checkpoint.h"
+#include "ensemble.h"
+#include "feed.h"
+#include "instrument.h"
+#include "lockstep.h"
+#include "strategy.h"
+#include "display.h"
+#include "render.h"
+#include "snapshot.h"
+#include "telemetry.h"
 
-// ANSI Color Codes
-#define ANSI_COLOR_RED     "\x1b[31m"
-#define ANSI_COLOR_GREEN   "\x1b[32m"
-#define ANSI_COLOR_YELLOW  "\x1b[33m"
-#define ANSI_COLOR_BLUE    "\x1b[34m"
-#define ANSI_COLOR_MAGENTA "\x1b[35m"
-#define ANSI_COLOR_CYAN    "\x1b[36m"
-#define ANSI_COLOR_WHITE   "\x1b[37m"
-#define ANSI_COLOR_GRAY    "\x1b[90m"
-#define ANSI_COLOR_RESET   "\x1b[0m"
-
-void print_status(RaceContext* race) {
-    // Clear console
-    printf("\033[H\033[J"); 
-
-    int hours = (int)race->elapsed_time / 3600;
-    int minutes = ((int)race->elapsed_time % 3600) / 60;
-    int seconds = (int)race->elapsed_time % 60;
-
-    printf("=== LE MANS 24H SIMULATION ===\n");
-    
-    // Weather Display
-    if (race->weather == WEATHER_RAIN) {
-         printf("Weather: 🌧️  %sRAIN / WET TRACK%s  Time: %02dh %02dm %02ds\n", 
-                ANSI_COLOR_BLUE, ANSI_COLOR_RESET, hours, minutes, seconds);
-    } else {
-         printf("Weather: ☀️  %sSUNNY / DRY TRACK%s  Time: %02dh %02dm %02ds\n", 
-                ANSI_COLOR_YELLOW, ANSI_COLOR_RESET, hours, minutes, seconds);
+#define MAX_ANALYZE_FILES 256
+
+// Command line options
+typedef struct {
+    bool headless;      // Run without rendering or sleeping
+    long max_steps;     // Stop after this many steps (0 = no limit)
+    double max_time;    // Stop once this much race time has elapsed (seconds)
+    int num_cars;       // Field size (0 = the whole entry list)
+    const char* entries_path;   // CSV entry list (default: the built-in 2025 list)
+    bool has_seed;      // Fixed seed given on the command line
+    uint64_t seed;
+    int ensemble_races; // > 0 switches to the Monte Carlo ensemble runner
+    int threads;        // Ensemble worker threads (0 = one per core)
+    int tick_threads;   // Threads sharing each tick of a single race (0 = one per core)
+    int strategy_car;   // > 0 searches pit plans for this car number
+    double strategy_from;       // Race time to search from (seconds)
+    int strategy_samples;       // Futures per surviving plan
+    RaceEngine engine;
+    bool has_engine;    // --engine given (a resumed race otherwise keeps its own)
+    bool traffic;       // Cars lose time in traffic (see track.h)
+    int fps;            // Live display frame rate
+    double time_scale;  // Live mode: race seconds per wall second (0 = unlimited)
+    const char* record_path;    // Write sector telemetry here
+    const char* replay_path;    // Play back a telemetry file instead of simulating
+    const char* checkpoint_path;    // Save the race state here periodically and at the end
+    double checkpoint_every;        // Race seconds between checkpoints
+    const char* resume_path;        // Continue from a checkpoint instead of starting a race
+    const char* feed_address;       // Live timing feed socket (see feed.h)
+    FeedFormat feed_format;
+    int feed_clients;               // Subscribers to wait for before the start
+    bool profile;                   // Print the instrumentation summary at the end
+    const char* trace_path;         // Write the instrumentation as a Chrome trace
+    double replay_from;         // Replay start time (seconds)
+    const char* analyze_paths[MAX_ANALYZE_FILES];   // Telemetry files to analyse instead of simulating
+    int num_analyze;
+    bool lap_stats;             // Ensemble: analyse every race's laps too
+    int scenarios;              // Ensemble: > 0 shares this many weather timelines between the races
+    int lockstep_seeds;         // > 0 checks the engine variants against each other instead
+    int lockstep_every;         // Ticks between the lockstep state comparisons
+    bool lockstep_fail_fast;    // Stop checking at the first divergence
+} SimOptions;
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --headless         Simulate as fast as possible, print only the final result\n");
+    printf("  --max-steps N      Stop after N simulation steps (default: no limit)\n");
+    printf("  --max-time SECS    Stop after SECS seconds of race time (default: %d)\n", TOTAL_RACE_TIME);
+    printf("  --cars N           Field size: truncates the entry list or pads it with synthetic entries\n");
+    printf("                     (default: the whole list)\n");
+    printf("  --entries FILE     Entry list as CSV: team,driver,category (default: 2025 Le Mans list)\n");
+    printf("  --seed S           Random seed (default: current time)\n");
+    printf("  --ensemble N       Run N independent races and print outcome statistics\n");
+    printf("  --threads T        Ensemble and analysis worker threads (default: one per core)\n");
+    printf("  --lap-stats        With --ensemble: also analyse the laps of every race (see --analyze)\n");
+    printf("  --scenarios N      With --ensemble: race i runs in weather scenario i %% N (seeds from --seed)\n");
+    printf("                     instead of its own (default: every race has its own weather)\n");
+    printf("  --tick-threads T   Threads sharing every tick of one race (scalar/simd), 0 = one per core\n");
+    printf("                     (default: 1; results do not depend on it)\n");
+    printf("  --strategy CAR     Search pit plans for car number CAR and print the best ones\n");
+    printf("  --strategy-from S  Race time the search forks the race at (default: 0)\n");
+    printf("  --samples N        Futures each surviving plan is run on (default: 16)\n");
+    printf("  --engine NAME      Physics engine: scalar (reference), simd, event or adaptive (event, with\n");
+    printf("                     runs of green-flag sectors in one event) (default: scalar)\n");
+    printf("  --traffic          Cars lose time passing slower cars and fighting their own class\n");
+    printf("  --fps N            Live display frame rate (default: 10)\n");
+    printf("  --time-scale X     Live mode race seconds per real second, 0 = unlimited (default: 400)\n");
+    printf("  --record FILE      Record every sector of every car to a telemetry file\n");
+    printf("  --checkpoint FILE  Save the race state to FILE periodically and when the run stops\n");
+    printf("  --checkpoint-every SECS  Race time between checkpoints (default: 3600)\n");
+    printf("  --resume FILE      Continue the race saved in FILE (with --seed: branch a new future from it)\n");
+    printf("  --feed ADDR        Publish live timing on unix:PATH or tcp:PORT (localhost)\n");
+    printf("  --feed-format F    Timing feed format: json (one object per line) or binary (default: json)\n");
+    printf("  --feed-clients N   Wait for N feed subscribers before starting the race\n");
+    printf("  --profile          Print time per tick phase and event counts (needs make INSTRUMENT=1)\n");
+    printf("  --trace FILE       Write the tick phases as Chrome trace JSON (needs make INSTRUMENT=1)\n");
+    printf("  --replay FILE      Play back a telemetry file (with --headless: standings at --max-time)\n");
+    printf("  --replay-from SECS Start the playback at this race time\n");
+    printf("  --analyze FILE     Pace, tire degradation, stint and pit loss analysis of telemetry files\n");
+    printf("                     (repeat for more files; they are added up)\n");
+    printf("  --lockstep N       Check that every fixed-step engine variant runs N seeds (from --seed,\n");
+    printf("                     default 1) bit for bit like the scalar engine, and the event engines\n");
+    printf("                     over %d races per seed statistically; exit 1 if any differs\n", LOCKSTEP_STAT_RACES);
+    printf("  --lockstep-every T Ticks between the lockstep state comparisons (default: 10)\n");
+    printf("  --lockstep-fail-fast  Start no further lockstep races once a variant has differed\n");
+    printf("  --help             Show this message\n");
+}
+
+static bool parse_options(int argc, char** argv, SimOptions* opt) {
+    opt->headless = false;
+    opt->max_steps = 0;
+    opt->max_time = TOTAL_RACE_TIME;
+    opt->num_cars = 0;
+    opt->entries_path = NULL;
+    opt->has_seed = false;
+    opt->seed = 0;
+    opt->ensemble_races = 0;
+    opt->threads = 0;
+    opt->tick_threads = 1;
+    opt->strategy_car = 0;
+    opt->strategy_from = 0.0;
+    opt->strategy_samples = 16;
+    opt->engine = ENGINE_SCALAR;
+    opt->has_engine = false;
+    opt->traffic = false;
+    opt->fps = 10;
+    opt->time_scale = 400.0;
+    opt->record_path = NULL;
+    opt->replay_path = NULL;
+    opt->checkpoint_path = NULL;
+    opt->checkpoint_every = 3600.0;
+    opt->resume_path = NULL;
+    opt->feed_address = NULL;
+    opt->feed_format = FEED_JSON;
+    opt->feed_clients = 0;
+    opt->profile = false;
+    opt->trace_path = NULL;
+    opt->replay_from = 0.0;
+    opt->num_analyze = 0;
+    opt->lap_stats = false;
+    opt->scenarios = 0;
+    opt->lockstep_seeds = 0;
+    opt->lockstep_every = 10;
+    opt->lockstep_fail_fast = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (strcmp(arg, "--headless") == 0) {
+            opt->headless = true;
+        } else if (strcmp(arg, "--max-steps") == 0 && has_value) {
+            opt->max_steps = atol(argv[++i]);
+        } else if (strcmp(arg, "--max-time") == 0 && has_value) {
+            opt->max_time = atof(argv[++i]);
+        } else if (strcmp(arg, "--cars") == 0 && has_value) {
+            opt->num_cars = atoi(argv[++i]);
+            if (opt->num_cars <= 0) {
+                fprintf(stderr, "Error: --cars must be positive.\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--entries") == 0 && has_value) {
+            opt->entries_path = argv[++i];
+        } else if (strcmp(arg, "--seed") == 0 && has_value) {
+            opt->seed = strtoull(argv[++i], NULL, 0);
+            opt->has_seed = true;
+        } else if (strcmp(arg, "--ensemble") == 0 && has_value) {
+            opt->ensemble_races = atoi(argv[++i]);
+            if (opt->ensemble_races <= 0) {
+                fprintf(stderr, "Error: --ensemble needs a positive number of races.\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--threads") == 0 && has_value) {
+            opt->threads = atoi(argv[++i]);
+            if (opt->threads < 0) {
+                fprintf(stderr, "Error: --threads cannot be negative (0 = one per core).\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--tick-threads") == 0 && has_value) {
+            opt->tick_threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--strategy") == 0 && has_value) {
+            opt->strategy_car = atoi(argv[++i]);
+            if (opt->strategy_car <= 0) {
+                fprintf(stderr, "Error: --strategy needs a car number.\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--strategy-from") == 0 && has_value) {
+            opt->strategy_from = atof(argv[++i]);
+        } else if (strcmp(arg, "--samples") == 0 && has_value) {
+            opt->strategy_samples = atoi(argv[++i]);
+            if (opt->strategy_samples <= 0) {
+                fprintf(stderr, "Error: --samples must be positive.\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--engine") == 0 && has_value) {
+            const char* name = argv[++i];
+            if (strcmp(name, "scalar") == 0) opt->engine = ENGINE_SCALAR;
+            else if (strcmp(name, "simd") == 0) opt->engine = ENGINE_SIMD;
+            else if (strcmp(name, "event") == 0) opt->engine = ENGINE_EVENT;
+            else if (strcmp(name, "adaptive") == 0) opt->engine = ENGINE_ADAPTIVE;
+            else {
+                fprintf(stderr, "Error: Unknown engine '%s'.\n", name);
+                return false;
+            }
+            opt->has_engine = true;
+        } else if (strcmp(arg, "--traffic") == 0) {
+            opt->traffic = true;
+        } else if (strcmp(arg, "--time-scale") == 0 && has_value) {
+            opt->time_scale = atof(argv[++i]);
+        } else if (strcmp(arg, "--fps") == 0 && has_value) {
+            opt->fps = atoi(argv[++i]);
+        } else if (strcmp(arg, "--record") == 0 && has_value) {
+            opt->record_path = argv[++i];
+        } else if (strcmp(arg, "--checkpoint") == 0 && has_value) {
+            opt->checkpoint_path = argv[++i];
+        } else if (strcmp(arg, "--checkpoint-every") == 0 && has_value) {
+            opt->checkpoint_every = atof(argv[++i]);
+        } else if (strcmp(arg, "--resume") == 0 && has_value) {
+            opt->resume_path = argv[++i];
+        } else if (strcmp(arg, "--feed") == 0 && has_value) {
+            opt->feed_address = argv[++i];
+        } else if (strcmp(arg, "--feed-format") == 0 && has_value) {
+            const char* name = argv[++i];
+            if (strcmp(name, "json") == 0) opt->feed_format = FEED_JSON;
+            else if (strcmp(name, "binary") == 0) opt->feed_format = FEED_BINARY;
+            else {
+                fprintf(stderr, "Error: Unknown feed format '%s'.\n", name);
+                return false;
+            }
+        } else if (strcmp(arg, "--feed-clients") == 0 && has_value) {
+            opt->feed_clients = atoi(argv[++i]);
+            if (opt->feed_clients < 0) {
+                fprintf(stderr, "Error: --feed-clients cannot be negative.\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--profile") == 0) {
+            opt->profile = true;
+        } else if (strcmp(arg, "--trace") == 0 && has_value) {
+            opt->trace_path = argv[++i];
+        } else if (strcmp(arg, "--replay") == 0 && has_value) {
+            opt->replay_path = argv[++i];
+        } else if (strcmp(arg, "--replay-from") == 0 && has_value) {
+            opt->replay_from = atof(argv[++i]);
+        } else if (strcmp(arg, "--analyze") == 0 && has_value) {
+            if (opt->num_analyze == MAX_ANALYZE_FILES) {
+                fprintf(stderr, "Error: At most %d files can be analysed in one run.\n", MAX_ANALYZE_FILES);
+                return false;
+            }
+            opt->analyze_paths[opt->num_analyze++] = argv[++i];
+        } else if (strcmp(arg, "--lap-stats") == 0) {
+            opt->lap_stats = true;
+        } else if (strcmp(arg, "--scenarios") == 0 && has_value) {
+            opt->scenarios = atoi(argv[++i]);
+            if (opt->scenarios <= 0) {
+                fprintf(stderr, "Error: --scenarios must be positive.\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--lockstep") == 0 && has_value) {
+            opt->lockstep_seeds = atoi(argv[++i]);
+            if (opt->lockstep_seeds <= 0) {
+                fprintf(stderr, "Error: --lockstep needs a positive number of seeds.\n");
+                return false;
+            }
+        } else if (strcmp(arg, "--lockstep-every") == 0 && has_value) {
+            opt->lockstep_every = atoi(argv[++i]);
+        } else if (strcmp(arg, "--lockstep-fail-fast") == 0) {
+            opt->lockstep_fail_fast = true;
+        } else if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            exit(EXIT_SUCCESS);
+        } else {
+            fprintf(stderr, "Error: Unknown or incomplete option '%s'.\n", arg);
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    // 0 means no limit, unlimited speed and one thread per core respectively
+    if (opt->max_steps < 0 || opt->time_scale < 0.0 || opt->tick_threads < 0) {
+        fprintf(stderr, "Error: --max-steps, --time-scale and --tick-threads cannot be negative.\n");
+        return false;
+    }
+    if (opt->max_time <= 0.0 || opt->fps <= 0 || opt->checkpoint_every <= 0.0 || opt->lockstep_every <= 0) {
+        fprintf(stderr, "Error: --max-time, --fps, --checkpoint-every and --lockstep-every must be positive.\n");
+        return false;
+    }
+    if ((opt->profile || opt->trace_path) && !instr_available()) {
+        fprintf(stderr, "Error: --profile and --trace need an instrumented build (make INSTRUMENT=1).\n");
+        return false;
+    }
+    if (opt->resume_path && (opt->entries_path || opt->num_cars > 0 || opt->ensemble_races > 0 ||
+                             opt->lockstep_seeds > 0)) {
+        fprintf(stderr, "Error: --resume takes the field from the checkpoint; it cannot be combined with --entries, --cars, --ensemble or --lockstep.\n");
+        return false;
+    }
+    if (opt->scenarios > 0 && opt->ensemble_races <= 0) {
+        fprintf(stderr, "Error: --scenarios needs --ensemble.\n");
+        return false;
+    }
+    if (opt->lap_stats && opt->ensemble_races <= 0) {
+        fprintf(stderr, "Error: --lap-stats needs --ensemble; analyse a single race with --record and --analyze.\n");
+        return false;
+    }
+    return true;
+}
+
+static double wall_clock_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// First race time at which a periodic checkpoint is due
+static double first_checkpoint(const RaceContext* race, const SimOptions* opt) {
+    return (floor(race->elapsed_time / opt->checkpoint_every) + 1.0) * opt->checkpoint_every;
+}
+
+// Saves a checkpoint each time the race clock passes a multiple of --checkpoint-every
+static void checkpoint_if_due(const RaceContext* race, const SimOptions* opt, double* next_due) {
+    if (!opt->checkpoint_path || race->elapsed_time < *next_due) return;
+    checkpoint_save(race, opt->checkpoint_path);
+    while (*next_due <= race->elapsed_time) *next_due += opt->checkpoint_every;
+}
+
+// Headless batch mode: no rendering and no sleeping inside the loop
+static void run_headless(RaceContext* race, const SimOptions* opt, FeedServer* feed) {
+    long steps = 0;
+    double start = wall_clock_seconds();
+    double next_checkpoint = first_checkpoint(race, opt);
+
+    while (race->elapsed_time < opt->max_time && !race_is_finished(race)) {
+        if (opt->max_steps > 0 && steps >= opt->max_steps) break;
+        race_run_step(race);
+        steps++;
+        checkpoint_if_due(race, opt, &next_checkpoint);
+        if (feed) feed_publish(feed, race, false);
+    }
+
+    double wall = wall_clock_seconds() - start;
+    if (opt->checkpoint_path) checkpoint_save(race, opt->checkpoint_path);
+    if (feed) feed_publish(feed, race, true);
+
+    RaceSnapshot result;
+    snapshot_alloc(&result, race->num_cars);
+    snapshot_capture(&result, race);
+    print_classification(&result);
+    snapshot_free(&result);
+
+    printf("\nSeed: %llu\n", (unsigned long long)race->seed);
+    printf("Simulated %ld steps in %.3f ms (%.0f steps/s)\n",
+           steps, wall * 1000.0, wall > 0.0 ? steps / wall : 0.0);
+}
+
+// --- LIVE MODE ---
+// The simulation runs on its own thread and publishes snapshots through a triple buffer;
+// the main thread renders whichever snapshot is newest at its own frame rate.
+
+typedef struct {
+    RaceContext* race;
+    const SimOptions* opt;
+    SnapshotBuffer* snapshots;
+    FeedServer* feed;           // NULL without --feed
+} SimThreadArgs;
+
+static void sleep_until(double wall_target) {
+    double delay = wall_target - wall_clock_seconds();
+    if (delay > 0.0) usleep((useconds_t)(delay * 1e6));
+}
+
+static void* simulation_thread(void* arg) {
+    SimThreadArgs* args = (SimThreadArgs*)arg;
+    RaceContext* race = args->race;
+    const SimOptions* opt = args->opt;
+
+    double start = wall_clock_seconds();
+    double start_race_time = race->elapsed_time;
+    double next_checkpoint = first_checkpoint(race, opt);
+    long steps = 0;
+
+    snapshot_publish(args->snapshots, race, false);
+    while (race->elapsed_time < opt->max_time && !race_is_finished(race)) {
+        if (opt->max_steps > 0 && steps >= opt->max_steps) break;
+        race_run_step(race);
+        steps++;
+        checkpoint_if_due(race, opt, &next_checkpoint);
+        if (args->feed) feed_publish(args->feed, race, false);
+
+        // Only pay for a capture once the renderer has taken the previous one
+        if (!snapshot_consumer_behind(args->snapshots)) {
+            INSTR_BEGIN(PHASE_SNAPSHOT);
+            snapshot_publish(args->snapshots, race, false);
+            INSTR_END(PHASE_SNAPSHOT);
+        }
+
+        // Time compression: race seconds per wall-clock second (0 = as fast as possible)
+        if (opt->time_scale > 0.0) {
+            sleep_until(start + (race->elapsed_time - start_race_time) / opt->time_scale);
+        }
+    }
+    if (opt->checkpoint_path) checkpoint_save(race, opt->checkpoint_path);
+    if (args->feed) feed_publish(args->feed, race, true);
+    snapshot_publish(args->snapshots, race, true);
+    return NULL;
+}
+
+static void run_live(RaceContext* race, const SimOptions* opt, FeedServer* feed) {
+    SnapshotBuffer snapshots;
+    snapshot_buffer_init(&snapshots, race->num_cars);
+
+    Screen screen;
+    screen_init(&screen, status_screen_rows(race->num_cars), STATUS_COLS, STDOUT_FILENO);
+
+    SimThreadArgs args = { race, opt, &snapshots, feed };
+    pthread_t sim;
+    if (pthread_create(&sim, NULL, simulation_thread, &args) != 0) {
+        fprintf(stderr, "Error: Failed to start simulation thread.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double frame = 1.0 / opt->fps;
+    double next_frame = wall_clock_seconds();
+    while (1) {
+        const RaceSnapshot* snap = snapshot_acquire(&snapshots);
+        if (snap) {
+            INSTR_BEGIN(PHASE_RENDER);
+            print_status(&screen, snap);
+            INSTR_END(PHASE_RENDER);
+            if (snap->finished) break;
+        }
+        next_frame += frame;
+        sleep_until(next_frame);
     }
 
-    // Safety Car Alert
-    if (race->safety_car_active) {
-        printf("\n\033[43m\033[30m"); 
-        printf("************************************************************************\n");
-        printf("   SAFETY CAR DEPLOYED  -  NO OVERTAKING  -  SLOW DOWN  -  SC IN LAP   \n");
-        printf("************************************************************************\n");
-        printf("\033[0m\n"); 
+    pthread_join(sim, NULL);
+    screen_free(&screen);
+    snapshot_buffer_free(&snapshots);
+}
+
+// --- REPLAY MODE ---
+// Plays a recorded race from the memory-mapped file; nothing is re-simulated.
+static int run_replay(const SimOptions* opt) {
+    TelemetryReplay replay;
+    if (!telemetry_replay_open(&replay, opt->replay_path)) return EXIT_FAILURE;
+
+    RaceSnapshot snap;
+    snapshot_alloc(&snap, replay.header->num_cars);
+
+    if (opt->headless) {
+        // The file ends at the last record; the run itself stopped on a whole step
+        double end = ceil(replay.duration / RACE_TICK_SECONDS) * RACE_TICK_SECONDS;
+        double t = opt->max_time < end ? opt->max_time : end;
+        double start = wall_clock_seconds();
+        telemetry_replay_seek(&replay, t, &snap);
+        double seek = wall_clock_seconds() - start;
+
+        print_classification(&snap);
+        printf("\nReplay of seed %llu: %zu records, seek to %.0f s took %.3f ms\n",
+               (unsigned long long)replay.header->seed, replay.num_records, t, seek * 1000.0);
     } else {
-        printf("\nStatus: GREEN FLAG\n\n");
-    }
-    
-    // Header
-    // MODIFICATION ICI: "Team" passe à 25 de large
-    printf("%-4s | %-25s | %-10s | %-8s | %-12s | %-10s | %-10s | %-6s\n", 
-           "Pos", "Team", "Cat", "Laps", "Gap", "State", "Tire", "Rel%");
-    // La ligne de séparation doit être un peu plus longue pour compenser
-    printf("-------------------------------------------------------------------------------------------------------------\n");
-
-    if (race->num_cars == 0) return;
-    Car* leader = &race->cars[0];
-
-    for (int i = 0; i < race->num_cars; i++) {
-        Car* c = &race->cars[i];
-        
-        // Check if retired to override colors
-        bool is_retired = (c->state == RETIRED);
-        char* base_color = is_retired ? ANSI_COLOR_GRAY : ANSI_COLOR_RESET;
-
-        // 1. Categories
-        char* cat_color = ANSI_COLOR_RESET;
-        char cat_str[10];
-        
-        if (is_retired) {
-             cat_color = ANSI_COLOR_GRAY; 
-        } else {
-            if (c->category == LMH) cat_color = ANSI_COLOR_RED;
-            else if (c->category == LMP2) cat_color = ANSI_COLOR_BLUE;
-            else cat_color = ANSI_COLOR_YELLOW;
+        Screen screen;
+        screen_init(&screen, status_screen_rows(replay.header->num_cars), STATUS_COLS, STDOUT_FILENO);
+
+        double t = opt->replay_from;
+        double frame = 1.0 / opt->fps;
+        double next_frame = wall_clock_seconds();
+        while (1) {
+            telemetry_replay_seek(&replay, t, &snap);
+            print_status(&screen, &snap);
+            if (snap.finished) break;
+
+            t = (opt->time_scale > 0.0) ? t + opt->time_scale * frame : replay.duration;
+            next_frame += frame;
+            sleep_until(next_frame);
         }
-        
-        if (c->category == LMH) sprintf(cat_str, "HYPER");
-        else if (c->category == LMP2) sprintf(cat_str, "LMP2");
-        else sprintf(cat_str, "LMGT3");
-
-        // 2. Gap
-        char gap_str[20];
-        if (is_retired) {
-            sprintf(gap_str, "---");
-        } else if (i == 0) {
-            sprintf(gap_str, "LEADER");
-        } else {
-            int lap_diff = leader->laps_completed - c->laps_completed;
-            if (lap_diff > 0) sprintf(gap_str, "+%d Laps", lap_diff);
-            else sprintf(gap_str, "+%.1f s", c->total_race_time - leader->total_race_time);
+        screen_free(&screen);
+    }
+
+    snapshot_free(&snap);
+    telemetry_replay_close(&replay);
+    return 0;
+}
+
+// --- ANALYSIS MODE ---
+// One pass over every file, a chunk at a time: the files are never loaded whole.
+static int run_analysis(const SimOptions* opt) {
+    Analysis an;
+    analysis_init(&an, opt->threads);
+    double start = wall_clock_seconds();
+    for (int f = 0; f < opt->num_analyze; f++) {
+        if (!analysis_add_file(&an, opt->analyze_paths[f])) {
+            analysis_free(&an);
+            return EXIT_FAILURE;
         }
+    }
+    double seconds = wall_clock_seconds() - start;
+
+    analysis_print(&an);
+    uint64_t records = 0;
+    for (int w = 0; w < an.num_threads; w++) records += an.workers[w].totals.records;
+    printf("\n%d file(s), %llu records in %.3f s (%.1f M records/s on %d threads)\n", opt->num_analyze,
+           (unsigned long long)records, seconds, seconds > 0.0 ? records / seconds / 1e6 : 0.0, an.num_threads);
+    analysis_free(&an);
+    return 0;
+}
 
-        // 3. State
-        char state_str[10];
-        char* state_color = ANSI_COLOR_GREEN;
-        
-        if (is_retired) {
-            sprintf(state_str, "DNF");
-            state_color = ANSI_COLOR_RED; 
-        } else if (c->state == PIT_STOP) {
-            sprintf(state_str, "IN PIT");
-            state_color = ANSI_COLOR_MAGENTA; 
-        } else if (c->state == CRASHED) {
-            sprintf(state_str, "CRASH");
-            state_color = ANSI_COLOR_RED;
+// --- LOCKSTEP MODE ---
+// Exits with a failure when any variant left the scalar engine, so scripts can gate on it
+static int run_lockstep(const EntryList* entries, const SimOptions* opt) {
+    LockstepConfig config = {
+        entries, opt->lockstep_seeds, opt->has_seed ? opt->seed : 1, opt->lockstep_every,
+        opt->tick_threads >= 2 ? opt->tick_threads : 4, opt->threads, opt->lockstep_fail_fast,
+        !opt->entries_path && opt->num_cars == 0
+    };
+    LockstepResult result;
+    lockstep_run(&config, &result);
+    return lockstep_print(&result) ? 0 : EXIT_FAILURE;
+}
+
+// Runs the race on to --strategy-from with the built-in rule, then searches plans from there
+static int run_strategy(RaceContext* race, const SimOptions* opt) {
+    if (opt->strategy_car > race->num_cars) {
+        fprintf(stderr, "Error: There is no car #%d in a field of %d.\n", opt->strategy_car, race->num_cars);
+        return EXIT_FAILURE;
+    }
+    while (race->elapsed_time < opt->strategy_from && !race_is_finished(race)) {
+        race_run_step(race);
+    }
+    race_set_threads(race, 1);
+    if (race->cars[opt->strategy_car - 1].state == RETIRED) {
+        fprintf(stderr, "Error: Car #%d has already retired at %.0f s.\n", opt->strategy_car, race->elapsed_time);
+        return EXIT_FAILURE;
+    }
+
+    StrategyConfig config = {
+        race, opt->strategy_car - 1, opt->strategy_samples, opt->threads, race->seed + 1
+    };
+    StrategyResult result;
+    strategy_search(&config, &result);
+    strategy_print(&result, race, opt->strategy_car - 1);
+    strategy_free(&result);
+    return 0;
+}
+
+// Instrumentation output requested on the command line (instrumented builds only)
+static void report_instrumentation(const SimOptions* opt) {
+    if (opt->profile) instr_print_summary();
+    if (opt->trace_path && instr_write_trace(opt->trace_path)) {
+        printf("Trace written to %s\n", opt->trace_path);
+    }
+}
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+    if (!parse_options(argc, argv, &opt)) return EXIT_FAILURE;
+
+    if (opt.replay_path) {
+        return run_replay(&opt);
+    }
+    if (opt.num_analyze > 0) {
+        return run_analysis(&opt);
+    }
+
+    EntryList entries;
+    RaceContext race;
+    if (opt.resume_path) {
+        if (!checkpoint_load(opt.resume_path, &entries, &race)) return EXIT_FAILURE;
+        // Same state, a different future: what-if runs from a saved point
+        if (opt.has_seed) {
+            race.seed = opt.seed;
+            rng_seed(&race.rng, opt.seed);
+            race_branch_weather(&race, opt.seed);
+        }
+        if (opt.has_engine) race_set_engine(&race, opt.engine);
+        if (opt.traffic) race.traffic = true;
+        printf("Resumed %d cars at %.0f s from %s.\n", race.num_cars, race.elapsed_time, opt.resume_path);
+    } else {
+        if (opt.entries_path) {
+            if (!entry_list_load(&entries, opt.entries_path)) return EXIT_FAILURE;
         } else {
-            sprintf(state_str, "RUN");
+            entry_list_builtin(&entries);
         }
+        if (opt.num_cars > 0) entry_list_resize(&entries, opt.num_cars);
 
-        // 4. Tire
-        char tire_str[10];
-        char* tire_color = ANSI_COLOR_WHITE;
-        
-        if (is_retired) {
-            tire_color = ANSI_COLOR_GRAY;
-            sprintf(tire_str, "---");
-        } else {
-            switch(c->current_tires) {
-                case TIRE_SOFT:   sprintf(tire_str, "(S)oft"); tire_color = ANSI_COLOR_RED; break;
-                case TIRE_MEDIUM: sprintf(tire_str, "(M)edium"); tire_color = ANSI_COLOR_YELLOW; break;
-                case TIRE_HARD:   sprintf(tire_str, "(H)ard"); tire_color = ANSI_COLOR_WHITE; break;
-                case TIRE_WET:    sprintf(tire_str, "(W)et"); tire_color = ANSI_COLOR_BLUE; break;
+        if (opt.lockstep_seeds > 0) {
+            int status = run_lockstep(&entries, &opt);
+            entry_list_free(&entries);
+            return status;
+        }
+
+        if (opt.ensemble_races > 0) {
+            if (opt.lap_stats && entries.num_entries > TELEMETRY_MAX_CARS) {
+                fprintf(stderr, "Error: --lap-stats can analyse at most %d cars, the field has %d.\n",
+                        TELEMETRY_MAX_CARS, entries.num_entries);
+                entry_list_free(&entries);
+                return EXIT_FAILURE;
+            }
+            Analysis analysis;
+            if (opt.lap_stats) analysis_init(&analysis, 1);
+            uint64_t base_seed = opt.has_seed ? opt.seed : (uint64_t)time(NULL);
+            // Scenario s is the weather of seed base_seed + s, built once for every race run in it
+            WeatherTimeline* scenarios = NULL;
+            if (opt.scenarios > 0) {
+                scenarios = (WeatherTimeline*)calloc(opt.scenarios, sizeof(WeatherTimeline));
+                if (!scenarios) {
+                    fprintf(stderr, "Error: Failed to allocate weather scenarios.\n");
+                    exit(EXIT_FAILURE);
+                }
+                for (int s = 0; s < opt.scenarios; s++) weather_timeline_build(&scenarios[s], base_seed + (uint64_t)s);
             }
+            EnsembleConfig config = {
+                opt.ensemble_races, opt.threads, &entries,
+                base_seed, opt.engine, opt.traffic,
+                opt.lap_stats ? &analysis : NULL, scenarios, opt.scenarios
+            };
+            EnsembleStats stats;
+            ensemble_run(&config, &stats);
+            ensemble_print(&stats);
+            ensemble_free(&stats);
+            for (int s = 0; s < opt.scenarios; s++) weather_timeline_free(&scenarios[s]);
+            free(scenarios);
+            if (opt.lap_stats) {
+                printf("\n");
+                analysis_print(&analysis);
+                analysis_free(&analysis);
+            }
+            entry_list_free(&entries);
+            report_instrumentation(&opt);
+            return 0;
         }
 
-        // Print Row
-        // MODIFICATION ICI: %-25.25s force une largeur de 25 ET coupe si c'est plus long
-        printf("%s%-4d%s | %s%-25.25s%s | %s%-10s%s | %s%-8d%s | %s%-12s%s | %s%-10s%s | %s%-10s%s | %s%.0f%%%s\n", 
-               base_color, i + 1, ANSI_COLOR_RESET,
-               base_color, c->team_name, ANSI_COLOR_RESET,
-               cat_color, cat_str, ANSI_COLOR_RESET, 
-               base_color, c->laps_completed, ANSI_COLOR_RESET,
-               base_color, gap_str, ANSI_COLOR_RESET,
-               state_color, state_str, ANSI_COLOR_RESET,
-               tire_color, tire_str, ANSI_COLOR_RESET,
-               base_color, c->reliability, ANSI_COLOR_RESET);
+        if (opt.has_seed) race_init_seeded(&race, &entries, opt.seed);
+        else race_init(&race, &entries);
+        race_set_engine(&race, opt.engine);
+        race.traffic = opt.traffic;
     }
-}
+    race_set_threads(&race, opt.tick_threads);
 
-int main(void) {
-    RaceContext race;
-    // Request 62 cars to get the full list
-    race_init(&race, 62); 
-
-    printf("Starting Race...\n");
-    sleep(1);
-
-    // Simulation Loop
-    // Running indefinitely until user stops (Ctrl+C)
-    // or limit it: step < 1000
-    int steps = 0;
-    while(1) {
-        race_run_step(&race);
-        print_status(&race);
-        
-        // Speed of simulation
-        usleep(100000); // 0.1s delay
-        steps++;
+    if (opt.strategy_car > 0) {
+        int status = run_strategy(&race, &opt);
+        report_instrumentation(&opt);
+        race_cleanup(&race);
+        entry_list_free(&entries);
+        return status;
+    }
+
+    // The feed opens first: a recording is only started once nothing else can fail
+    FeedServer feed;
+    if (opt.feed_address && !feed_open(&feed, opt.feed_address, opt.feed_format, race.num_cars)) {
+        race_cleanup(&race);
+        entry_list_free(&entries);
+        return EXIT_FAILURE;
+    }
+    FeedServer* feed_ptr = opt.feed_address ? &feed : NULL;
+
+    TelemetryRecorder recorder;
+    if (opt.record_path) {
+        if (!telemetry_recorder_open(&recorder, opt.record_path, &race)) {
+            if (feed_ptr) feed_close(&feed);
+            race_cleanup(&race);
+            entry_list_free(&entries);
+            return EXIT_FAILURE;
+        }
+        race.recorder = &recorder;
+    }
+
+    if (feed_ptr && opt.feed_clients > 0) {
+        printf("Waiting for %d timing feed subscriber(s) on %s...\n", opt.feed_clients, opt.feed_address);
+        fflush(stdout);
+        feed_wait_clients(&feed, opt.feed_clients);
     }
 
-    printf("\nSimulation Finished.\n");
+    if (opt.headless) {
+        run_headless(&race, &opt, feed_ptr);
+    } else {
+        printf("Starting Race...\n");
+        sleep(1);
+        fflush(stdout);
+
+        run_live(&race, &opt, feed_ptr);
+        printf("\nSimulation Finished.\n");
+    }
+
+    if (feed_ptr) {
+        feed_close(&feed);
+        printf("Timing feed: %llu frames, slow subscribers resynchronized %llu times\n",
+               (unsigned long long)feed.frames, (unsigned long long)feed.coalesced);
+    }
+    if (race.recorder) {
+        telemetry_recorder_close(&recorder);
+        printf("Telemetry written to %s\n", opt.record_path);
+    }
+    report_instrumentation(&opt);
     race_cleanup(&race);
+    entry_list_free(&entries);
+    if (!opt.headless) printf("Memory cleaned up.\n");
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "pool.h"
+
+#define CACHE_LINE 64
+
+// One slice of the task range per worker, padded so owners and thieves
+// hammering different slices never share a cache line.
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_int next;
+    int end;
+} TaskSlice;
+
+typedef struct {
+    TaskSlice* slices;
+    int num_threads;
+    PoolTaskFn fn;
+    void* ctx;
+} PoolJob;
+
+typedef struct {
+    PoolJob* job;
+    int worker;
+} WorkerArgs;
+
+int pool_default_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+// Claims one task from a slice, returns -1 when the slice is exhausted
+static int slice_take(TaskSlice* slice) {
+    if (atomic_load_explicit(&slice->next, memory_order_relaxed) >= slice->end) return -1;
+    int task = atomic_fetch_add_explicit(&slice->next, 1, memory_order_relaxed);
+    return (task < slice->end) ? task : -1;
+}
+
+static void* worker_main(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    PoolJob* job = args->job;
+    int self = args->worker;
+
+    // 1. Drain our own slice
+    int task;
+    while ((task = slice_take(&job->slices[self])) >= 0) {
+        job->fn(job->ctx, task, self);
+    }
+
+    // 2. Steal from the victim with the most work left until everything is gone
+    while (1) {
+        int victim = -1;
+        int most_left = 0;
+        for (int v = 0; v < job->num_threads; v++) {
+            int left = job->slices[v].end - atomic_load_explicit(&job->slices[v].next, memory_order_relaxed);
+            if (left > most_left) {
+                most_left = left;
+                victim = v;
+            }
+        }
+        if (victim < 0) break;
+
+        task = slice_take(&job->slices[victim]);
+        if (task >= 0) job->fn(job->ctx, task, self);
+    }
+    return NULL;
+}
+
+void pool_run(int num_threads, int num_tasks, PoolTaskFn fn, void* ctx) {
+    if (num_tasks <= 0) return;
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > num_tasks) num_threads = num_tasks;
+
+    TaskSlice* slices = aligned_alloc(CACHE_LINE, num_threads * sizeof(TaskSlice));
+    pthread_t* threads = malloc(num_threads * sizeof(pthread_t));
+    WorkerArgs* args = malloc(num_threads * sizeof(WorkerArgs));
+    if (!slices || !threads || !args) {
+        fprintf(stderr, "Error: Failed to allocate thread pool.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    PoolJob job = { slices, num_threads, fn, ctx };
+
+    // Contiguous initial split, remainder spread over the first workers
+    int base = num_tasks / num_threads;
+    int extra = num_tasks % num_threads;
+    int start = 0;
+    for (int w = 0; w < num_threads; w++) {
+        int count = base + (w < extra ? 1 : 0);
+        atomic_init(&slices[w].next, start);
+        slices[w].end = start + count;
+        start += count;
+    }
+
+    // Worker 0 is the calling thread
+    for (int w = 0; w < num_threads; w++) {
+        args[w].job = &job;
+        args[w].worker = w;
+    }
+    for (int w = 1; w < num_threads; w++) {
+        if (pthread_create(&threads[w], NULL, worker_main, &args[w]) != 0) {
+            fprintf(stderr, "Error: Failed to start worker thread.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    worker_main(&args[0]);
+    for (int w = 1; w < num_threads; w++) {
+        pthread_join(threads[w], NULL);
+    }
+
+    free(args);
+    free(threads);
+    free(slices);
+}
+
+// --- PERSISTENT TEAM ---
+
+typedef struct {
+    WorkerTeam* team;
+    int worker;
+} TeamArgs;
+
+// Contiguous block of the task range owned by 'worker'
+static void team_work(WorkerTeam* team, int worker) {
+    int base = team->num_tasks / team->num_threads;
+    int extra = team->num_tasks % team->num_threads;
+    int start = worker * base + (worker < extra ? worker : extra);
+    int end = start + base + (worker < extra ? 1 : 0);
+    for (int task = start; task < end; task++) {
+        team->fn(team->ctx, task, worker);
+    }
+}
+
+static void* team_main(void* arg) {
+    TeamArgs* args = (TeamArgs*)arg;
+    WorkerTeam* team = args->team;
+    int self = args->worker;
+    free(args);
+
+    while (1) {
+        pthread_barrier_wait(&team->start);
+        if (team->quit) break;
+        team_work(team, self);
+        pthread_barrier_wait(&team->done);
+    }
+    return NULL;
+}
+
+void team_init(WorkerTeam* team, int num_threads) {
+    if (num_threads < 1) num_threads = 1;
+    team->num_threads = num_threads;
+    team->fn = NULL;
+    team->ctx = NULL;
+    team->num_tasks = 0;
+    team->quit = false;
+    team->threads = malloc(num_threads * sizeof(pthread_t));
+    if (!team->threads) {
+        fprintf(stderr, "Error: Failed to allocate worker team.\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_barrier_init(&team->start, NULL, num_threads);
+    pthread_barrier_init(&team->done, NULL, num_threads);
+
+    for (int w = 1; w < num_threads; w++) {
+        TeamArgs* args = malloc(sizeof(TeamArgs));
+        if (!args) {
+            fprintf(stderr, "Error: Failed to allocate worker team.\n");
+            exit(EXIT_FAILURE);
+        }
+        args->team = team;
+        args->worker = w;
+        if (pthread_create(&team->threads[w], NULL, team_main, args) != 0) {
+            fprintf(stderr, "Error: Failed to start worker thread.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void team_run(WorkerTeam* team, int num_tasks, PoolTaskFn fn, void* ctx) {
+    if (num_tasks <= 0) return;
+    team->fn = fn;
+    team->ctx = ctx;
+    team->num_tasks = num_tasks;
+
+    // The barriers order these writes before the workers read them, and the
+    // workers' results before our return
+    pthread_barrier_wait(&team->start);
+    team_work(team, 0);
+    pthread_barrier_wait(&team->done);
+}
+
+void team_free(WorkerTeam* team) {
+    team->quit = true;
+    pthread_barrier_wait(&team->start);
+    for (int w = 1; w < team->num_threads; w++) {
+        pthread_join(team->threads[w], NULL);
+    }
+    pthread_barrier_destroy(&team->start);
+    pthread_barrier_destroy(&team->done);
+    free(team->threads);
+    team->threads = NULL;
+}
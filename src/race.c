@@ -1,133 +1,844 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <stdatomic.h>
 #include <time.h>
 #include "race.h"
+#include "core.h"
+#include "instrument.h"
+#include "telemetry.h"
 
-// --- 2025 ENTRY LIST DATA ---
-
-typedef struct {
-    const char* team;
-    const char* driver;
-    CarCategory category;
-} RaceEntry;
-
-// Extracted from your provided 2025 Entry List PDF
-// Note: We use the first listed driver as the "Lead Driver"
-static const RaceEntry REAL_ENTRIES[] = {
-    // --- HYPERCAR ---
-    {"Aston Martin Thor Team", "Harry Tincknell", LMH},
-    {"Aston Martin Thor Team", "Alex Riberas",    LMH},
-    {"Porsche Penske",         "Felipe Nasr",     LMH},
-    {"Porsche Penske",         "Julien Andlauer", LMH},
-    {"Porsche Penske",         "Kevin Estre",     LMH},
-    {"Toyota Gazoo Racing",    "Mike Conway",     LMH},
-    {"Toyota Gazoo Racing",    "Sebastien Buemi", LMH},
-    {"Cadillac Hertz Jota",    "Will Stevens",    LMH},
-    {"Cadillac Hertz Jota",    "Earl Bamber",     LMH},
-    {"BMW M Team WRT",         "Dries Vanthoor",  LMH},
-    {"BMW M Team WRT",         "Rene Rast",       LMH},
-    {"Alpine Endurance",       "Paul-Loup Chatin",LMH},
-    {"Alpine Endurance",       "Mick Schumacher", LMH},
-    {"Ferrari AF Corse",       "Antonio Fuoco",   LMH},
-    {"Ferrari AF Corse",       "A. Pier Guidi",   LMH},
-    {"AF Corse (Yellow)",      "Robert Kubica",   LMH},
-    {"Peugeot TotalEnergies",  "Paul Di Resta",   LMH},
-    {"Peugeot TotalEnergies",  "Loic Duval",      LMH},
-    {"Proton Competition",     "Neel Jani",       LMH},
-    {"Cadillac WTR",           "Ricky Taylor",    LMH},
-    {"Cadillac Whelen",        "Jack Aitken",     LMH},
-
-    // --- LMP2 ---
-    {"Iron Lynx Proton",       "Jonas Ried",      LMP2},
-    {"Proton Competition",     "Giorgio Roda",    LMP2},
-    {"United Autosports",      "R. van der Zande",LMP2},
-    {"United Autosports",      "Daniel Schneider",LMP2},
-    {"Inter Europol",          "Jakub Smiechowski",LMP2},
-    {"IDEC Sport",             "Paul Lafargue",   LMP2},
-    {"AO by TF",               "PJ Hyett",        LMP2},
-    {"Algarve Pro Racing",     "Matthias Kaiser", LMP2},
-    {"Vector Sport",           "Ryan Cullen",     LMP2}, // Placeholder for 'Persport' in PDF likely Vector/similar
-
-    // --- LMGT3 ---
-    {"Team WRT (BMW)",         "Valentino Rossi", LMGT3},
-    {"Team WRT (BMW)",         "Yasser Shahin",   LMGT3},
-    {"Iron Dames",             "Sarah Bovy",      LMGT3},
-    {"Manthey PureRxcing",     "Antares Au",      LMGT3},
-    {"Manthey EMA",            "Ryan Hardwick",   LMGT3},
-    {"TF Sport (Corvette)",    "Tom Van Rompuy",  LMGT3},
-    {"TF Sport (Corvette)",    "Hiroshi Koizumi", LMGT3},
-    {"Vista AF Corse",         "Thomas Flohr",    LMGT3},
-    {"Vista AF Corse",         "Francois Heriau", LMGT3},
-    {"Heart of Racing",        "Ian James",       LMGT3},
-    {"Proton (Mustang)",       "Ben Tuck",        LMGT3},
-    {"Akkodis ASP (Lexus)",    "Arnold Robin",    LMGT3}
-};
-
-static const int TOTAL_ENTRIES = sizeof(REAL_ENTRIES) / sizeof(REAL_ENTRIES[0]);
-
-
-// Helper function for qsort
-int compare_cars(const void* a, const void* b) {
-    Car* carA = (Car*)a;
-    Car* carB = (Car*)b;
-
-    // 1. Sort by Laps (Descending)
-    if (carA->laps_completed > carB->laps_completed) return -1;
-    if (carA->laps_completed < carB->laps_completed) return 1;
+// Running order: true if car A is ahead of car B
+bool race_car_is_ahead(const Car* carA, const Car* carB) {
+    // 1. Sort by distance covered: Laps, then sectors into the current lap (Descending)
+    if (carA->laps_completed != carB->laps_completed) return carA->laps_completed > carB->laps_completed;
+    if (carA->current_sector != carB->current_sector) return carA->current_sector > carB->current_sector;
 
     // 2. Sort by Total Time (Ascending)
-    if (carA->total_race_time < carB->total_race_time) return -1;
-    if (carA->total_race_time > carB->total_race_time) return 1;
+    if (carA->total_race_time != carB->total_race_time) return carA->total_race_time < carB->total_race_time;
 
-    return 0;
+    // 3. Ties keep the lower car number ahead, so the order is stable
+    return carA->id < carB->id;
 }
 
-void race_init(RaceContext* race, int num_cars_to_create) {
-    if (!race) return;
-
-    // Cap the number of cars to our real data limit (or MAX_CARS)
-    if (num_cars_to_create > TOTAL_ENTRIES) {
-        num_cars_to_create = TOTAL_ENTRIES;
-        printf("Note: Capped car count to %d (number of real entries defined).\n", TOTAL_ENTRIES);
+// Bottom-up merge sort of an index array: O(cars log cars) whatever the disorder
+static void merge_sort_index(const RaceContext* race, int* index, int* scratch,
+                             bool (*before)(const RaceContext*, int, int)) {
+    int n = race->num_cars;
+    int* src = index;
+    int* dst = scratch;
+    for (int width = 1; width < n; width *= 2) {
+        for (int lo = 0; lo < n; lo += 2 * width) {
+            int mid = (lo + width < n) ? lo + width : n;
+            int hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+            int a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) {
+                dst[k++] = before(race, src[b], src[a]) ? src[b++] : src[a++];
+            }
+            while (a < mid) dst[k++] = src[a++];
+            while (b < hi) dst[k++] = src[b++];
+        }
+        int* tmp = src;
+        src = dst;
+        dst = tmp;
     }
-    if (num_cars_to_create > MAX_CARS) {
-        num_cars_to_create = MAX_CARS;
+    if (src != index) memcpy(index, src, n * sizeof(int));
+}
+
+static bool position_before(const RaceContext* race, int a, int b) {
+    return race_car_is_ahead(&race->cars[a], &race->cars[b]);
+}
+
+// Insertion sort of the position index. Only a few positions change per tick,
+// so this is O(cars + overtakes) and never moves the Car structs themselves.
+// A big reshuffle (the first laps of a huge field) would make it quadratic, so past
+// a budget of moves it hands over to the merge sort; both give the same order.
+void race_update_positions(RaceContext* race) {
+    int* order = race->order;
+    long budget = 8L * race->num_cars;
+    for (int i = 1; i < race->num_cars; i++) {
+        int idx = order[i];
+        const Car* car = &race->cars[idx];
+        int j = i;
+        while (j > 0 && race_car_is_ahead(car, &race->cars[order[j - 1]])) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = idx;
+
+        budget -= i - j;
+        if (budget < 0) {
+            merge_sort_index(race, race->order, race->order_scratch, position_before);
+            return;
+        }
     }
+}
+
+void race_update_standings(RaceContext* race) {
+    standings_update(&race->standings, race->cars, race->order, race->num_cars);
+}
+
+void race_update_gaps(RaceContext* race) {
+    if (!race->standings.gaps_stale) return;
+    standings_update_gaps(&race->standings, race->cars, race->order, race->num_cars, &race->track,
+                          race_track_clock(race), race->positions);
+}
+
+static size_t align_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+// The race's own weather timeline sits after the state in the arena: forks copy only the
+// state, and its pages are first touched when the race builds a timeline of its own
+static size_t weather_block_bytes(void) {
+    return align_up(sizeof(WeatherTimeline), 64) + align_up(weather_timeline_bytes(), 64);
+}
+
+static void place_own_weather(RaceContext* race) {
+    WeatherTimeline* tl = (WeatherTimeline*)((char*)race->arena + race->arena_bytes);
+    weather_timeline_place(tl, (char*)tl + align_up(sizeof(WeatherTimeline), 64));
+    race->own_weather = tl;
+}
+
+void race_init_seeded(RaceContext* race, const EntryList* entries, uint64_t seed) {
+    if (!race) return;
+    int num_cars = entries->num_entries;
+
+    // One block per race: each array starts on its own cache line
+    size_t cars_bytes = align_up(num_cars * sizeof(Car), 64);
+    size_t info_bytes = align_up(num_cars * sizeof(CarInfo), 64);
+    size_t order_bytes = align_up(num_cars * sizeof(int), 64);     // order + order_scratch
+    size_t draws_bytes = align_up((size_t)num_cars * CAR_DRAWS_PER_UPDATE * sizeof(uint32_t), 64);
+    size_t positions_bytes = align_up(num_cars * sizeof(TrackPosition), 64);
+    size_t dist_bytes = align_up(num_cars * sizeof(double), 64);     // ring_m, traffic_loss, green_run_from
+    int num_chunks = (num_cars + RACE_CHUNK_CARS - 1) / RACE_CHUNK_CARS;
+    size_t starts_bytes = align_up((size_t)num_chunks * (CAR_CATEGORIES + 1) * sizeof(int), 64);
+    size_t standings_block = standings_bytes(num_cars);
+    size_t total = cars_bytes + info_bytes + 2 * order_bytes + draws_bytes +
+                   positions_bytes + 3 * dist_bytes + 2 * order_bytes +    // + ring, ring_slot
+                   order_bytes + starts_bytes + standings_block;            // + category groups, standings
 
-    // Allocate memory for the cars
-    race->cars = (Car*)malloc(num_cars_to_create * sizeof(Car));
-    if (!race->cars) {
+    if (total == 0) total = 64;
+    char* arena = (char*)aligned_alloc(64, total + weather_block_bytes());
+    if (!arena) {
         fprintf(stderr, "Error: Failed to allocate memory for cars.\n");
         exit(EXIT_FAILURE);
     }
+    race->arena = arena;
+    race->arena_bytes = total;
+    race->cars = (Car*)arena;
+    race->info = (CarInfo*)(arena + cars_bytes);
+    race->order = (int*)(arena + cars_bytes + info_bytes);
+    race->order_scratch = (int*)(arena + cars_bytes + info_bytes + order_bytes);
+    race->draws = (uint32_t*)(arena + cars_bytes + info_bytes + 2 * order_bytes);
+    char* track_block = arena + cars_bytes + info_bytes + 2 * order_bytes + draws_bytes;
+    race->positions = (TrackPosition*)track_block;
+    race->ring_m = (double*)(track_block + positions_bytes);
+    race->traffic_loss = (double*)(track_block + positions_bytes + dist_bytes);
+    race->green_run_from = (double*)(track_block + positions_bytes + 2 * dist_bytes);
+    race->ring = (int*)(track_block + positions_bytes + 3 * dist_bytes);
+    race->ring_slot = (int*)(track_block + positions_bytes + 3 * dist_bytes + order_bytes);
+    race->category_index = (int*)(track_block + positions_bytes + 3 * dist_bytes + 2 * order_bytes);
+    race->category_start = (int*)(track_block + positions_bytes + 3 * dist_bytes + 3 * order_bytes);
+    char* standings_at = (char*)race->category_start + starts_bytes;
 
-    race->num_cars = num_cars_to_create;
+    race->num_cars = num_cars;
+    race->engine = ENGINE_SCALAR;
+    race->generic_update = false;
+    memset(&race->soa, 0, sizeof(race->soa));
     race->elapsed_time = 0.0;
     race->is_running = false; 
     
     race->safety_car_active = false;
     race->safety_car_timer = 0;
+    for (int s = 0; s < 3; s++) race->caution_end[s] = 0.0;
+    race->caution_mask = 0;
+    race->next_safety_car = 0.0;
 
-    race->weather = WEATHER_SUNNY;
-    race->weather_timer = 50; 
+    // Built from the seed on first use, unless the race is given a shared one first
+    place_own_weather(race);
+    race->weather = NULL;
 
-    srand(time(NULL));
+    race->seed = seed;
+    rng_seed(&race->rng, seed);
+    race->team = NULL;
+    race->recorder = NULL;
+    race->rule_car = -1;
+    race->rule = NULL;
+    race->rule_ctx = NULL;
+    track_init(&race->track);
+    race->traffic = false;
 
-    // --- POPULATE FROM REAL ENTRIES ---
-    for (int i = 0; i < num_cars_to_create; i++) {
-        const RaceEntry* entry = &REAL_ENTRIES[i];
-        
-        // Initialize the car with the specific data from our list
-        car_init(&race->cars[i], i + 1, entry->team, entry->driver, entry->category);
+    // --- POPULATE FROM THE ENTRY LIST ---
+    for (int i = 0; i < num_cars; i++) {
+        car_init(&race->cars[i], i + 1, entries->entries[i].category, &race->rng);
+        car_info_init(&race->info[i], entry_team(entries, i), entry_driver(entries, i));
+        race->order[i] = i;
+
+        // Everyone on the start line
+        race->positions[i].distance = 0.0;
+        race->positions[i].time = 0.0;
+        race->ring_m[i] = 0.0;
+        race->traffic_loss[i] = 0.0;
+        race->green_run_from[i] = -1.0;
+        race->ring[i] = i;
+        race->ring_slot[i] = i;
     }
-    
-    printf("Race initialized with %d cars from 2025 Entry List.\n", num_cars_to_create);
+
+    // Each tick chunk's cars, category by category, for the specialized kernels
+    for (int k = 0; k < num_chunks; k++) {
+        int first = k * RACE_CHUNK_CARS;
+        int last = (first + RACE_CHUNK_CARS < num_cars) ? first + RACE_CHUNK_CARS : num_cars;
+        int* start = &race->category_start[k * (CAR_CATEGORIES + 1)];
+        int next = first;
+        for (int c = 0; c < CAR_CATEGORIES; c++) {
+            start[c] = next;
+            for (int i = first; i < last; i++) {
+                if (race->cars[i].category == (CarCategory)c) race->category_index[next++] = i;
+            }
+        }
+        start[CAR_CATEGORIES] = next;
+    }
+    standings_init(&race->standings, standings_at, race->cars, num_cars);
+}
+
+void race_init(RaceContext* race, const EntryList* entries) {
+    if (!race) return;
+
+    race_init_seeded(race, entries, (uint64_t)time(NULL));
+    printf("Race initialized with %d cars from %s.\n", race->num_cars, entries->source);
+}
+
+// --- TRACK POSITIONS ---
+// The ring holds every car sorted by how far it is into its lap, so the cars around one
+// car on track are the slots next to it: a neighbour query walks outwards from the car's
+// slot and stops at the first car out of range. Cars move little between two updates,
+// so keeping the ring sorted is the same budgeted insertion sort as the running order.
+
+double race_track_clock(const RaceContext* race) {
+    if (race_has_events(race)) return race->elapsed_time;
+    double clock = 0.0;
+    for (int i = 0; i < race->num_cars; i++) {
+        if (race->cars[i].total_race_time > clock) clock = race->cars[i].total_race_time;
+    }
+    return clock;
+}
+
+static bool ring_before(const RaceContext* race, int a, int b) {
+    if (race->ring_m[a] != race->ring_m[b]) return race->ring_m[a] < race->ring_m[b];
+    return a < b;
+}
+
+void race_update_track(RaceContext* race) {
+    const Track* track = &race->track;
+    double clock = race_track_clock(race);
+    for (int i = 0; i < race->num_cars; i++) {
+        const Car* car = &race->cars[i];
+        TrackPosition pos = track_car_position(track, car, clock);
+        race->positions[i] = pos;
+
+        // A running car that has not been simulated up to 'clock' carries on at its own pace
+        double distance = pos.distance;
+        if (car->state != RETIRED && pos.time < clock) {
+            distance += (clock - pos.time) * track_car_speed(track, car);
+        }
+        race->ring_m[i] = fmod(distance, track->length_m);
+    }
+
+    // Between updates every car covers about the same share of a lap, so the ring stays
+    // in order round the circle and only the point where it wraps past the line moves.
+    // Rotating the ring to start at the biggest drop in distance puts it back into
+    // near-sorted order, and the insertion sort only has to fix the overtakes.
+    int n = race->num_cars;
+    int* ring = race->ring;
+    int wrap = 0;
+    double biggest_drop = 0.0;
+    for (int i = 1; i < n; i++) {
+        double drop = race->ring_m[ring[i - 1]] - race->ring_m[ring[i]];
+        if (drop > biggest_drop) {
+            biggest_drop = drop;
+            wrap = i;
+        }
+    }
+    if (wrap > 0) {
+        memcpy(race->order_scratch, ring, wrap * sizeof(int));
+        memmove(ring, ring + wrap, (n - wrap) * sizeof(int));
+        memcpy(ring + n - wrap, race->order_scratch, wrap * sizeof(int));
+    }
+
+    long budget = 8L * n;
+    for (int i = 1; i < n; i++) {
+        int idx = ring[i];
+        int j = i;
+        while (j > 0 && ring_before(race, idx, ring[j - 1])) {
+            ring[j] = ring[j - 1];
+            j--;
+        }
+        ring[j] = idx;
+
+        budget -= i - j;
+        if (budget < 0) {
+            merge_sort_index(race, ring, race->order_scratch, ring_before);
+            break;
+        }
+    }
+    for (int i = 0; i < n; i++) race->ring_slot[ring[i]] = i;
+}
+
+int race_cars_near(const RaceContext* race, int idx, double behind_m, double ahead_m, int* out, int max) {
+    int n = race->num_cars;
+    double length = race->track.length_m;
+    double here = race->ring_m[idx];
+    int slot = race->ring_slot[idx];
+    int count = 0;
+
+    // Each slot is visited at most once, even when the two ranges meet round the lap
+    int ahead = 1;
+    for (; ahead < n && count < max; ahead++) {
+        int other = race->ring[(slot + ahead) % n];
+        double d = race->ring_m[other] - here;
+        if (d < 0.0) d += length;
+        if (d > ahead_m) break;
+        if (race->cars[other].state != RETIRED) out[count++] = other;
+    }
+    for (int k = 1; k + ahead <= n && count < max; k++) {
+        int other = race->ring[(slot - k + n) % n];
+        double d = here - race->ring_m[other];
+        if (d < 0.0) d += length;
+        if (d > behind_m) break;
+        if (race->cars[other].state != RETIRED) out[count++] = other;
+    }
+    return count;
+}
+
+// Time each running car will lose in its next sector to the cars just ahead of it:
+// lapping a slower class costs more than following a car of the same class, and
+// a faster car coming through is assumed to pass cleanly.
+static void update_traffic(RaceContext* race) {
+    int near[16];
+    race_update_track(race);
+    for (int i = 0; i < race->num_cars; i++) {
+        const Car* car = &race->cars[i];
+        double loss = 0.0;
+        if (car->state != RETIRED) {
+            int found = race_cars_near(race, i, 0.0, TRAFFIC_RANGE_M, near, 16);
+            for (int k = 0; k < found; k++) {
+                CarCategory other = race->cars[near[k]].category;
+                if (other > car->category) loss += TRAFFIC_LOSS_SLOWER_CLASS;
+                else if (other == car->category) loss += TRAFFIC_LOSS_SAME_CLASS;
+            }
+        }
+        race->traffic_loss[i] = loss < TRAFFIC_MAX_LOSS ? loss : TRAFFIC_MAX_LOSS;
+    }
+}
+
+// Adds 'loss' to the sector car_update() has just completed
+static void add_sector_loss(Car* car, double loss) {
+    if (loss <= 0.0 || car->state == RETIRED) return;
+    int sector = (car->current_sector + 2) % 3;
+    car->sector_times[sector] += loss;
+    car->total_race_time += loss;
+    if (car->current_sector == 0) car->last_lap_time += loss;
+    else car->current_lap_time += loss;
+}
+
+// --- CAUTIONS ---
+// A caution is just the race time its sector goes green again, so raising one is a max and
+// checking one is a compare; cars see them through the mask of race_caution_at().
+
+// Adaptive engine (see below): a caution over 'sectors' from race time 'now' to 'until'. A car
+// whose run goes on past 'now' passes through each of them about once a lap, and loses
+// CAUTION_TIME each time. Only the time a caution is extended by counts; whole passes are
+// charged, and the part of one with its odds.
+static void charge_green_runs(RaceContext* race, unsigned sectors, double now, double until) {
+    for (int i = 0; i < race->num_cars; i++) {
+        Car* car = &race->cars[i];
+        double from = race->green_run_from[i];
+        if (from < 0.0 || car->state == RETIRED || car->total_race_time <= now || car->last_lap_time <= 0.0) continue;
+
+        double passes = 0.0;
+        double end = until < car->total_race_time ? until : car->total_race_time;
+        for (int s = 0; s < 3; s++) {
+            double begin = race->caution_end[s] > now ? race->caution_end[s] : now;
+            if (((sectors >> s) & 1) && end > begin) passes += (end - begin) / car->last_lap_time;
+        }
+        if (passes <= 0.0) continue;
+        int charged = (int)passes;
+        if (rng_next(&race->rng) < (passes - charged) * 4294967296.0) charged++;
+        add_sector_loss(car, charged * CAUTION_TIME);
+    }
+}
+
+// Cautions brought out by the incidents (CAR_INCIDENT_ bits) of sectors run up to race time 'now'
+static void raise_cautions(RaceContext* race, unsigned incidents, double now) {
+    if (!incidents) return;
+    bool crash = incidents & CAR_INCIDENT_CRASH;
+    unsigned sectors = crash ? CAUTION_ALL : incidents;
+    double until = now + (crash ? FULL_COURSE_YELLOW_TICKS : SLOW_ZONE_TICKS) * RACE_TICK_SECONDS;
+    if (race->engine == ENGINE_ADAPTIVE) charge_green_runs(race, sectors, now, until);
+    for (int s = 0; s < 3; s++) {
+        if (((sectors >> s) & 1) && race->caution_end[s] < until) race->caution_end[s] = until;
+    }
+    INSTR_COUNT(COUNTER_CAUTIONS, 1);
+}
+
+// --- EVENT-DRIVEN ENGINE ---
+// Instead of advancing every car once per tick, each car has one pending EVENT_SECTOR at the
+// time it starts its next sector, and race-wide changes are scheduled events too. Work is
+// only done when something happens: O(events * log cars) for a whole race.
+
+// Number of 40 s ticks until a 1-in-100-per-tick event first fires (geometric, >= 1).
+// Keeps the event engine's safety car rate equal to the fixed-step engine's.
+// The weather needs no events: every sector reads the timeline at its own start time.
+static double ticks_until_one_percent(Rng* rng) {
+    double u = (rng_next(rng) + 1.0) / 4294967296.0;   // (0, 1]
+    return 1.0 + floor(log(u) / log(0.99));
+}
+
+static void schedule_safety_car(RaceContext* race, double now) {
+    race->next_safety_car = now + ticks_until_one_percent(&race->rng) * RACE_TICK_SECONDS;
+    event_push(&race->events, race->next_safety_car, EVENT_SAFETY_CAR_OUT, -1);
+}
+
+static void start_event_engine(RaceContext* race) {
+    event_queue_init(&race->events, 2 * race->num_cars + 4);
+
+    for (int i = 0; i < race->num_cars; i++) {
+        Car* car = &race->cars[i];
+        if (car->state == RETIRED) continue;
+        double start = car->total_race_time > race->elapsed_time ? car->total_race_time : race->elapsed_time;
+        event_push(&race->events, start, EVENT_SECTOR, i);
+    }
+
+    if (race->safety_car_active) {
+        event_push(&race->events, race->elapsed_time + race->safety_car_timer * RACE_TICK_SECONDS,
+                   EVENT_SAFETY_CAR_IN, -1);
+    } else {
+        schedule_safety_car(race, race->elapsed_time);
+    }
+}
+
+// --- GREEN RUNS (adaptive engine) ---
+// On the event engine's queue, a car with nothing that needs a sector of its own in sight (its
+// next stop, the next safety car, a change of tires for the weather, the flag) is moved past
+// the green-flag sectors that lead up to it in one event (see car_advance_green). Its state is
+// at the end of that run from the start, as a sector's is on the event engine.
+// Under the safety car or a caution, and for a car under a pit rule of its own, with traffic or
+// with the sectors recorded, cars go sector by sector as on the event engine.
+// The safety car is scheduled ahead, so a run never meets it. A caution can come out while
+// a car is on a run: it is charged the slow sectors it would have passed through (see
+// charge_green_runs).
+
+static bool green_run_allowed(const RaceContext* race, int idx, double now) {
+    return !race->safety_car_active && race_caution_at(race, now) == 0 && idx != race->rule_car &&
+           !race->traffic && !race->recorder;
+}
+
+// Called with the car's sector event at the top of the queue. True if the event was taken
+// care of here; false leaves a sector to run as on the event engine.
+static bool adaptive_sector_event(RaceContext* race, int idx, double now) {
+    Car* car = &race->cars[idx];
+    RaceEvent done;
+    if (race->green_run_from[idx] >= 0.0 && car->total_race_time > now && car->state != RETIRED) {
+        // Still on its run: the cautions it met pushed the end back
+        event_replace_top(&race->events, car->total_race_time, EVENT_SECTOR, idx);
+        return true;
+    }
+    race->green_run_from[idx] = -1.0;
+    if (car->state == RETIRED) {
+        // Broke down on its run: the event was kept for the sector it stopped in. Worn out
+        // where the track is dangerous is a crash, as in car_update() (a failure leaves -10)
+        bool crash = car->reliability > -10.0 && weather_at(race->weather, now)->danger[car->current_tires] > 0.0;
+        raise_cautions(race, crash ? CAR_INCIDENT_CRASH : 1u << car->current_sector, now);
+        event_pop(&race->events, &done);
+        return true;
+    }
+    if (!green_run_allowed(race, idx, now)) return false;
+
+    double until = race->next_safety_car < TOTAL_RACE_TIME ? race->next_safety_car : TOTAL_RACE_TIME;
+    double best_lap;
+    if (car_advance_green(car, race->weather, now, until, &race->rng, &best_lap) < 0) return false;
+    race->green_run_from[idx] = now;
+    standings_add_lap(&race->standings, race->cars, idx, best_lap);
+    INSTR_COUNT(COUNTER_GREEN_RUNS, 1);
+    event_replace_top(&race->events, car->total_race_time, EVENT_SECTOR, idx);
+    return true;
+}
+
+// Called with the sector event still at the top of the queue: a car that keeps
+// running simply has its event moved to its next sector start (one sift instead of pop + push)
+static void handle_sector_event(RaceContext* race, int idx) {
+    Car* car = &race->cars[idx];
+    RaceEvent done;
+    double now = event_peek(&race->events)->time;
+    if (race->engine == ENGINE_ADAPTIVE && adaptive_sector_event(race, idx, now)) return;
+    if (car->state == RETIRED) {
+        event_pop(&race->events, &done);
+        return;
+    }
+
+    uint32_t* draws = &race->draws[idx * CAR_DRAWS_PER_UPDATE];
+    rng_fill(&race->rng, draws, CAR_DRAWS_PER_UPDATE);
+    const TrackConditions* cond = weather_at(race->weather, now);
+    unsigned caution = race_caution_at(race, now);
+    unsigned incidents;
+    int laps_before = car->laps_completed;
+    if (idx == race->rule_car) {
+        incidents = car_update_with_rule(car, 1.0, race->safety_car_active, caution, cond, draws,
+                                         race->rule, race->rule_ctx);
+    } else {
+        incidents = car_update(car, 1.0, race->safety_car_active, caution, cond, draws);
+    }
+    raise_cautions(race, incidents, now);
+    if (race->traffic) add_sector_loss(car, race->traffic_loss[idx]);
+    // The adaptive engine may not pass through the standings between two laps (race_run_until);
+    // the lap counts with the traffic it lost time in
+    if (race->engine == ENGINE_ADAPTIVE && car->laps_completed != laps_before) {
+        standings_add_lap(&race->standings, race->cars, idx, car->last_lap_time);
+    }
+    // Stamped with the event time: the race clock at which this sector was applied
+    if (race->recorder) telemetry_log_car(race->recorder, race, idx, event_peek(&race->events)->time);
+
+    if (car->state == RETIRED) {
+        event_pop(&race->events, &done);    // No further events for this car
+        return;
+    }
+
+    // car_update() folds the stop into this sector; show the car in the pits
+    // only for the last PIT_STOP_TIME seconds of it
+    if (car->state == PIT_STOP) {
+        car->state = RACING;
+        event_push(&race->events, car->total_race_time - PIT_STOP_TIME, EVENT_PIT_ENTRY, idx);
+        event_push(&race->events, car->total_race_time, EVENT_PIT_EXIT, idx);
+    }
+    event_replace_top(&race->events, car->total_race_time, EVENT_SECTOR, idx);
+}
+
+static void handle_event(RaceContext* race, const RaceEvent* ev) {
+    switch (ev->type) {
+        case EVENT_SECTOR:
+            break;  // Handled in place, see run_events_until
+        case EVENT_PIT_ENTRY:
+            if (race->cars[ev->car].state == RACING) race->cars[ev->car].state = PIT_STOP;
+            break;
+        case EVENT_PIT_EXIT:
+            if (race->cars[ev->car].state == PIT_STOP) race->cars[ev->car].state = RACING;
+            break;
+        case EVENT_SAFETY_CAR_OUT: {
+            race->safety_car_active = true;
+            race->safety_car_timer = 5 + rng_below(rng_next(&race->rng), 10);
+            event_push(&race->events, ev->time + race->safety_car_timer * RACE_TICK_SECONDS,
+                       EVENT_SAFETY_CAR_IN, -1);
+            break;
+        }
+        case EVENT_SAFETY_CAR_IN:
+            race->safety_car_active = false;
+            race->safety_car_timer = 0;
+            schedule_safety_car(race, ev->time);
+            break;
+    }
+}
+
+// Processes every event up to and including race time 'target'
+static void run_events_until(RaceContext* race, double target) {
+    const RaceEvent* next;
+    RaceEvent ev;
+    while ((next = event_peek(&race->events)) != NULL && next->time <= target) {
+        if (next->type == EVENT_SECTOR) {
+            handle_sector_event(race, next->car);
+            continue;
+        }
+        event_pop(&race->events, &ev);
+        handle_event(race, &ev);
+    }
+}
+
+void race_set_engine(RaceContext* race, RaceEngine engine) {
+    if (!race || race->engine == engine) return;
+
+    // The two event engines share the queue; a car on a run carries on from its end
+    bool had_events = race_has_events(race);
+    bool has_events = engine == ENGINE_EVENT || engine == ENGINE_ADAPTIVE;
+    if (had_events && !has_events) {
+        event_queue_free(&race->events);
+    }
+    if (has_events && !had_events) {
+        start_event_engine(race);
+    }
+    for (int i = 0; i < race->num_cars; i++) race->green_run_from[i] = -1.0;
+
+    if (engine == ENGINE_SIMD) {
+        // Build the SoA copy from the current Car state
+        if (!race->soa.fuel_level) car_soa_alloc(&race->soa, race->num_cars);
+        for (int i = 0; i < race->num_cars; i++) {
+            car_soa_load(&race->soa, i, &race->cars[i]);
+        }
+    }
+    // Switching back is free: the Car array is kept in sync after every SIMD step
+    race->engine = engine;
+}
+
+// --- FIXED-STEP TICK ---
+
+typedef struct {
+    RaceContext* race;
+    uint64_t draw_base;     // Stream index of the tick's first draw
+    atomic_uint incidents;  // Or-ed over every chunk, so the result is the same for any thread count
+} TickJob;
+
+// Cars [first, first + count) read only the race-wide flags and write only their own state
+// (and the job's incident bits, the odd time a car stops)
+static void update_cars(TickJob* job, int first, int count) {
+    RaceContext* race = job->race;
+    const TrackConditions* cond = race_conditions(race);
+    unsigned caution = race->caution_mask;
+    unsigned incidents = 0;
+    uint32_t* draws = &race->draws[first * CAR_DRAWS_PER_UPDATE];
+    rng_fill_at(&race->rng, job->draw_base + (uint64_t)first * CAR_DRAWS_PER_UPDATE,
+                draws, count * CAR_DRAWS_PER_UPDATE);
+
+    if (race->engine == ENGINE_SIMD) {
+        // A car with its own pit rule is left out of the batch (as if retired) and run scalar
+        int ruled = race->rule_car;
+        bool ruled_here = ruled >= first && ruled < first + count;
+        int32_t ruled_state = 0;
+        if (ruled_here) {
+            ruled_state = race->soa.state[ruled];
+            race->soa.state[ruled] = RETIRED;
+        }
+
+        CarSoA lanes;
+        car_soa_view(&race->soa, first, count, &lanes);
+        incidents = car_update_batch(&lanes, count, race->safety_car_active, caution, cond, draws);
+
+        if (ruled_here) {
+            race->soa.state[ruled] = ruled_state;
+            incidents |= car_update_with_rule(&race->cars[ruled], 1.0, race->safety_car_active, caution, cond,
+                                              &race->draws[ruled * CAR_DRAWS_PER_UPDATE], race->rule, race->rule_ctx);
+            car_soa_load(&race->soa, ruled, &race->cars[ruled]);
+        }
+        for (int i = first; i < first + count; i++) {
+            car_soa_store(&race->soa, i, &race->cars[i]);
+            if (race->traffic && race->traffic_loss[i] > 0.0) {
+                add_sector_loss(&race->cars[i], race->traffic_loss[i]);
+                car_soa_load(&race->soa, i, &race->cars[i]);
+            }
+        }
+    } else if (race->generic_update) {
+        for (int i = first; i < first + count; i++) {
+            const uint32_t* car_draws = &race->draws[i * CAR_DRAWS_PER_UPDATE];
+            if (i == race->rule_car) {
+                incidents |= car_update_with_rule(&race->cars[i], 1.0, race->safety_car_active, caution, cond,
+                                                  car_draws, race->rule, race->rule_ctx);
+            } else {
+                incidents |= car_update(&race->cars[i], 1.0, race->safety_car_active, caution, cond, car_draws);
+            }
+            if (race->traffic) add_sector_loss(&race->cars[i], race->traffic_loss[i]);
+        }
+    } else {
+        // One specialized kernel per category and chunk. A car with its own pit rule is
+        // parked (as if retired) while they run and takes the generic path instead.
+        int ruled = race->rule_car;
+        bool ruled_here = ruled >= first && ruled < first + count;
+        CarState ruled_state = RACING;
+        if (ruled_here) {
+            ruled_state = race->cars[ruled].state;
+            race->cars[ruled].state = RETIRED;
+        }
+
+        for (int k = first / RACE_CHUNK_CARS; k * RACE_CHUNK_CARS < first + count; k++) {
+            const int* start = &race->category_start[k * (CAR_CATEGORIES + 1)];
+            for (int c = 0; c < CAR_CATEGORIES; c++) {
+                CarKernel kernel = car_kernel((CarCategory)c, cond->wet, race->safety_car_active);
+                incidents |= kernel(race->cars, &race->category_index[start[c]], start[c + 1] - start[c],
+                                    race->draws, cond, caution);
+            }
+        }
+
+        if (ruled_here) {
+            race->cars[ruled].state = ruled_state;
+            incidents |= car_update_with_rule(&race->cars[ruled], 1.0, race->safety_car_active, caution, cond,
+                                              &race->draws[ruled * CAR_DRAWS_PER_UPDATE], race->rule, race->rule_ctx);
+        }
+        if (race->traffic) {
+            for (int i = first; i < first + count; i++) add_sector_loss(&race->cars[i], race->traffic_loss[i]);
+        }
+    }
+    if (incidents) atomic_fetch_or_explicit(&job->incidents, incidents, memory_order_relaxed);
+}
+
+static void update_chunk(void* ctx, int chunk, int worker) {
+    (void)worker;
+    INSTR_BEGIN(PHASE_CHUNK);
+    TickJob* job = (TickJob*)ctx;
+    int first = chunk * RACE_CHUNK_CARS;
+    int count = job->race->num_cars - first;
+    if (count > RACE_CHUNK_CARS) count = RACE_CHUNK_CARS;
+    update_cars(job, first, count);
+    INSTR_END(PHASE_CHUNK);
+}
+
+void race_set_threads(RaceContext* race, int num_threads) {
+    if (num_threads == 0) num_threads = pool_default_threads();
+    // No point in more threads than chunks
+    int num_chunks = (race->num_cars + RACE_CHUNK_CARS - 1) / RACE_CHUNK_CARS;
+    if (num_threads > num_chunks) num_threads = num_chunks;
+
+    if (race->team) {
+        team_free(race->team);
+        free(race->team);
+        race->team = NULL;
+    }
+    if (num_threads <= 1) return;
+
+    race->team = (WorkerTeam*)malloc(sizeof(WorkerTeam));
+    if (!race->team) {
+        fprintf(stderr, "Error: Failed to allocate worker team.\n");
+        exit(EXIT_FAILURE);
+    }
+    team_init(race->team, num_threads);
+}
+
+void race_set_pit_rule(RaceContext* race, int car, PitRule rule, void* ctx) {
+    race->rule_car = rule ? car : -1;
+    race->rule = rule;
+    race->rule_ctx = rule ? ctx : NULL;
+}
+
+// --- WEATHER ---
+
+const WeatherTimeline* race_weather(RaceContext* race) {
+    if (!race->weather) {
+        weather_timeline_build(race->own_weather, race->seed);
+        race->weather = race->own_weather;
+    }
+    return race->weather;
+}
+
+void race_set_weather(RaceContext* race, const WeatherTimeline* timeline) {
+    // Back to the race's own timeline if it has built one, else built again on first use
+    race->weather = timeline ? timeline : race->own_weather->num_slots ? race->own_weather : NULL;
+}
+
+void race_branch_weather(RaceContext* race, uint64_t seed) {
+    const WeatherTimeline* from = race_weather(race);
+    weather_timeline_branch(race->own_weather, from, race->elapsed_time, seed);
+    race->weather = race->own_weather;
+}
+
+void race_load_weather(RaceContext* race, const TrackConditions* slots) {
+    weather_timeline_load(race->own_weather, race->seed, slots);
+    race->weather = race->own_weather;
+}
+
+// --- FORKING ---
+
+// 'p' points into 'from' arena; the same offset in 'to'
+static void* rebase(const void* p, const void* from, void* to) {
+    return (char*)to + ((const char*)p - (const char*)from);
+}
+
+void race_restore(RaceContext* dst, const RaceContext* src) {
+    if (dst->arena_bytes != src->arena_bytes) {
+        fprintf(stderr, "Error: Cannot restore a race from a different field.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(dst->arena, src->arena, src->arena_bytes);
+    // The copy runs on one thread, like a clone: a team dst had is freed, not leaked
+    if (dst->team) race_set_threads(dst, 1);
+
+    // Everything else by value, keeping dst's own storage
+    void* arena = dst->arena;
+    WeatherTimeline* own_weather = dst->own_weather;
+    CarSoA soa = dst->soa;
+    EventQueue events = dst->events;
+    bool had_events = race_has_events(dst);
+    *dst = *src;
+    dst->arena = arena;
+    dst->own_weather = own_weather;     // Kept for a later branch; src's timeline is shared
+    dst->cars = (Car*)rebase(src->cars, src->arena, arena);
+    dst->order = (int*)rebase(src->order, src->arena, arena);
+    dst->order_scratch = (int*)rebase(src->order_scratch, src->arena, arena);
+    dst->info = (CarInfo*)rebase(src->info, src->arena, arena);
+    dst->draws = (uint32_t*)rebase(src->draws, src->arena, arena);
+    dst->positions = (TrackPosition*)rebase(src->positions, src->arena, arena);
+    dst->ring_m = (double*)rebase(src->ring_m, src->arena, arena);
+    dst->traffic_loss = (double*)rebase(src->traffic_loss, src->arena, arena);
+    dst->green_run_from = (double*)rebase(src->green_run_from, src->arena, arena);
+    dst->ring = (int*)rebase(src->ring, src->arena, arena);
+    dst->ring_slot = (int*)rebase(src->ring_slot, src->arena, arena);
+    dst->category_index = (int*)rebase(src->category_index, src->arena, arena);
+    dst->category_start = (int*)rebase(src->category_start, src->arena, arena);
+    Standings* st = &dst->standings;
+    st->position = (int*)rebase(src->standings.position, src->arena, arena);
+    st->class_position = (int*)rebase(src->standings.class_position, src->arena, arena);
+    st->class_order = (int*)rebase(src->standings.class_order, src->arena, arena);
+    st->gap = (double*)rebase(src->standings.gap, src->arena, arena);
+    st->interval = (double*)rebase(src->standings.interval, src->arena, arena);
+    st->class_gap = (double*)rebase(src->standings.class_gap, src->arena, arena);
+    st->best_lap = (double*)rebase(src->standings.best_lap, src->arena, arena);
+    st->laps_seen = (int*)rebase(src->standings.laps_seen, src->arena, arena);
+    st->category = (unsigned char*)rebase(src->standings.category, src->arena, arena);
+    dst->team = NULL;
+    dst->recorder = NULL;
+    race_set_pit_rule(dst, -1, NULL, NULL);
+
+    // The SoA mirrors the Car array after every step, so it is rebuilt from the copy
+    dst->soa = soa;
+    if (src->engine == ENGINE_SIMD) {
+        if (!dst->soa.fuel_level) car_soa_alloc(&dst->soa, dst->num_cars);
+        for (int i = 0; i < dst->num_cars; i++) car_soa_load(&dst->soa, i, &dst->cars[i]);
+    }
+    if (!had_events) memset(&events, 0, sizeof(events));
+    dst->events = events;
+    if (race_has_events(src)) {
+        event_queue_copy(&dst->events, &src->events);
+    } else if (had_events) {
+        event_queue_free(&dst->events);
+    }
+}
+
+void race_clone(RaceContext* dst, const RaceContext* src) {
+    memset(dst, 0, sizeof(*dst));
+    dst->arena = aligned_alloc(64, src->arena_bytes + weather_block_bytes());
+    if (!dst->arena) {
+        fprintf(stderr, "Error: Failed to allocate memory for cars.\n");
+        exit(EXIT_FAILURE);
+    }
+    dst->arena_bytes = src->arena_bytes;
+    place_own_weather(dst);
+    dst->engine = ENGINE_SCALAR;
+    race_restore(dst, src);
 }
 
 void race_run_step(RaceContext* race) {
     if (!race || !race->cars) return;
+    race_weather(race);
 
+    INSTR_BEGIN(PHASE_STEP);
+    if (race_has_events(race)) {
+        if (race->traffic) {
+            INSTR_BEGIN(PHASE_TRAFFIC);
+            update_traffic(race);
+            INSTR_END(PHASE_TRAFFIC);
+        }
+        race->elapsed_time += RACE_TICK_SECONDS;
+        INSTR_BEGIN(PHASE_EVENTS);
+        run_events_until(race, race->elapsed_time);
+        race->caution_mask = race_caution_at(race, race->elapsed_time);
+        INSTR_END(PHASE_EVENTS);
+        INSTR_BEGIN(PHASE_SORT);
+        race_update_positions(race);
+        INSTR_END(PHASE_SORT);
+        INSTR_BEGIN(PHASE_STANDINGS);
+        race_update_standings(race);
+        INSTR_END(PHASE_STANDINGS);
+        INSTR_END(PHASE_STEP);
+        return;
+    }
+
+    INSTR_BEGIN(PHASE_FLAGS);
     // --- 1. Manage Safety Car ---
     if (race->safety_car_active) {
         race->safety_car_timer--;
@@ -135,45 +846,113 @@ void race_run_step(RaceContext* race) {
             race->safety_car_active = false;
         }
     } else {
-        if ((rand() % 100) < 1) { 
+        if (rng_below(rng_next(&race->rng), 100) < 1) { 
             race->safety_car_active = true;
-            race->safety_car_timer = 5 + (rand() % 10);
+            race->safety_car_timer = 5 + rng_below(rng_next(&race->rng), 10);
         }
     }
 
-    // --- 2. Manage Weather ---
-    if (race->weather_timer > 0) {
-        race->weather_timer--;
+    // --- 2. Local cautions ---
+    // Raised by the incidents of earlier ticks; whatever is still out holds for this one
+    race->caution_mask = race_caution_at(race, race->elapsed_time);
+
+    // --- 3. Weather ---
+    // Nothing to decide: the tick runs in the timeline's conditions at the race clock
+
+    INSTR_END(PHASE_FLAGS);
+
+    if (race->traffic) {
+        INSTR_BEGIN(PHASE_TRAFFIC);
+        update_traffic(race);
+        INSTR_END(PHASE_TRAFFIC);
+    }
+
+    // --- 4. Update each car ---
+    INSTR_BEGIN(PHASE_CARS);
+    // The tick's draws are one window of the race stream, CAR_DRAWS_PER_UPDATE per car,
+    // so a chunk of cars can fill its own part without touching anyone else's.
+    TickJob job = { race, race->rng.counter, 0 };
+    race->rng.counter += (uint64_t)race->num_cars * CAR_DRAWS_PER_UPDATE;
+    if (race->team) {
+        int num_chunks = (race->num_cars + RACE_CHUNK_CARS - 1) / RACE_CHUNK_CARS;
+        team_run(race->team, num_chunks, update_chunk, &job);
     } else {
-        // Small chance to toggle weather (1%)
-        if ((rand() % 100) < 1) {
-            if (race->weather == WEATHER_SUNNY) {
-                race->weather = WEATHER_RAIN;
-                race->weather_timer = 100;
-            } else {
-                race->weather = WEATHER_SUNNY;
-                race->weather_timer = 100;
-            }
-        }
+        update_cars(&job, 0, race->num_cars);
     }
+    // Cars stopped during the tick: their cautions start with the next one
+    raise_cautions(race, atomic_load_explicit(&job.incidents, memory_order_relaxed),
+                   race->elapsed_time + RACE_TICK_SECONDS);
+    INSTR_END(PHASE_CARS);
 
-    // --- 3. Update each car ---
-    for (int i = 0; i < race->num_cars; i++) {
-        // Pass weather state (cast to int)
-        car_update(&race->cars[i], 1.0, race->safety_car_active, (int)race->weather);
+    if (race->recorder) {
+        INSTR_BEGIN(PHASE_TELEMETRY);
+        telemetry_log_tick(race->recorder, race);
+        INSTR_END(PHASE_TELEMETRY);
     }
 
-    // --- 4. Sort the grid ---
-    qsort(race->cars, race->num_cars, sizeof(Car), compare_cars);
+    // --- 5. Sort the grid ---
+    INSTR_BEGIN(PHASE_SORT);
+    race_update_positions(race);
+    INSTR_END(PHASE_SORT);
+    INSTR_BEGIN(PHASE_STANDINGS);
+    race_update_standings(race);
+    INSTR_END(PHASE_STANDINGS);
+
+    // --- 6. Update global race time ---
+    race->elapsed_time += RACE_TICK_SECONDS; 
+    INSTR_END(PHASE_STEP);
+}
+
+void race_run_until(RaceContext* race, double t) {
+    if (!race || !race->cars) return;
+    race_weather(race);
+    if (race->engine != ENGINE_ADAPTIVE || race->traffic || race->recorder) {
+        while (race->elapsed_time < t && !race_is_finished(race)) race_run_step(race);
+        return;
+    }
+
+    // Nothing looks at the race between ticks: run the events through to the last tick
+    // boundary at or past 't' and sort once
+    INSTR_BEGIN(PHASE_STEP);
+    while (race->elapsed_time < t && !race_is_finished(race)) race->elapsed_time += RACE_TICK_SECONDS;
+    INSTR_BEGIN(PHASE_EVENTS);
+    run_events_until(race, race->elapsed_time);
+    race->caution_mask = race_caution_at(race, race->elapsed_time);
+    INSTR_END(PHASE_EVENTS);
+    INSTR_BEGIN(PHASE_SORT);
+    race_update_positions(race);
+    INSTR_END(PHASE_SORT);
+    INSTR_BEGIN(PHASE_STANDINGS);
+    race_update_standings(race);
+    INSTR_END(PHASE_STANDINGS);
+    INSTR_END(PHASE_STEP);
+}
 
-    // --- 5. Update global race time ---
-    race->elapsed_time += 40.0; 
+// The race is over once the simulated clock reaches the full 24h
+bool race_is_finished(const RaceContext* race) {
+    return race->elapsed_time >= TOTAL_RACE_TIME;
 }
 
 void race_cleanup(RaceContext* race) {
-    if (race && race->cars) {
-        free(race->cars);
+    if (race && race->arena) {
+        free(race->arena);
+        if (race->soa.fuel_level) car_soa_free(&race->soa);
+        if (race_has_events(race)) event_queue_free(&race->events);
+        if (race->team) race_set_threads(race, 1);
+        race->own_weather = NULL;
+        race->weather = NULL;
+        race->arena = NULL;
         race->cars = NULL;
-        printf("Memory cleaned up.\n");
+        race->order = NULL;
+        race->order_scratch = NULL;
+        race->info = NULL;
+        race->draws = NULL;
+        race->positions = NULL;
+        race->ring_m = NULL;
+        race->traffic_loss = NULL;
+        race->green_run_from = NULL;
+        race->ring = NULL;
+        race->ring_slot = NULL;
+        memset(&race->standings, 0, sizeof(race->standings));
     }
 }
\ No newline at end of file
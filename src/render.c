@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include "render.h"
+
+// SGR sequence for each ScreenColor (all start with a reset, so they can follow any state)
+static const char* const SGR[COLOR_COUNT] = {
+    "\x1b[0m",
+    "\x1b[0;31m",
+    "\x1b[0;32m",
+    "\x1b[0;33m",
+    "\x1b[0;34m",
+    "\x1b[0;35m",
+    "\x1b[0;36m",
+    "\x1b[0;37m",
+    "\x1b[0;90m",
+    "\x1b[0;30;43m"
+};
+
+// Worst case per cell: a color change plus the longest glyph
+#define CELL_OUT_MAX (12 + 8)
+// Unchanged cells shorter than this between two changes are resent instead of
+// paying for a cursor move (which costs ~8 bytes)
+#define GAP_MERGE 6
+
+// Marks a front-buffer cell as "unknown", so it never matches a real cell
+static const ScreenCell INVALID_CELL = { {0}, 0xFF, 0xFF };
+
+static void fill_blank(ScreenCell* cells, int count) {
+    for (int i = 0; i < count; i++) {
+        memset(&cells[i], 0, sizeof(ScreenCell));
+        cells[i].glyph[0] = ' ';
+        cells[i].len = 1;
+        cells[i].color = COLOR_DEFAULT;
+    }
+}
+
+void screen_init(Screen* screen, int rows, int cols, int fd) {
+    int count = rows * cols;
+    screen->rows = rows;
+    screen->cols = cols;
+    screen->front = (ScreenCell*)malloc(count * sizeof(ScreenCell));
+    screen->back = (ScreenCell*)malloc(count * sizeof(ScreenCell));
+    // Cells plus the cursor moves between runs (at most one per GAP_MERGE cells)
+    screen->out_cap = (size_t)count * (CELL_OUT_MAX + 2) + (size_t)rows * 16 + 64;
+    screen->out = (char*)malloc(screen->out_cap);
+    if (!screen->front || !screen->back || !screen->out) {
+        fprintf(stderr, "Error: Failed to allocate screen buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+    screen->fd = fd;
+    screen->full_redraw = true;
+    screen->last_frame_bytes = 0;
+    fill_blank(screen->back, count);
+    fill_blank(screen->front, count);
+}
+
+void screen_free(Screen* screen) {
+    // Leave the terminal in a sane state: default colors, cursor visible, below the frame
+    char tail[32];
+    int n = snprintf(tail, sizeof(tail), "\x1b[0m\x1b[?25h\x1b[%d;1H\n", screen->rows);
+    if (write(screen->fd, tail, n) < 0) { /* Nothing useful to do */ }
+
+    free(screen->front);
+    free(screen->back);
+    free(screen->out);
+    memset(screen, 0, sizeof(*screen));
+}
+
+void screen_clear(Screen* screen) {
+    fill_blank(screen->back, screen->rows * screen->cols);
+}
+
+// Display width of a code point: 0 for joiners/variation selectors, 2 for emoji, else 1
+static int codepoint_width(uint32_t cp) {
+    if (cp == 0xFE0F || cp == 0xFE0E || cp == 0x200D) return 0;
+    if (cp >= 0x1F000 || (cp >= 0x2600 && cp <= 0x27BF)) return 2;
+    return 1;
+}
+
+int screen_put(Screen* screen, int row, int col, ScreenColor color, const char* text) {
+    if (row < 0 || row >= screen->rows) return col;
+    ScreenCell* line = &screen->back[row * screen->cols];
+    const unsigned char* p = (const unsigned char*)text;
+
+    while (*p) {
+        // Decode one UTF-8 sequence
+        int len = 1;
+        uint32_t cp = *p;
+        if (cp >= 0xF0) { len = 4; cp &= 0x07; }
+        else if (cp >= 0xE0) { len = 3; cp &= 0x0F; }
+        else if (cp >= 0xC0) { len = 2; cp &= 0x1F; }
+        for (int k = 1; k < len; k++) {
+            if ((p[k] & 0xC0) != 0x80) { len = k; break; }
+            cp = (cp << 6) | (p[k] & 0x3F);
+        }
+
+        int width = codepoint_width(cp);
+        if (width == 0) {
+            // Attach to the previous glyph (e.g. emoji variation selector)
+            int prev = col - 1;
+            while (prev > 0 && line[prev].len == 0) prev--;
+            if (prev >= 0 && prev < screen->cols && line[prev].len + len <= (int)sizeof(line[prev].glyph)) {
+                memcpy(line[prev].glyph + line[prev].len, p, len);
+                line[prev].len += len;
+            }
+        } else if (col >= 0 && col + width <= screen->cols) {
+            ScreenCell* cell = &line[col];
+            memset(cell, 0, sizeof(*cell));
+            memcpy(cell->glyph, p, len);
+            cell->len = len;
+            cell->color = color;
+            if (width == 2) {
+                memset(&line[col + 1], 0, sizeof(ScreenCell));
+                line[col + 1].color = color;
+            }
+            col += width;
+        } else {
+            col += width;
+        }
+        p += len;
+    }
+    return col;
+}
+
+int screen_printf(Screen* screen, int row, int col, ScreenColor color, const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return screen_put(screen, row, col, color, buf);
+}
+
+static inline bool cell_equal(const ScreenCell* a, const ScreenCell* b) {
+    return memcmp(a, b, sizeof(ScreenCell)) == 0;
+}
+
+size_t screen_present(Screen* screen) {
+    char* out = screen->out;
+    size_t n = 0;
+    int current_color = -1;
+
+    if (screen->full_redraw) {
+        static const char CLEAR[] = "\x1b[?25l\x1b[H\x1b[2J";
+        memcpy(out + n, CLEAR, sizeof(CLEAR) - 1);
+        n += sizeof(CLEAR) - 1;
+        for (int i = 0; i < screen->rows * screen->cols; i++) screen->front[i] = INVALID_CELL;
+        screen->full_redraw = false;
+    }
+
+    for (int r = 0; r < screen->rows; r++) {
+        ScreenCell* back = &screen->back[r * screen->cols];
+        ScreenCell* front = &screen->front[r * screen->cols];
+
+        // Dirty-row check: one memcmp skips the common case of an unchanged line
+        if (memcmp(back, front, screen->cols * sizeof(ScreenCell)) == 0) continue;
+
+        int c = 0;
+        while (c < screen->cols) {
+            if (cell_equal(&back[c], &front[c])) { c++; continue; }
+
+            // Start of a changed run; a continuation cell is redrawn from its lead glyph
+            int start = c;
+            while (start > 0 && back[start].len == 0) start--;
+
+            // Extend the run across short unchanged gaps
+            int end = c + 1;
+            int gap = 0;
+            for (int k = end; k < screen->cols && gap < GAP_MERGE; k++) {
+                if (cell_equal(&back[k], &front[k])) {
+                    gap++;
+                } else {
+                    gap = 0;
+                    end = k + 1;
+                }
+            }
+
+            n += (size_t)snprintf(out + n, screen->out_cap - n, "\x1b[%d;%dH", r + 1, start + 1);
+            for (int k = start; k < end; k++) {
+                const ScreenCell* cell = &back[k];
+                if (cell->len == 0) continue;   // Covered by the wide glyph before it
+                if (cell->color != current_color) {
+                    size_t sl = strlen(SGR[cell->color]);
+                    memcpy(out + n, SGR[cell->color], sl);
+                    n += sl;
+                    current_color = cell->color;
+                }
+                memcpy(out + n, cell->glyph, cell->len);
+                n += cell->len;
+            }
+            memcpy(&front[start], &back[start], (end - start) * sizeof(ScreenCell));
+            c = end;
+        }
+    }
+
+    if (n > 0) {
+        if (current_color != COLOR_DEFAULT && current_color != -1) {
+            memcpy(out + n, SGR[COLOR_DEFAULT], strlen(SGR[COLOR_DEFAULT]));
+            n += strlen(SGR[COLOR_DEFAULT]);
+        }
+        size_t sent = 0;
+        while (sent < n) {
+            ssize_t w = write(screen->fd, out + sent, n - sent);
+            if (w <= 0) break;
+            sent += (size_t)w;
+        }
+    }
+    screen->last_frame_bytes = n;
+    return n;
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snapshot.h"
+
+#define SNAPSHOT_FRESH 4    // Flag bit in 'middle': published but not yet acquired
+#define SNAPSHOT_SLOT  3    // Mask for the slot index
+
+void snapshot_alloc(RaceSnapshot* snap, int num_cars) {
+    memset(snap, 0, sizeof(*snap));
+    snap->cars = (SnapshotCar*)calloc(num_cars > 0 ? num_cars : 1, sizeof(SnapshotCar));
+    if (!snap->cars) {
+        fprintf(stderr, "Error: Failed to allocate race snapshot.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void snapshot_free(RaceSnapshot* snap) {
+    free(snap->cars);
+    memset(snap, 0, sizeof(*snap));
+}
+
+void snapshot_buffer_init(SnapshotBuffer* buf, int num_cars) {
+    memset(buf, 0, sizeof(*buf));
+    for (int i = 0; i < 3; i++) {
+        snapshot_alloc(&buf->slots[i], num_cars);
+    }
+    buf->write_slot = 0;
+    atomic_init(&buf->middle, 1);
+    buf->read_slot = 2;
+}
+
+void snapshot_buffer_free(SnapshotBuffer* buf) {
+    for (int i = 0; i < 3; i++) snapshot_free(&buf->slots[i]);
+    memset(buf, 0, sizeof(*buf));
+}
+
+bool snapshot_consumer_behind(SnapshotBuffer* buf) {
+    return (atomic_load_explicit(&buf->middle, memory_order_relaxed) & SNAPSHOT_FRESH) != 0;
+}
+
+void snapshot_capture(RaceSnapshot* snap, RaceContext* race) {
+    snap->elapsed_time = race->elapsed_time;
+    snap->conditions = *weather_at(race_weather(race), race->elapsed_time);
+    snap->safety_car_active = race->safety_car_active;
+    snap->caution_mask = race->caution_mask;
+    snap->num_cars = race->num_cars;
+    snap->info = race->info;
+
+    // Everything comparative comes straight from the standings the race keeps
+    race_update_gaps(race);
+    const Standings* st = &race->standings;
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        snap->fastest[c] = st->fastest[c] + 1;
+        snap->fastest_lap[c] = standings_class_fastest_lap(st, (CarCategory)c);
+    }
+
+    for (int pos = 0; pos < race->num_cars; pos++) {
+        int idx = race->order[pos];
+        const Car* c = &race->cars[idx];
+        SnapshotCar* out = &snap->cars[pos];
+        out->id = c->id;
+        out->category = c->category;
+        out->state = c->state;
+        out->current_tires = c->current_tires;
+        out->laps_completed = c->laps_completed;
+        out->current_sector = c->current_sector;
+        out->total_race_time = c->total_race_time;
+        out->sector_time = c->sector_times[(c->current_sector + 2) % 3];
+        out->last_lap_time = c->last_lap_time;
+        out->reliability = c->reliability;
+        out->gap = st->gap[idx];
+        out->interval = st->interval[idx];
+        out->class_gap = st->class_gap[idx];
+        out->best_lap = st->best_lap[idx];
+        out->class_position = st->class_position[idx];
+    }
+}
+
+void snapshot_publish(SnapshotBuffer* buf, RaceContext* race, bool finished) {
+    RaceSnapshot* snap = &buf->slots[buf->write_slot];
+    snapshot_capture(snap, race);
+    snap->finished = finished;
+    snap->sequence = ++buf->next_sequence;
+
+    // Hand the filled slot over and take back whichever one was in the middle.
+    // Release ordering makes the slot contents visible before the consumer can see its index.
+    int old = atomic_exchange_explicit(&buf->middle, buf->write_slot | SNAPSHOT_FRESH, memory_order_acq_rel);
+    buf->write_slot = old & SNAPSHOT_SLOT;
+}
+
+const RaceSnapshot* snapshot_acquire(SnapshotBuffer* buf) {
+    if (!(atomic_load_explicit(&buf->middle, memory_order_acquire) & SNAPSHOT_FRESH)) return NULL;
+
+    int old = atomic_exchange_explicit(&buf->middle, buf->read_slot, memory_order_acq_rel);
+    buf->read_slot = old & SNAPSHOT_SLOT;
+    return &buf->slots[buf->read_slot];
+}
@@ -0,0 +1,117 @@
+#include <string.h>
+#include "standings.h"
+
+// Eight arrays of num_cars and the categories, each on its own cache line
+size_t standings_bytes(int num_cars) {
+    size_t ints = ((size_t)num_cars * sizeof(int) + 63) & ~(size_t)63;
+    size_t doubles = ((size_t)num_cars * sizeof(double) + 63) & ~(size_t)63;
+    size_t bytes = ((size_t)num_cars + 63) & ~(size_t)63;
+    return 4 * ints + 4 * doubles + bytes;
+}
+
+void standings_init(Standings* st, void* block, const Car* cars, int num_cars) {
+    size_t ints = ((size_t)num_cars * sizeof(int) + 63) & ~(size_t)63;
+    size_t doubles = ((size_t)num_cars * sizeof(double) + 63) & ~(size_t)63;
+    char* p = (char*)block;
+    st->gap = (double*)p;
+    st->interval = (double*)(p + doubles);
+    st->class_gap = (double*)(p + 2 * doubles);
+    st->best_lap = (double*)(p + 3 * doubles);
+    p += 4 * doubles;
+    st->position = (int*)p;
+    st->class_position = (int*)(p + ints);
+    st->class_order = (int*)(p + 2 * ints);
+    st->laps_seen = (int*)(p + 3 * ints);
+    st->category = (unsigned char*)(p + 4 * ints);
+
+    int count[CAR_CATEGORIES] = {0};
+    for (int i = 0; i < num_cars; i++) {
+        st->category[i] = (unsigned char)cars[i].category;
+        count[cars[i].category]++;
+    }
+    st->class_start[0] = 0;
+    for (int c = 0; c < CAR_CATEGORIES; c++) st->class_start[c + 1] = st->class_start[c] + count[c];
+
+    int next[CAR_CATEGORIES];
+    memcpy(next, st->class_start, sizeof(next));
+    for (int i = 0; i < num_cars; i++) {
+        int k = next[cars[i].category]++;
+        st->position[i] = i;
+        st->class_order[k] = i;
+        st->class_position[i] = k - st->class_start[cars[i].category];
+        st->gap[i] = 0.0;
+        st->interval[i] = 0.0;
+        st->class_gap[i] = 0.0;
+        st->best_lap[i] = 0.0;
+        st->laps_seen[i] = cars[i].laps_completed;
+    }
+    for (int c = 0; c < CAR_CATEGORIES; c++) st->fastest[c] = -1;
+    st->fastest_overall = -1;
+    st->gaps_stale = false;     // Everyone on the line: all gaps are 0
+}
+
+// Makes 'car' the holder of its class's and the overall fastest lap if 'lap' beats them
+static void claim_fastest(Standings* st, int car, CarCategory category, double lap) {
+    if (st->fastest[category] < 0 || lap < st->best_lap[st->fastest[category]]) st->fastest[category] = car;
+    if (st->fastest_overall < 0 || lap < st->best_lap[st->fastest_overall]) st->fastest_overall = car;
+}
+
+void standings_restore_lap(Standings* st, const Car* cars, int car, double best_lap) {
+    st->laps_seen[car] = cars[car].laps_completed;
+    st->best_lap[car] = best_lap;
+    if (best_lap > 0.0) claim_fastest(st, car, cars[car].category, best_lap);
+}
+
+void standings_add_lap(Standings* st, const Car* cars, int car, double lap) {
+    if (lap <= 0.0) return;
+    if (st->best_lap[car] == 0.0 || lap < st->best_lap[car]) st->best_lap[car] = lap;
+    claim_fastest(st, car, cars[car].category, lap);
+}
+
+void standings_update(Standings* st, const Car* cars, const int* order, int num_cars) {
+    // Only small int arrays are touched in running order: walking the Car structs in
+    // running order would jump all over the field
+    int next[CAR_CATEGORIES];
+    memcpy(next, st->class_start, sizeof(next));
+    for (int p = 0; p < num_cars; p++) {
+        int i = order[p];
+        int c = st->category[i];
+        int k = next[c]++;
+        st->position[i] = p;
+        st->class_order[k] = i;
+        st->class_position[i] = k - st->class_start[c];
+    }
+
+    // A lap completed since the last pass: last_lap_time is that lap
+    for (int i = 0; i < num_cars; i++) {
+        const Car* car = &cars[i];
+        if (car->laps_completed == st->laps_seen[i]) continue;
+        st->laps_seen[i] = car->laps_completed;
+        double lap = car->last_lap_time;
+        if (lap <= 0.0) continue;
+        if (st->best_lap[i] == 0.0 || lap < st->best_lap[i]) st->best_lap[i] = lap;
+        claim_fastest(st, i, car->category, lap);
+    }
+    st->gaps_stale = true;
+}
+
+void standings_update_gaps(Standings* st, const Car* cars, const int* order, int num_cars,
+                           const Track* track, double clock, TrackPosition* positions) {
+    for (int i = 0; i < num_cars; i++) positions[i] = track_car_position(track, &cars[i], clock);
+
+    // Gaps from where the cars are, not just from their clocks
+    TrackPosition leader = {0.0, 0.0};
+    if (num_cars > 0) leader = positions[order[0]];
+    TrackPosition class_leader[CAR_CATEGORIES];
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        if (standings_class_size(st, (CarCategory)c) > 0) class_leader[c] = positions[standings_class_car(st, (CarCategory)c, 0)];
+    }
+    for (int i = 0; i < num_cars; i++) {
+        const Car* car = &cars[i];
+        int p = st->position[i];
+        st->gap[i] = track_gap(track, car, positions[i], leader);
+        st->class_gap[i] = track_gap(track, car, positions[i], class_leader[st->category[i]]);
+        st->interval[i] = (p == 0) ? 0.0 : track_gap(track, car, positions[i], positions[order[p - 1]]);
+    }
+    st->gaps_stale = false;
+}
@@ -0,0 +1,365 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "strategy.h"
+#include "pool.h"
+
+// --- CANDIDATE PLANS ---
+
+static const int FIRST_STINT_LAPS[] = { 3, 6, 9, 12, 15 };
+static const int STINT_LAPS[] = { 11, 12, 13, 14, 15 };     // A full tank lasts a little under 16
+static const TireCompound DRY_COMPOUNDS[] = { TIRE_SOFT, TIRE_MEDIUM, TIRE_HARD };
+static const int RAIN_DELAYS[] = { 0, 3 };
+
+#define COUNT_OF(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+static const char* compound_name(TireCompound tires) {
+    switch (tires) {
+        case TIRE_SOFT:   return "Soft";
+        case TIRE_MEDIUM: return "Medium";
+        case TIRE_HARD:   return "Hard";
+        case TIRE_WET:    return "Wet";
+    }
+    return "?";
+}
+
+static int build_candidates(StrategyCandidate** out) {
+    int count = COUNT_OF(FIRST_STINT_LAPS) * COUNT_OF(STINT_LAPS) * COUNT_OF(DRY_COMPOUNDS) *
+                COUNT_OF(DRY_COMPOUNDS) * COUNT_OF(RAIN_DELAYS);
+    StrategyCandidate* candidates = (StrategyCandidate*)calloc(count, sizeof(StrategyCandidate));
+    if (!candidates) {
+        fprintf(stderr, "Error: Failed to allocate strategy candidates.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int n = 0;
+    for (int a = 0; a < COUNT_OF(FIRST_STINT_LAPS); a++)
+    for (int b = 0; b < COUNT_OF(STINT_LAPS); b++)
+    for (int c = 0; c < COUNT_OF(DRY_COMPOUNDS); c++)
+    for (int d = 0; d < COUNT_OF(DRY_COMPOUNDS); d++)
+    for (int r = 0; r < COUNT_OF(RAIN_DELAYS); r++) {
+        StrategyCandidate* cand = &candidates[n++];
+        cand->plan.first_stint_laps = FIRST_STINT_LAPS[a];
+        cand->plan.stint_laps = STINT_LAPS[b];
+        cand->plan.first_compound = DRY_COMPOUNDS[c];
+        cand->plan.compound = DRY_COMPOUNDS[d];
+        cand->plan.rain_delay = RAIN_DELAYS[r];
+        cand->pruned_round = -1;
+    }
+    *out = candidates;
+    return count;
+}
+
+// --- PLAN AS A PIT RULE ---
+
+// Where a car is in its plan; one per future, owned by the thread running it
+typedef struct {
+    const StrategyPlan* plan;
+    int stops;                  // Stops made since the fork
+    int stint_start_lap;
+    int wrong_tire_sectors;
+} StrategyState;
+
+static bool strategy_pit_rule(const Car* car, bool is_raining, void* ctx, TireCompound* compound) {
+    StrategyState* st = (StrategyState*)ctx;
+    const StrategyPlan* plan = st->plan;
+
+    bool wrong_tires = is_raining ? car->current_tires != TIRE_WET : car->current_tires == TIRE_WET;
+    st->wrong_tire_sectors = wrong_tires ? st->wrong_tire_sectors + 1 : 0;
+
+    int due = (st->stops == 0) ? plan->first_stint_laps : plan->stint_laps;
+    bool pit = car->fuel_level < 5.0 || car->tire_wear > 85.0 ||   // No plan can run dry
+               car->laps_completed - st->stint_start_lap >= due ||
+               st->wrong_tire_sectors > plan->rain_delay;
+    if (!pit) return false;
+
+    if (is_raining) *compound = TIRE_WET;
+    else *compound = (st->stops == 0) ? plan->first_compound : plan->compound;
+    st->stops++;
+    st->stint_start_lap = car->laps_completed;
+    st->wrong_tire_sectors = 0;
+    return true;
+}
+
+// --- PARALLEL EVALUATION ---
+
+typedef struct {
+    int candidate;      // Index into the candidates, -1 for the baseline
+    int sample;
+} StrategyTask;
+
+typedef struct {
+    const StrategyConfig* config;
+    const StrategyCandidate* candidates;
+    const StrategyTask* tasks;
+    uint64_t base_seed;         // Of future 0: the config's in the search, after its futures in the check
+    const WeatherTimeline* weather;     // Per future, branched from the fork's
+    RaceContext* workspaces;    // One fork per worker, rewound for every task
+    double* positions;          // Per task
+    bool* dnfs;
+} StrategyJob;
+
+// Runs one future of one plan and scores the car's classified position at the flag.
+// In the fixed-step engines every car covers one sector per tick, so once the car retires
+// every car still running is already ahead of it and will stay there: its position is
+// final and the rest of the race need not be simulated. The event engines run to the flag.
+static void run_future(void* ctx, int task, int worker) {
+    StrategyJob* job = (StrategyJob*)ctx;
+    const StrategyTask* t = &job->tasks[task];
+    RaceContext* race = &job->workspaces[worker];
+    int idx = job->config->car;
+
+    race_restore(race, job->config->fork);
+    rng_seed(&race->rng, job->base_seed + (uint64_t)t->sample);
+    race_set_weather(race, &job->weather[t->sample]);
+
+    StrategyState state = { NULL, 0, 0, 0 };
+    if (t->candidate >= 0) {
+        state.plan = &job->candidates[t->candidate].plan;
+        state.stint_start_lap = race->cars[idx].laps_completed;
+        race_set_pit_rule(race, idx, strategy_pit_rule, &state);
+    }
+
+    const Car* car = &race->cars[idx];
+    if (race_has_events(race)) {
+        race_run_until(race, TOTAL_RACE_TIME);
+    } else {
+        while (!race_is_finished(race) && car->state != RETIRED) race_run_step(race);
+    }
+
+    int position = race->num_cars;
+    for (int pos = 0; pos < race->num_cars; pos++) {
+        if (race->order[pos] == idx) {
+            position = pos + 1;
+            break;
+        }
+    }
+    job->positions[task] = position;
+    job->dnfs[task] = (car->state == RETIRED);
+}
+
+static void add_sample(StrategyCandidate* c, double position, bool dnf) {
+    c->samples++;
+    c->position_sum += position;
+    c->position_sq_sum += position * position;
+    if (dnf) c->dnfs++;
+}
+
+static double candidate_mean(const StrategyCandidate* c) {
+    return c->samples > 0 ? c->position_sum / c->samples : 0.0;
+}
+
+// Standard error of the mean finishing position
+static double candidate_error(const StrategyCandidate* c) {
+    if (c->samples < 2) return 0.0;
+    double mean = candidate_mean(c);
+    double var = (c->position_sq_sum - c->samples * mean * mean) / (c->samples - 1);
+    return var > 0.0 ? sqrt(var / c->samples) : 0.0;
+}
+
+// Best first: surviving plans by mean position, then pruned ones by how long they lasted
+static int compare_candidates(const void* a, const void* b) {
+    const StrategyCandidate* x = (const StrategyCandidate*)a;
+    const StrategyCandidate* y = (const StrategyCandidate*)b;
+    int rx = x->pruned_round < 0 ? 1 << 30 : x->pruned_round;
+    int ry = y->pruned_round < 0 ? 1 << 30 : y->pruned_round;
+    if (rx != ry) return rx > ry ? -1 : 1;
+    double mx = candidate_mean(x), my = candidate_mean(y);
+    if (mx != my) return mx < my ? -1 : 1;
+    return 0;
+}
+
+// qsort() has no context argument: the candidates being ranked
+static const StrategyCandidate* sort_candidates = NULL;
+
+static int compare_alive(const void* a, const void* b) {
+    int ia = *(const int*)a, ib = *(const int*)b;
+    double ma = candidate_mean(&sort_candidates[ia]), mb = candidate_mean(&sort_candidates[ib]);
+    if (ma != mb) return ma < mb ? -1 : 1;
+    return ia - ib;
+}
+
+// After each round a plan is dropped if even its optimistic bound is behind the leader's
+// pessimistic one (two standard errors each way), then only the better half goes on to
+// twice as many futures (successive halving)
+static int prune(StrategyCandidate* candidates, int* alive, int num_alive, int round) {
+    sort_candidates = candidates;
+    qsort(alive, num_alive, sizeof(int), compare_alive);
+
+    const StrategyCandidate* best = &candidates[alive[0]];
+    double bound = candidate_mean(best) + 2.0 * candidate_error(best);
+    int keep = (num_alive + 1) / 2;
+    int kept = 0;
+    for (int i = 0; i < num_alive; i++) {
+        StrategyCandidate* c = &candidates[alive[i]];
+        if (i < keep && candidate_mean(c) - 2.0 * candidate_error(c) <= bound) {
+            alive[kept++] = alive[i];
+        } else {
+            c->pruned_round = round;
+        }
+    }
+    return kept;
+}
+
+void strategy_search(const StrategyConfig* config, StrategyResult* result) {
+    memset(result, 0, sizeof(*result));
+    result->num_candidates = build_candidates(&result->candidates);
+    result->baseline.is_baseline = true;
+    result->baseline.pruned_round = -1;
+
+    int n = result->num_candidates;
+    int num_threads = config->num_threads > 0 ? config->num_threads : pool_default_threads();
+    int num_samples = config->num_samples > 0 ? config->num_samples : 1;
+
+    int* alive = (int*)malloc(n * sizeof(int));
+    StrategyTask* tasks = (StrategyTask*)malloc((size_t)(n + 1) * num_samples * sizeof(StrategyTask));
+    double* positions = (double*)malloc((size_t)(n + 1) * num_samples * sizeof(double));
+    bool* dnfs = (bool*)malloc((size_t)(n + 1) * num_samples * sizeof(bool));
+    RaceContext* workspaces = (RaceContext*)malloc(num_threads * sizeof(RaceContext));
+    WeatherTimeline* weather = (WeatherTimeline*)calloc(num_samples, sizeof(WeatherTimeline));
+    if (!alive || !tasks || !positions || !dnfs || !workspaces || !weather) {
+        fprintf(stderr, "Error: Failed to allocate strategy search.\n");
+        exit(EXIT_FAILURE);
+    }
+    // Each worker forks once; every future after that is a copy into the same memory
+    for (int w = 0; w < num_threads; w++) race_clone(&workspaces[w], config->fork);
+    for (int i = 0; i < n; i++) alive[i] = i;
+    int num_alive = n;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    // A fork that never stepped has not built its timeline: the futures branch from its seed's
+    WeatherTimeline fork_own = { 0 };
+    const WeatherTimeline* fork_weather = config->fork->weather;
+    if (!fork_weather) {
+        weather_timeline_build(&fork_own, config->fork->seed);
+        fork_weather = &fork_own;
+    }
+
+    StrategyJob job = { config, result->candidates, tasks, config->base_seed, weather, workspaces, positions, dnfs };
+    int done = 0;
+    int target = num_samples < 2 ? num_samples : 2;
+    while (done < num_samples) {
+        // The round's new futures: their weather from the fork on
+        for (int s = done; s < target; s++) {
+            weather_timeline_branch(&weather[s], fork_weather, config->fork->elapsed_time,
+                                    config->base_seed + (uint64_t)s);
+        }
+
+        // Futures [done, target) for every surviving plan and the baseline
+        int num_tasks = 0;
+        for (int s = done; s < target; s++) {
+            tasks[num_tasks++] = (StrategyTask){ -1, s };
+            for (int i = 0; i < num_alive; i++) tasks[num_tasks++] = (StrategyTask){ alive[i], s };
+        }
+        pool_run(num_threads, num_tasks, run_future, &job);
+
+        // Accumulated in task order, so the outcome does not depend on the thread count
+        for (int k = 0; k < num_tasks; k++) {
+            StrategyCandidate* c = tasks[k].candidate < 0 ? &result->baseline
+                                                         : &result->candidates[tasks[k].candidate];
+            add_sample(c, positions[k], dnfs[k]);
+        }
+        result->races_run += num_tasks;
+        result->rounds++;
+
+        done = target;
+        target = (2 * target < num_samples) ? 2 * target : num_samples;
+        if (done < num_samples && num_alive > 1) {
+            num_alive = prune(result->candidates, alive, num_alive, result->rounds);
+        }
+    }
+    qsort(result->candidates, n, sizeof(StrategyCandidate), compare_candidates);
+
+    // The check: the pick and the baseline on as many futures again, seeded after the search's
+    job.base_seed = config->base_seed + (uint64_t)num_samples;
+    for (int s = 0; s < num_samples; s++) {
+        weather_timeline_branch(&weather[s], fork_weather, config->fork->elapsed_time,
+                                job.base_seed + (uint64_t)s);
+    }
+    int num_tasks = 0;
+    for (int s = 0; s < num_samples; s++) {
+        tasks[num_tasks++] = (StrategyTask){ -1, s };
+        tasks[num_tasks++] = (StrategyTask){ 0, s };
+    }
+    pool_run(num_threads, num_tasks, run_future, &job);
+    result->checked.plan = result->candidates[0].plan;
+    result->checked.pruned_round = -1;
+    result->checked_baseline.is_baseline = true;
+    result->checked_baseline.pruned_round = -1;
+    for (int k = 0; k < num_tasks; k++) {
+        add_sample(tasks[k].candidate < 0 ? &result->checked_baseline : &result->checked, positions[k], dnfs[k]);
+    }
+    result->races_run += num_tasks;
+    result->races_unpruned = (long)(n + 1) * num_samples + num_tasks;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    result->wall_seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    for (int w = 0; w < num_threads; w++) race_cleanup(&workspaces[w]);
+    free(workspaces);
+    for (int s = 0; s < num_samples; s++) weather_timeline_free(&weather[s]);
+    free(weather);
+    weather_timeline_free(&fork_own);
+    free(dnfs);
+    free(positions);
+    free(tasks);
+    free(alive);
+}
+
+static void print_candidate(const char* label, const StrategyCandidate* c) {
+    char plan[64];
+    if (c->is_baseline) {
+        snprintf(plan, sizeof(plan), "built-in pit rule");
+    } else {
+        snprintf(plan, sizeof(plan), "%2d laps %-6s, then %2d laps %-6s",
+                 c->plan.first_stint_laps, compound_name(c->plan.first_compound),
+                 c->plan.stint_laps, compound_name(c->plan.compound));
+    }
+    char rain[8];
+    if (c->is_baseline) snprintf(rain, sizeof(rain), "-");
+    else snprintf(rain, sizeof(rain), "%d", c->plan.rain_delay);
+
+    printf("%-5s | %-36s | %-4s | %7d | %6.2f +/- %-5.2f | %6.1f%%\n",
+           label, plan, rain, c->samples, candidate_mean(c), candidate_error(c),
+           c->samples > 0 ? 100.0 * c->dnfs / c->samples : 0.0);
+}
+
+void strategy_print(const StrategyResult* result, const RaceContext* fork, int car) {
+    printf("=== STRATEGY SEARCH: CAR #%d %s (%s) FROM %.0f s ===\n", fork->cars[car].id,
+           fork->info[car].team_name, fork->info[car].driver_name, fork->elapsed_time);
+    printf("%-5s | %-36s | %-4s | %-7s | %-15s | %-7s\n",
+           "Rank", "Stints", "Rain", "Futures", "AvgPos", "DNF");
+    printf("-------------------------------------------------------------------------------------------\n");
+
+    int shown = result->num_candidates < 10 ? result->num_candidates : 10;
+    for (int i = 0; i < shown; i++) {
+        char label[12];
+        snprintf(label, sizeof(label), "%d", i + 1);
+        print_candidate(label, &result->candidates[i]);
+    }
+    print_candidate("Base", &result->baseline);
+
+    if (result->num_candidates > 0) {
+        // The search's own means favour the pick: the gain is the one on fresh futures
+        printf("\nThe pick and the built-in rule again, on %d futures the search did not see:\n",
+               result->checked.samples);
+        print_candidate("1", &result->checked);
+        print_candidate("Base", &result->checked_baseline);
+        double gain = candidate_mean(&result->checked_baseline) - candidate_mean(&result->checked);
+        printf("\nBest plan gains %.2f positions on the built-in rule over those %d futures.\n",
+               gain, result->checked.samples);
+    }
+    printf("%d plans, %d rounds: %ld races run instead of %ld (%.0f%% pruned) in %.3f s\n",
+           result->num_candidates, result->rounds, result->races_run, result->races_unpruned,
+           result->races_unpruned > 0 ? 100.0 * (1.0 - (double)result->races_run / result->races_unpruned) : 0.0,
+           result->wall_seconds);
+}
+
+void strategy_free(StrategyResult* result) {
+    free(result->candidates);
+    memset(result, 0, sizeof(*result));
+}
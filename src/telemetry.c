@@ -0,0 +1,512 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "core.h"
+#include "telemetry.h"
+
+_Static_assert(sizeof(TelemetryRecord) == 40, "TelemetryRecord must stay 40 bytes");
+
+// --- RECORDER ---
+
+static void flush_records(TelemetryRecorder* rec) {
+    if (rec->buffered == 0) return;
+    if (rec->sink) {
+        rec->sink(rec->sink_ctx, rec->buffer, rec->buffered);
+    } else if (fwrite(rec->buffer, sizeof(TelemetryRecord), rec->buffered, rec->file) != (size_t)rec->buffered) {
+        fprintf(stderr, "Warning: Telemetry write failed, recording stopped.\n");
+        fclose(rec->file);
+        rec->file = NULL;
+    }
+    rec->records_written += rec->buffered;
+    rec->buffered = 0;
+}
+
+// What every car's record at race clock 'clock' shares: the flags, and the sectors under
+// caution (the event engine stamps a sector with its start, the time its cautions were read at)
+typedef struct {
+    uint8_t flags;
+    unsigned caution;
+} RaceFlags;
+
+static RaceFlags race_flags(const RaceContext* race, double clock) {
+    RaceFlags rf = { 0, 0 };
+    if (race->safety_car_active) rf.flags |= TLM_SAFETY_CAR;
+    if (race_conditions(race)->wet) rf.flags |= TLM_RAIN;
+    rf.caution = race_has_events(race) ? race_caution_at(race, clock) : race->caution_mask;
+    return rf;
+}
+
+static void fill_record(TelemetryRecord* r, const Car* car, double clock, uint8_t flags, RaceFlags rf) {
+    int completed = (car->current_sector + 2) % 3;
+    bool sector_done = !(flags & (TLM_START | TLM_RETIRED));
+
+    r->clock = clock;
+    r->race_time = car->total_race_time;
+    r->sector_time = sector_done ? (float)car->sector_times[completed] : 0.0f;
+    r->fuel_level = (float)car->fuel_level;
+    r->tire_wear = (float)car->tire_wear;
+    r->reliability = (float)car->reliability;
+    r->car = (uint16_t)(car->id - 1);
+    r->laps_completed = (uint16_t)car->laps_completed;
+    r->current_sector = (uint8_t)car->current_sector;
+    r->tires = (uint8_t)car->current_tires;
+    r->state = (uint8_t)car->state;
+    flags |= rf.flags;
+    if (sector_done && ((rf.caution >> completed) & 1)) flags |= TLM_CAUTION;
+    r->flags = flags;
+}
+
+static void alloc_buffers(TelemetryRecorder* rec, const RaceContext* race) {
+    rec->buffer = (TelemetryRecord*)malloc(TELEMETRY_BUFFER_RECORDS * sizeof(TelemetryRecord));
+    rec->retired_logged = (bool*)calloc(race->num_cars > 0 ? race->num_cars : 1, sizeof(bool));
+    if (!rec->buffer || !rec->retired_logged) {
+        fprintf(stderr, "Error: Failed to allocate telemetry buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Starting state, so a replay can show the grid before anyone completes a sector
+static void append_start(TelemetryRecorder* rec, RaceContext* race) {
+    race_weather(race);
+    RaceFlags rf = race_flags(race, race->elapsed_time);
+    for (int i = 0; i < race->num_cars; i++) {
+        fill_record(&rec->buffer[rec->buffered], &race->cars[i], race->elapsed_time, TLM_START, rf);
+        if (++rec->buffered == TELEMETRY_BUFFER_RECORDS) flush_records(rec);
+    }
+}
+
+bool telemetry_recorder_open(TelemetryRecorder* rec, const char* path, RaceContext* race) {
+    memset(rec, 0, sizeof(*rec));
+    if (race->num_cars > TELEMETRY_MAX_CARS) {
+        fprintf(stderr, "Error: Telemetry can record at most %d cars, the field has %d.\n",
+                TELEMETRY_MAX_CARS, race->num_cars);
+        return false;
+    }
+    rec->file = fopen(path, "wb");
+    if (!rec->file) {
+        fprintf(stderr, "Error: Cannot open telemetry file '%s'.\n", path);
+        return false;
+    }
+    alloc_buffers(rec, race);
+
+    // Names go into one string block; cars of a team usually sit next to each other
+    // in the entry list and share the same pooled pointer, so those are written once
+    int n = race->num_cars;
+    TelemetryEntry* entries = (TelemetryEntry*)calloc(n > 0 ? n : 1, sizeof(TelemetryEntry));
+    size_t strings_cap = 4096, strings_size = 0;
+    char* strings = (char*)malloc(strings_cap);
+    if (!entries || !strings) {
+        fprintf(stderr, "Error: Failed to allocate telemetry buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+    const char* last_team = NULL;
+    uint32_t last_team_offset = 0;
+    for (int i = 0; i < n; i++) {
+        const char* names[2] = { race->info[i].team_name, race->info[i].driver_name };
+        uint32_t offsets[2];
+        for (int k = 0; k < 2; k++) {
+            if (k == 0 && names[0] == last_team) {
+                offsets[0] = last_team_offset;
+                continue;
+            }
+            size_t len = strlen(names[k]) + 1;
+            if (strings_size + len > strings_cap) {
+                while (strings_size + len > strings_cap) strings_cap *= 2;
+                strings = (char*)realloc(strings, strings_cap);
+                if (!strings) {
+                    fprintf(stderr, "Error: Failed to allocate telemetry buffers.\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            memcpy(strings + strings_size, names[k], len);
+            offsets[k] = (uint32_t)strings_size;
+            strings_size += len;
+        }
+        last_team = names[0];
+        last_team_offset = offsets[0];
+        entries[i].team = offsets[0];
+        entries[i].driver = offsets[1];
+        entries[i].category = (uint8_t)race->cars[i].category;
+    }
+    size_t padded = (strings_size + 7) & ~(size_t)7;
+
+    TelemetryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+    header.version = TELEMETRY_VERSION;
+    header.header_size = sizeof(TelemetryHeader) + n * sizeof(TelemetryEntry) + padded;
+    header.seed = race->seed;
+    header.num_cars = n;
+    header.record_size = sizeof(TelemetryRecord);
+    header.engine = race->engine;
+    header.strings_size = (uint32_t)strings_size;
+    fwrite(&header, sizeof(header), 1, rec->file);
+    fwrite(entries, sizeof(TelemetryEntry), n, rec->file);
+    static const char PAD[8] = {0};
+    fwrite(strings, 1, strings_size, rec->file);
+    fwrite(PAD, 1, padded - strings_size, rec->file);
+    free(entries);
+    free(strings);
+
+    append_start(rec, race);
+    return true;
+}
+
+void telemetry_recorder_open_sink(TelemetryRecorder* rec, RaceContext* race, TelemetrySink sink, void* ctx) {
+    memset(rec, 0, sizeof(*rec));
+    rec->sink = sink;
+    rec->sink_ctx = ctx;
+    alloc_buffers(rec, race);
+    append_start(rec, race);
+}
+
+void telemetry_recorder_close(TelemetryRecorder* rec) {
+    if (rec->sink) {
+        flush_records(rec);
+    } else if (rec->file) {
+        flush_records(rec);
+        if (rec->file) fclose(rec->file);
+    }
+    free(rec->buffer);
+    free(rec->retired_logged);
+    memset(rec, 0, sizeof(*rec));
+}
+
+// Records for cars [first, end) after their sector. The buffer and its count are kept in
+// locals: the records' byte stores could otherwise alias the recorder's fields.
+static void log_cars(TelemetryRecorder* rec, const Car* cars, int first, int end, double clock, RaceFlags rf) {
+    TelemetryRecord* buffer = rec->buffer;
+    bool* retired_logged = rec->retired_logged;
+    int buffered = rec->buffered;
+    for (int i = first; i < end; i++) {
+        const Car* car = &cars[i];
+        if (retired_logged[i]) continue;
+
+        uint8_t flags = 0;
+        if (car->state == RETIRED) {
+            retired_logged[i] = true;
+            flags = TLM_RETIRED;
+        } else {
+            if (car->current_sector == 0) flags |= TLM_LAP_DONE;
+            if (car->state == PIT_STOP) flags |= TLM_PIT;
+        }
+        fill_record(&buffer[buffered], car, clock, flags, rf);
+        if (++buffered == TELEMETRY_BUFFER_RECORDS) {
+            rec->buffered = buffered;
+            flush_records(rec);
+            buffered = 0;
+        }
+    }
+    rec->buffered = buffered;
+}
+
+void telemetry_log_car(TelemetryRecorder* rec, const RaceContext* race, int idx, double clock) {
+    if (!rec->file && !rec->sink) return;
+    log_cars(rec, race->cars, idx, idx + 1, clock, race_flags(race, clock));
+}
+
+void telemetry_log_tick(TelemetryRecorder* rec, const RaceContext* race) {
+    if (!rec->file && !rec->sink) return;
+    // Tick engines log before elapsed_time advances; the tick ends one step later
+    double clock = race->elapsed_time + RACE_TICK_SECONDS;
+    log_cars(rec, race->cars, 0, race->num_cars, clock, race_flags(race, clock));
+}
+
+// --- READING ---
+
+// Header of a file this build can read, 'file_size' bytes long
+static bool header_supported(const TelemetryHeader* header, size_t file_size) {
+    return memcmp(header->magic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC)) == 0 &&
+           header->version == TELEMETRY_VERSION && header->record_size == sizeof(TelemetryRecord) &&
+           header->header_size <= file_size &&
+           header->header_size == sizeof(TelemetryHeader) + header->num_cars * sizeof(TelemetryEntry) +
+                                  ((header->strings_size + 7) & ~7u);
+}
+
+bool telemetry_reader_open(TelemetryReader* reader, const char* path) {
+    memset(reader, 0, sizeof(*reader));
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        fprintf(stderr, "Error: Cannot open telemetry file '%s'.\n", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fileno(reader->file), &st) != 0 || (size_t)st.st_size < sizeof(TelemetryHeader) ||
+        fread(&reader->header, sizeof(TelemetryHeader), 1, reader->file) != 1) {
+        fprintf(stderr, "Error: '%s' is not a telemetry file.\n", path);
+        telemetry_reader_close(reader);
+        return false;
+    }
+    if (!header_supported(&reader->header, st.st_size)) {
+        fprintf(stderr, "Error: '%s' is not a supported telemetry file.\n", path);
+        telemetry_reader_close(reader);
+        return false;
+    }
+
+    int n = reader->header.num_cars;
+    reader->categories = (unsigned char*)malloc(n > 0 ? n : 1);
+    if (!reader->categories) {
+        fprintf(stderr, "Error: Failed to allocate telemetry reader.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        TelemetryEntry entry;
+        if (fread(&entry, sizeof(entry), 1, reader->file) != 1 || entry.category >= CAR_CATEGORIES) {
+            fprintf(stderr, "Error: '%s' has a damaged entry table.\n", path);
+            telemetry_reader_close(reader);
+            return false;
+        }
+        reader->categories[i] = entry.category;
+    }
+    if (fseek(reader->file, reader->header.header_size, SEEK_SET) != 0) {
+        fprintf(stderr, "Error: Cannot read telemetry file '%s'.\n", path);
+        telemetry_reader_close(reader);
+        return false;
+    }
+    return true;
+}
+
+size_t telemetry_reader_next(TelemetryReader* reader, TelemetryRecord* out, size_t max) {
+    // A record cut short at the end of the file is left out
+    return fread(out, sizeof(TelemetryRecord), max, reader->file);
+}
+
+void telemetry_reader_close(TelemetryReader* reader) {
+    if (reader->file) fclose(reader->file);
+    free(reader->categories);
+    memset(reader, 0, sizeof(*reader));
+}
+
+// --- REPLAY ---
+
+// Lap times are not recorded, but a lap is the race time between two sector-0 crossings
+// (a grid start counts as one). Crossings further than one lap apart give no lap time.
+static void index_laps(TelemetryReplay* replay) {
+    int n = replay->header->num_cars;
+    size_t total = replay->car_start[n];
+    replay->last_lap = (double*)malloc((total + 1) * sizeof(double));
+    replay->best_lap = (double*)malloc((total + 1) * sizeof(double));
+    if (!replay->last_lap || !replay->best_lap) {
+        fprintf(stderr, "Error: Failed to allocate replay index.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < n; c++) {
+        const TelemetryRecord* crossing = NULL;
+        double last = 0.0, best = 0.0;
+        for (uint32_t k = replay->car_start[c]; k < replay->car_start[c + 1]; k++) {
+            const TelemetryRecord* r = &replay->records[replay->car_records[k]];
+            bool crossed = r->current_sector == 0 && (r->flags & (TLM_START | TLM_LAP_DONE));
+            if (crossed && (r->flags & TLM_LAP_DONE) && crossing &&
+                r->laps_completed == crossing->laps_completed + 1) {
+                last = r->race_time - crossing->race_time;
+                if (best == 0.0 || last < best) best = last;
+            }
+            if (crossed) crossing = r;
+            replay->last_lap[k] = last;
+            replay->best_lap[k] = best;
+        }
+    }
+}
+
+bool telemetry_replay_open(TelemetryReplay* replay, const char* path) {
+    memset(replay, 0, sizeof(*replay));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open telemetry file '%s'.\n", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TelemetryHeader)) {
+        fprintf(stderr, "Error: '%s' is not a telemetry file.\n", path);
+        close(fd);
+        return false;
+    }
+
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map telemetry file '%s'.\n", path);
+        return false;
+    }
+    replay->map = map;
+    replay->map_size = st.st_size;
+
+    const TelemetryHeader* header = (const TelemetryHeader*)map;
+    if (!header_supported(header, st.st_size)) {
+        fprintf(stderr, "Error: '%s' is not a supported telemetry file.\n", path);
+        telemetry_replay_close(replay);
+        return false;
+    }
+    replay->header = header;
+    replay->records = (const TelemetryRecord*)((const char*)map + header->header_size);
+    replay->num_records = (st.st_size - header->header_size) / sizeof(TelemetryRecord);
+
+    int n = header->num_cars;
+    const TelemetryEntry* entries = (const TelemetryEntry*)(header + 1);
+    replay->info = (CarInfo*)malloc(n * sizeof(CarInfo));
+    replay->categories = (CarCategory*)malloc(n * sizeof(CarCategory));
+    replay->car_start = (uint32_t*)calloc(n + 1, sizeof(uint32_t));
+    replay->car_records = (uint32_t*)malloc((replay->num_records + 1) * sizeof(uint32_t));
+    if (!replay->info || !replay->categories || !replay->car_start || !replay->car_records) {
+        fprintf(stderr, "Error: Failed to allocate replay index.\n");
+        exit(EXIT_FAILURE);
+    }
+    const char* strings = (const char*)(entries + n);
+    uint32_t strings_size = header->strings_size;
+    if (strings_size == 0 || strings[strings_size - 1] != '\0') {
+        fprintf(stderr, "Error: '%s' has a damaged name table.\n", path);
+        telemetry_replay_close(replay);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (entries[i].team >= strings_size || entries[i].driver >= strings_size) {
+            fprintf(stderr, "Error: '%s' has a damaged name table.\n", path);
+            telemetry_replay_close(replay);
+            return false;
+        }
+        if (entries[i].category >= CAR_CATEGORIES) {
+            fprintf(stderr, "Error: '%s' has a damaged entry table.\n", path);
+            telemetry_replay_close(replay);
+            return false;
+        }
+        replay->info[i].team_name = strings + entries[i].team;
+        replay->info[i].driver_name = strings + entries[i].driver;
+        replay->categories[i] = (CarCategory)entries[i].category;
+    }
+
+    // Build the per-car index in two passes (count, then place); records of a car are
+    // already in time order in the file, so each list comes out sorted.
+    for (size_t r = 0; r < replay->num_records; r++) {
+        const TelemetryRecord* rec = &replay->records[r];
+        if (rec->state > RETIRED || rec->tires > TIRE_WET) {
+            fprintf(stderr, "Error: '%s' has damaged records.\n", path);
+            telemetry_replay_close(replay);
+            return false;
+        }
+        int car = rec->car;
+        if (car < n) replay->car_start[car + 1]++;
+        if (rec->clock > replay->duration) replay->duration = rec->clock;
+    }
+    for (int c = 0; c < n; c++) replay->car_start[c + 1] += replay->car_start[c];
+
+    uint32_t* fill = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    if (!fill) {
+        fprintf(stderr, "Error: Failed to allocate replay index.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, replay->car_start, (n + 1) * sizeof(uint32_t));
+    for (size_t r = 0; r < replay->num_records; r++) {
+        int car = replay->records[r].car;
+        if (car < n) replay->car_records[fill[car]++] = (uint32_t)r;
+    }
+    free(fill);
+    index_laps(replay);
+    return true;
+}
+
+void telemetry_replay_close(TelemetryReplay* replay) {
+    if (replay->map) munmap(replay->map, replay->map_size);
+    free(replay->info);
+    free(replay->categories);
+    free(replay->car_start);
+    free(replay->car_records);
+    free(replay->last_lap);
+    free(replay->best_lap);
+    memset(replay, 0, sizeof(*replay));
+}
+
+// Running order used by the replay (same rule as the live race)
+static int compare_snapshot_cars(const void* a, const void* b) {
+    const SnapshotCar* x = (const SnapshotCar*)a;
+    const SnapshotCar* y = (const SnapshotCar*)b;
+    if (x->laps_completed != y->laps_completed) return y->laps_completed - x->laps_completed;
+    if (x->current_sector != y->current_sector) return y->current_sector - x->current_sector;
+    if (x->total_race_time != y->total_race_time) return x->total_race_time < y->total_race_time ? -1 : 1;
+    return x->id - y->id;
+}
+
+void telemetry_replay_seek(const TelemetryReplay* replay, double t, RaceSnapshot* snap) {
+    int n = replay->header->num_cars;
+    const TelemetryRecord* latest = NULL;
+
+    snap->elapsed_time = t;
+    snap->num_cars = n;
+    snap->info = replay->info;
+    snap->finished = (t >= replay->duration);
+
+    for (int c = 0; c < n; c++) {
+        SnapshotCar* out = &snap->cars[c];
+        out->id = c + 1;
+        out->category = replay->categories[c];
+
+        // Binary search: last record of this car with clock <= t
+        uint32_t lo = replay->car_start[c];
+        uint32_t hi = replay->car_start[c + 1];
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (replay->records[replay->car_records[mid]].clock <= t) lo = mid + 1;
+            else hi = mid;
+        }
+
+        if (lo == replay->car_start[c]) {
+            // Nothing recorded yet at this time: car sits on the grid
+            out->state = RACING;
+            out->current_tires = TIRE_MEDIUM;
+            out->laps_completed = 0;
+            out->current_sector = 0;
+            out->total_race_time = 0.0;
+            out->sector_time = 0.0;
+            out->last_lap_time = 0.0;
+            out->best_lap = 0.0;
+            out->reliability = 100.0;
+            continue;
+        }
+
+        const TelemetryRecord* r = &replay->records[replay->car_records[lo - 1]];
+        out->state = (CarState)r->state;
+        out->current_tires = (TireCompound)r->tires;
+        out->laps_completed = r->laps_completed;
+        out->current_sector = r->current_sector;
+        out->total_race_time = r->race_time;
+        out->sector_time = r->sector_time;
+        out->last_lap_time = replay->last_lap[lo - 1];
+        out->best_lap = replay->best_lap[lo - 1];
+        out->reliability = r->reliability;
+        if (!latest || r->clock > latest->clock) latest = r;
+    }
+
+    // Race-wide flags come from the most recent record
+    snap->safety_car_active = latest && (latest->flags & TLM_SAFETY_CAR);
+    snap->caution_mask = 0;     // Cautions are only recorded per sector run, see TLM_CAUTION
+    // Only the wet flag is recorded: no grip (0) or temperatures in a replay
+    memset(&snap->conditions, 0, sizeof(snap->conditions));
+    snap->conditions.wet = latest && (latest->flags & TLM_RAIN);
+    snap->conditions.phase = (uint8_t)weather_day_phase(weather_time_of_day(t));
+
+    qsort(snap->cars, n, sizeof(SnapshotCar), compare_snapshot_cars);
+    // Records hold sector crossings only, so gaps are crossing-time differences
+    int class_count[CAR_CATEGORIES] = {0};
+    double class_leader[CAR_CATEGORIES] = {0.0};
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        snap->fastest[c] = 0;
+        snap->fastest_lap[c] = 0.0;
+    }
+    for (int c = 0; c < n; c++) {
+        SnapshotCar* car = &snap->cars[c];
+        if (class_count[car->category] == 0) class_leader[car->category] = car->total_race_time;
+        car->class_position = class_count[car->category]++;
+        car->gap = car->total_race_time - snap->cars[0].total_race_time;
+        car->interval = (c == 0) ? 0.0 : car->total_race_time - snap->cars[c - 1].total_race_time;
+        car->class_gap = car->total_race_time - class_leader[car->category];
+        if (car->best_lap > 0.0 &&
+            (snap->fastest[car->category] == 0 || car->best_lap < snap->fastest_lap[car->category])) {
+            snap->fastest[car->category] = car->id;
+            snap->fastest_lap[car->category] = car->best_lap;
+        }
+    }
+}
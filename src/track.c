@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include "track.h"
+#include "core.h"
+
+// --- CIRCUIT DE LA SARTHE ---
+// Approximate layout, sector lengths as in core.h
+
+static const TrackSegment SARTHE[] = {
+    // --- SECTOR 1 (4.3 km) ---
+    {"Start/Finish Straight",   SEGMENT_STRAIGHT, 0,  650.0, 300.0},
+    {"Dunlop Curve",            SEGMENT_CORNER,   0,  250.0, 150.0},
+    {"Dunlop Chicane",          SEGMENT_CORNER,   0,  200.0, 100.0},
+    {"Esses",                   SEGMENT_CORNER,   0,  700.0, 170.0},
+    {"Tertre Rouge",            SEGMENT_CORNER,   0,  200.0, 140.0},
+    {"Mulsanne Straight",       SEGMENT_STRAIGHT, 0, 2300.0, 330.0},
+    // --- SECTOR 2 (5.1 km) ---
+    {"Playstation Chicane",     SEGMENT_CORNER,   1,  150.0,  90.0},
+    {"Mulsanne Straight",       SEGMENT_STRAIGHT, 1, 1800.0, 335.0},
+    {"Michelin Chicane",        SEGMENT_CORNER,   1,  150.0,  95.0},
+    {"Mulsanne Straight",       SEGMENT_STRAIGHT, 1, 1600.0, 340.0},
+    {"Mulsanne Kink",           SEGMENT_CORNER,   1,  300.0, 300.0},
+    {"Mulsanne Corner",         SEGMENT_CORNER,   1,  200.0,  80.0},
+    {"Run to Indianapolis",     SEGMENT_STRAIGHT, 1,  900.0, 320.0},
+    // --- SECTOR 3 (4.2 km) ---
+    {"Indianapolis",            SEGMENT_CORNER,   2,  300.0, 120.0},
+    {"Arnage",                  SEGMENT_CORNER,   2,  200.0,  70.0},
+    {"Run to Porsche Curves",   SEGMENT_STRAIGHT, 2, 1300.0, 310.0},
+    {"Porsche Curves",          SEGMENT_CORNER,   2, 1300.0, 190.0},
+    {"Ford Chicanes",           SEGMENT_CORNER,   2,  400.0, 100.0},
+    {"Pit Straight",            SEGMENT_STRAIGHT, 2,  700.0, 280.0}
+};
+
+static const int SARTHE_SEGMENTS = sizeof(SARTHE) / sizeof(SARTHE[0]);
+
+void track_init(Track* track) {
+    track->segments = SARTHE;
+    track->num_segments = SARTHE_SEGMENTS;
+
+    // Cumulative distances and sector boundaries
+    double distance = 0.0;
+    int sector = -1;
+    for (int i = 0; i < track->num_segments; i++) {
+        const TrackSegment* seg = &track->segments[i];
+        while (sector < seg->sector) {
+            sector++;
+            track->sector_start_m[sector] = distance;
+            track->sector_first[sector] = i;
+        }
+        track->segment_start_m[i] = distance;
+        distance += seg->length_m;
+    }
+    track->length_m = distance;
+    track->sector_start_m[3] = distance;
+    track->sector_first[3] = track->num_segments;
+
+    // Time share of each segment in its sector: length over speed, normalised per sector
+    for (int s = 0; s < 3; s++) {
+        double sector_time = 0.0;
+        for (int i = track->sector_first[s]; i < track->sector_first[s + 1]; i++) {
+            sector_time += track->segments[i].length_m / track->segments[i].speed_kmh;
+        }
+        for (int i = track->sector_first[s]; i < track->sector_first[s + 1]; i++) {
+            track->segment_time_share[i] = (track->segments[i].length_m / track->segments[i].speed_kmh) / sector_time;
+        }
+    }
+}
+
+double track_sector_distance(const Track* track, int sector, double time_fraction) {
+    if (time_fraction <= 0.0) return track->sector_start_m[sector];
+    if (time_fraction >= 1.0) return track->sector_start_m[sector + 1];
+
+    // Walk the sector's segments until the time share runs out
+    double left = time_fraction;
+    int last = track->sector_first[sector + 1] - 1;
+    for (int i = track->sector_first[sector]; i < last; i++) {
+        double share = track->segment_time_share[i];
+        if (left < share) {
+            return track->segment_start_m[i] + track->segments[i].length_m * (left / share);
+        }
+        left -= share;
+    }
+    double share = track->segment_time_share[last];
+    double part = (share > 0.0 && left < share) ? left / share : 1.0;
+    return track->segment_start_m[last] + track->segments[last].length_m * part;
+}
+
+const TrackSegment* track_segment_at(const Track* track, double lap_distance) {
+    // Binary search over the segment starts
+    int lo = 0, hi = track->num_segments - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (track->segment_start_m[mid] <= lap_distance) lo = mid;
+        else hi = mid - 1;
+    }
+    return &track->segments[lo];
+}
+
+// Distance of sector line 'line' (counted from the start, 3 per lap)
+static double line_distance(const Track* track, long line) {
+    if (line < 0) return 0.0;
+    return (line / 3) * track->length_m + track->sector_start_m[line % 3];
+}
+
+TrackPosition track_car_position(const Track* track, const Car* car, double clock) {
+    TrackPosition pos;
+    long line = (long)car->laps_completed * 3 + car->current_sector;
+    double crossed = car->total_race_time;      // When the car reaches (or reached) 'line'
+
+    pos.distance = line_distance(track, line);
+    pos.time = crossed;
+    if (car->state == RETIRED || clock >= crossed || line == 0) return pos;
+
+    // The car has been simulated to a line it only reaches after 'clock':
+    // it is somewhere in the sector before it
+    int sector = (car->current_sector + 2) % 3;
+    double sector_time = car->sector_times[sector];
+    double entered = crossed - sector_time;
+    if (sector_time <= 0.0 || clock <= entered) {
+        pos.distance = line_distance(track, line - 1);
+        pos.time = entered;
+        return pos;
+    }
+    pos.distance = line_distance(track, line - 1) +
+                   track_sector_distance(track, sector, (clock - entered) / sector_time) -
+                   track->sector_start_m[sector];
+    pos.time = clock;
+    return pos;
+}
+
+double track_car_speed(const Track* track, const Car* car) {
+    double lap_time = car->last_lap_time;
+    if (lap_time <= 0.0 && car->current_sector > 0 && car->current_lap_time > 0.0) {
+        lap_time = car->current_lap_time * 3.0 / car->current_sector;
+    }
+    if (lap_time <= 0.0) lap_time = 3.0 * RACE_TICK_SECONDS;
+    return track->length_m / lap_time;
+}
+
+double track_gap(const Track* track, const Car* behind, TrackPosition behind_pos, TrackPosition ahead_pos) {
+    return behind_pos.time + (ahead_pos.distance - behind_pos.distance) / track_car_speed(track, behind) - ahead_pos.time;
+}
@@ -0,0 +1,36 @@
+#include "utils.h"
+
+#define RNG_GAMMA 0x9E3779B97F4A7C15ULL
+
+// SplitMix64 finalizer: a strong 64-bit bijective mix
+static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint32_t draw_at(uint64_t key, uint64_t index) {
+    return (uint32_t)(mix64(key + index * RNG_GAMMA) >> 32);
+}
+
+void rng_seed(Rng* rng, uint64_t seed) {
+    // Hash the seed so that neighbouring seeds (base + i in an ensemble) give unrelated streams
+    rng->key = mix64(seed ^ 0x6A09E667F3BCC909ULL);
+    rng->counter = 0;
+}
+
+uint32_t rng_next(Rng* rng) {
+    return draw_at(rng->key, rng->counter++);
+}
+
+void rng_fill_at(const Rng* rng, uint64_t index, uint32_t* out, int n) {
+    uint64_t key = rng->key;
+    for (int i = 0; i < n; i++) {
+        out[i] = draw_at(key, index + (uint64_t)i);
+    }
+}
+
+void rng_fill(Rng* rng, uint32_t* out, int n) {
+    rng_fill_at(rng, rng->counter, out, n);
+    rng->counter += (uint64_t)n;
+}
@@ -0,0 +1,226 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "weather.h"
+#include "utils.h"
+
+// --- THE DAY ---
+// The race starts at 16:00 in mid-June
+
+#define START_HOUR      16.0
+#define SUNRISE_HOUR    5.75
+#define SUNSET_HOUR     21.75
+#define TWILIGHT_HOURS  0.75
+
+// Kept apart from the race's own stream: the same seed gives the same weather whatever
+// the engine or the field size
+#define WEATHER_STREAM  0x5BE0CD19137E2179ULL
+#define WEATHER_DRAWS   2       // Per slot: shower roll, shower intensity
+
+// --- THE PHYSICS THEY FEED ---
+// On a dry track at 30 degrees and nominal grip, and in standing water, these come out close
+// to the old fixed dry and wet tables. In between the slicks lose time and then grip with the
+// water on track, until the wets are faster.
+
+static const float SLICK_TIME[3] = { -0.5f, 0.0f, 0.6f };      // Soft, medium, hard
+static const float SLICK_HEAT[3] = { 0.02f, 0.0f, -0.015f };   // Per degree of track above 30
+static const float SLICK_WEAR[3] = { 1.2f, 1.0f, 0.7f };
+#define SLICK_WATER_TIME    25.5    // Seconds per sector on slicks in standing water
+#define WETS_DRY_TIME       3.0     // Wets overheating on a dry track ...
+#define WETS_WATER_TIME     2.0     // ... and the extra they lose in standing water
+#define WETS_DRY_WEAR       3.0
+#define GRIP_TIME           6.0     // Seconds per sector per unit of grip lost
+#define DARK_TIME           0.4     // Seconds per sector at night (half at dusk and dawn)
+#define AQUAPLANING         2.5     // Reliability lost per sector on slicks in standing water
+
+double weather_time_of_day(double t) {
+    return fmod(START_HOUR + t / 3600.0, 24.0);
+}
+
+DayPhase weather_day_phase(double hour) {
+    if (hour >= SUNSET_HOUR || hour < SUNRISE_HOUR) return TIME_NIGHT;
+    if (hour < SUNRISE_HOUR + TWILIGHT_HOURS) return TIME_DAWN;
+    if (hour >= SUNSET_HOUR - TWILIGHT_HOURS) return TIME_DUSK;
+    return TIME_DAY;
+}
+
+const char* weather_phase_name(DayPhase phase) {
+    switch (phase) {
+        case TIME_DAY:   return "Day";
+        case TIME_DUSK:  return "Dusk";
+        case TIME_NIGHT: return "Night";
+        case TIME_DAWN:  return "Dawn";
+    }
+    return "?";
+}
+
+// Height of the sun, 0 (below the horizon) .. 1 (midday)
+static double sun_height(double hour) {
+    if (hour < SUNRISE_HOUR || hour >= SUNSET_HOUR) return 0.0;
+    return sin(M_PI * (hour - SUNRISE_HOUR) / (SUNSET_HOUR - SUNRISE_HOUR));
+}
+
+static double clamp(double v, double lo, double hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Fills in what the cars read from the conditions of the slot
+static void derive_physics(TrackConditions* c) {
+    double w = c->wetness;
+    double pace = GRIP_TIME * (1.0 - c->grip);
+    if (c->phase == TIME_NIGHT) pace += DARK_TIME;
+    else if (c->phase != TIME_DAY) pace += 0.5 * DARK_TIME;
+    double heat = clamp(1.0 + 0.01 * (c->track_temp - 30.0), 0.6, 1.4);     // Hot tracks eat tires
+
+    double fastest_slick = 1e9;
+    for (int t = 0; t < 3; t++) {
+        double time = SLICK_TIME[t] + SLICK_HEAT[t] * (c->track_temp - 30.0) + SLICK_WATER_TIME * w + pace;
+        c->tire_time[t] = (float)time;
+        c->tire_wear[t] = (float)(0.8 * (SLICK_WEAR[t] * (1.0 - w) + 0.5 * w) * heat);
+        c->danger[t] = (float)(AQUAPLANING * clamp((w - 0.15) / 0.35, 0.0, 1.0));
+        if (c->tire_time[t] < fastest_slick) fastest_slick = c->tire_time[t];
+    }
+    c->tire_time[3] = (float)(WETS_DRY_TIME + WETS_WATER_TIME * w + pace);
+    c->tire_wear[3] = (float)(0.8 * (WETS_DRY_WEAR * (1.0 - w) + 1.0 * w));
+    c->danger[3] = 0.0f;
+    c->wet = c->tire_time[3] < fastest_slick;
+}
+
+// Slots [from, num_slots) from the one before 'from' (or the start of the race)
+static void generate(WeatherTimeline* tl, int from, const Rng* rng) {
+    TrackConditions prev;
+    if (from > 0) {
+        prev = tl->slots[from - 1];
+    } else {
+        // Dry, the track at its afternoon temperature, no rain for the first half hour
+        memset(&prev, 0, sizeof(prev));
+        double hour = weather_time_of_day(0.0);
+        prev.air_temp = (float)(tl->air_base + 5.0 * cos(2.0 * M_PI * (hour - 15.0) / 24.0));
+        prev.track_temp = (float)(prev.air_temp + 18.0 * sun_height(hour));
+        prev.lockout = 50;
+    }
+
+    for (int k = from; k < tl->num_slots; k++) {
+        uint32_t draws[WEATHER_DRAWS];
+        rng_fill_at(rng, (uint64_t)k * WEATHER_DRAWS, draws, WEATHER_DRAWS);
+        TrackConditions c = prev;
+
+        // Showers start and stop with a 1% chance per slot, never in quick succession
+        if (c.lockout > 0) {
+            c.lockout--;
+        } else if (rng_below(draws[0], 100) < 1) {
+            c.rain = (c.rain > 0.0f) ? 0.0f : (float)(0.25 + 0.75 * rng_below(draws[1], 1000) / 1000.0);
+            c.lockout = 100;
+        }
+
+        double hour = weather_time_of_day(k * WEATHER_SLOT_SECONDS);
+        double sun = sun_height(hour);
+        c.phase = (uint8_t)weather_day_phase(hour);
+        c.air_temp = (float)(tl->air_base + 5.0 * cos(2.0 * M_PI * (hour - 15.0) / 24.0) - 3.0 * c.rain);
+
+        // The sun heats the track, clouds and water keep it down; it follows with a lag
+        double target = c.air_temp + 18.0 * sun * (c.rain > 0.0f ? 0.2 : 1.0) * (1.0 - c.wetness);
+        c.track_temp = (float)(c.track_temp + 0.08 * (target - c.track_temp));
+
+        // Rain soaks the track; it dries faster in the sun and on a warm track
+        double w = c.wetness;
+        if (c.rain > 0.0f) w += 0.025 * c.rain;
+        else w -= 0.004 * (1.0 + sun) * (1.0 + fmax(0.0, c.track_temp - 10.0) / 25.0);
+        c.wetness = (float)clamp(w, 0.0, 1.0);
+
+        // Rubber builds up over six dry hours and is washed away by rain
+        if (c.rain > 0.0f) c.rubber = (float)(c.rubber * (1.0 - 0.01 * c.rain));
+        else if (c.wetness == 0.0f) c.rubber = (float)fmin(0.03, c.rubber + 0.03 / 540.0);
+        c.grip = (float)((1.0 + c.rubber) * (1.0 - 0.004 * fabs(c.track_temp - 35.0)));
+
+        derive_physics(&c);
+        tl->slots[k] = c;
+        prev = c;
+    }
+}
+
+static size_t slots_bytes(void) {
+    return ((size_t)WEATHER_SLOTS * sizeof(TrackConditions) + 63) & ~(size_t)63;
+}
+
+size_t weather_timeline_bytes(void) {
+    return slots_bytes() + (size_t)WEATHER_SLOTS * sizeof(int);
+}
+
+void weather_timeline_place(WeatherTimeline* tl, void* storage) {
+    memset(tl, 0, sizeof(*tl));
+    tl->slots = (TrackConditions*)storage;
+    tl->wet_change = (int*)((char*)storage + slots_bytes());
+}
+
+static void timeline_alloc(WeatherTimeline* tl) {
+    tl->num_slots = WEATHER_SLOTS;
+    if (tl->slots) return;
+    tl->slots = (TrackConditions*)malloc((size_t)tl->num_slots * sizeof(TrackConditions));
+    tl->wet_change = (int*)malloc((size_t)tl->num_slots * sizeof(int));
+    if (!tl->slots || !tl->wet_change) {
+        fprintf(stderr, "Error: Failed to allocate weather timeline.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Draws past the last slot's: the day's temperature, independent of the showers
+static float day_air_base(const Rng* rng, int num_slots) {
+    uint32_t draw;
+    rng_fill_at(rng, (uint64_t)num_slots * WEATHER_DRAWS, &draw, 1);
+    return (float)(17.0 + rng_below(draw, 80) / 10.0);
+}
+
+void weather_timeline_build(WeatherTimeline* tl, uint64_t seed) {
+    Rng rng;
+    rng_seed(&rng, seed ^ WEATHER_STREAM);
+    timeline_alloc(tl);
+    tl->seed = seed;
+    tl->air_base = day_air_base(&rng, tl->num_slots);
+    generate(tl, 0, &rng);
+    weather_timeline_index(tl);
+}
+
+void weather_timeline_load(WeatherTimeline* tl, uint64_t seed, const TrackConditions* slots) {
+    Rng rng;
+    rng_seed(&rng, seed ^ WEATHER_STREAM);
+    timeline_alloc(tl);
+    tl->seed = seed;
+    tl->air_base = day_air_base(&rng, tl->num_slots);
+    memcpy(tl->slots, slots, (size_t)tl->num_slots * sizeof(TrackConditions));
+    weather_timeline_index(tl);
+}
+
+void weather_timeline_branch(WeatherTimeline* dst, const WeatherTimeline* src, double from_time, uint64_t seed) {
+    Rng rng;
+    rng_seed(&rng, seed ^ WEATHER_STREAM);
+    timeline_alloc(dst);
+    int keep = (int)(weather_at(src, from_time) - src->slots) + 1;
+    if (dst != src) memcpy(dst->slots, src->slots, (size_t)keep * sizeof(TrackConditions));
+    dst->air_base = src->air_base;
+    dst->seed = seed;
+    generate(dst, keep, &rng);
+    weather_timeline_index(dst);
+}
+
+void weather_timeline_free(WeatherTimeline* tl) {
+    free(tl->slots);
+    free(tl->wet_change);
+    memset(tl, 0, sizeof(*tl));
+}
+
+// --- WET FLAG CHANGES ---
+
+void weather_timeline_index(WeatherTimeline* tl) {
+    int change = tl->num_slots;
+    for (int k = tl->num_slots - 1; k >= 0; k--) {
+        tl->wet_change[k] = change;
+        if (k > 0 && tl->slots[k - 1].wet != tl->slots[k].wet) change = k;
+    }
+}
+
+double weather_wet_change(const WeatherTimeline* tl, double t) {
+    int change = tl->wet_change[weather_at(tl, t) - tl->slots];
+    return change < tl->num_slots ? change * WEATHER_SLOT_SECONDS : HUGE_VAL;
+}
@@ -0,0 +1,29 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "race.h"
+
+// --- TEST CHECKS ---
+// Every tests/test_*.c is a program of its own, run by 'make test' (see the Makefile).
+// A failed check prints where and what, and the program exits non-zero at once.
+
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__);            \
+            fprintf(stderr, __VA_ARGS__);                                   \
+            fprintf(stderr, "\n");                                          \
+            exit(EXIT_FAILURE);                                             \
+        }                                                                   \
+    } while (0)
+
+// --- ENGINES ---
+// Every engine, for the tests that check a property on each of them
+
+static const RaceEngine ENGINES[] = { ENGINE_SCALAR, ENGINE_SIMD, ENGINE_EVENT, ENGINE_ADAPTIVE };
+static const char* const ENGINE_NAMES[] = { "scalar", "simd", "event", "adaptive" };
+#define NUM_ENGINES (int)(sizeof(ENGINES) / sizeof(ENGINES[0]))
+
+#endif
@@ -0,0 +1,138 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "race.h"
+#include "entries.h"
+#include "test.h"
+
+// The adaptive engine against the event engine it stands in for, in distribution. The same
+// seeds (so the same weather) run through both; each race gives the mean laps of the finishers
+// of each class, the mean pit stops per car and the retirements, and the two engines' races
+// are compared by mean (paired by seed), by spread and by a two-sample Kolmogorov-Smirnov test.
+// One value per race: the cars of a race share its weather, so they are not independent draws.
+// The races are stepped tick by tick to see the stops; race_run_until() runs the same race.
+
+#define NUM_RACES   100
+#define NUM_STATS   (CAR_CATEGORIES + 2)    // Finisher laps per class, stops per car, retirements
+
+#define MEAN_LIMIT   4.0    // Standard errors the mean difference may reach
+#define SPREAD_LIMIT 0.35   // Relative difference the standard deviations may show
+#define KS_C         1.95   // Kolmogorov-Smirnov critical coefficient, 0.1% level
+
+static const char* const STAT_NAMES[NUM_STATS] = {
+    "HYPER finisher laps", "LMP2 finisher laps", "LMGT3 finisher laps", "pit stops per car", "retirements"
+};
+
+// Fills stats[k * NUM_RACES] for each statistic k of race 'race_index'
+static void run_race(const EntryList* entries, RaceEngine engine, int race_index, double* stats) {
+    RaceContext race;
+    race_init_seeded(&race, entries, (uint64_t)race_index + 1);
+    race_set_engine(&race, engine);
+
+    int* stops = calloc((size_t)race.num_cars, sizeof(int));
+    CarState* seen = malloc((size_t)race.num_cars * sizeof(CarState));
+    CHECK(stops && seen, "out of memory");
+    for (int i = 0; i < race.num_cars; i++) seen[i] = race.cars[i].state;
+    // A stop shows as PIT_STOP for its last PIT_STOP_TIME seconds, longer than a tick,
+    // so every stop is seen at one tick boundary at least
+    while (!race_is_finished(&race)) {
+        race_run_step(&race);
+        for (int i = 0; i < race.num_cars; i++) {
+            CarState state = race.cars[i].state;
+            if (state == PIT_STOP && seen[i] != PIT_STOP) stops[i]++;
+            seen[i] = state;
+        }
+    }
+
+    double laps[CAR_CATEGORIES] = { 0 };
+    int finishers[CAR_CATEGORIES] = { 0 };
+    int retired = 0, total_stops = 0;
+    for (int i = 0; i < race.num_cars; i++) {
+        const Car* car = &race.cars[i];
+        if (car->state == RETIRED) {
+            retired++;
+        } else {
+            laps[car->category] += car->laps_completed;
+            finishers[car->category]++;
+        }
+        total_stops += stops[i];
+    }
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        CHECK(finishers[c] > 0, "race %d: no finisher in class %d", race_index + 1, c);
+        stats[c * NUM_RACES + race_index] = laps[c] / finishers[c];
+    }
+    stats[CAR_CATEGORIES * NUM_RACES + race_index] = (double)total_stops / race.num_cars;
+    stats[(CAR_CATEGORIES + 1) * NUM_RACES + race_index] = retired;
+    free(stops);
+    free(seen);
+    race_cleanup(&race);
+}
+
+static void mean_sd(const double* v, int n, double* mean, double* sd) {
+    double sum = 0.0, sq = 0.0;
+    for (int i = 0; i < n; i++) sum += v[i];
+    *mean = sum / n;
+    for (int i = 0; i < n; i++) sq += (v[i] - *mean) * (v[i] - *mean);
+    *sd = sqrt(sq / (n - 1));
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Largest gap between the two empirical distribution functions (ties stepped over together)
+// (sorts both)
+static double ks_distance(double* a, double* b, int n) {
+    qsort(a, (size_t)n, sizeof(double), compare_double);
+    qsort(b, (size_t)n, sizeof(double), compare_double);
+    double d = 0.0;
+    int i = 0, j = 0;
+    while (i < n && j < n) {
+        double v = a[i] < b[j] ? a[i] : b[j];
+        while (i < n && a[i] == v) i++;
+        while (j < n && b[j] == v) j++;
+        double gap = fabs((double)(i - j) / n);
+        if (gap > d) d = gap;
+    }
+    return d;
+}
+
+int main(void) {
+    EntryList entries;
+    entry_list_init(&entries);
+    entry_list_builtin(&entries);
+
+    static double event[NUM_STATS * NUM_RACES], adaptive[NUM_STATS * NUM_RACES];
+    for (int r = 0; r < NUM_RACES; r++) {
+        run_race(&entries, ENGINE_EVENT, r, event);
+        run_race(&entries, ENGINE_ADAPTIVE, r, adaptive);
+    }
+
+    for (int k = 0; k < NUM_STATS; k++) {
+        double* a = &event[k * NUM_RACES];
+        double* b = &adaptive[k * NUM_RACES];
+        double diff[NUM_RACES];
+        for (int r = 0; r < NUM_RACES; r++) diff[r] = b[r] - a[r];
+        double mean_a, sd_a, mean_b, sd_b, mean_diff, sd_diff;
+        mean_sd(a, NUM_RACES, &mean_a, &sd_a);
+        mean_sd(b, NUM_RACES, &mean_b, &sd_b);
+        mean_sd(diff, NUM_RACES, &mean_diff, &sd_diff);
+        double z = mean_diff / (sd_diff / sqrt(NUM_RACES));
+        double spread = sd_b / sd_a - 1.0;
+        double d = ks_distance(a, b, NUM_RACES);
+        double d_limit = KS_C * sqrt(2.0 / NUM_RACES);
+        printf("test_adaptive: %-19s event %7.2f sd %5.2f | adaptive %7.2f sd %5.2f | "
+               "%+5.2f se, sd %+5.1f%%, ks %.2f (< %.2f)\n",
+               STAT_NAMES[k], mean_a, sd_a, mean_b, sd_b, z, spread * 100.0, d, d_limit);
+        CHECK(fabs(z) < MEAN_LIMIT, "%s: adaptive mean %.3f vs event %.3f, %+.2f standard errors",
+              STAT_NAMES[k], mean_b, mean_a, z);
+        CHECK(fabs(spread) < SPREAD_LIMIT, "%s: adaptive sd %.3f vs event %.3f",
+              STAT_NAMES[k], sd_b, sd_a);
+        CHECK(d < d_limit, "%s: Kolmogorov-Smirnov distance %.2f, limit %.2f", STAT_NAMES[k], d, d_limit);
+    }
+    printf("test_adaptive: adaptive matches event over %d races\n", NUM_RACES);
+    entry_list_free(&entries);
+    return 0;
+}
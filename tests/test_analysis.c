@@ -0,0 +1,175 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "analysis.h"
+#include "utils.h"
+#include "test.h"
+
+// The lap analysis' quantile sketches against an exact sort. A synthetic race is recorded
+// sector by sector with laps that are clean (dry or wet), run partly wet, run under a caution
+// or end in a stop, so the laps and pit losses that must reach the sketches are known. The
+// records go through 1 and 3 workers, in more than one chunk, and are merged into one set of
+// totals; every quantile must be within the sketch's 0.1% of the exact one.
+
+#define NUM_CARS    30
+#define NUM_LAPS    400     // Per car: 36000 sector records, so the race spans two chunks
+#define SKETCH_ERROR 0.001
+
+static const double QUANTILES[] = { 0.0, 0.05, 0.25, 0.5, 0.75, 0.95, 1.0 };
+#define NUM_QUANTILES (int)(sizeof(QUANTILES) / sizeof(QUANTILES[0]))
+
+typedef struct {
+    float* values;
+    int count;
+} Exact;
+
+typedef struct {
+    Exact pace[CAR_CATEGORIES][2];
+    Exact pit_loss[CAR_CATEGORIES];
+    TelemetryRecord* records;
+    size_t num_records;
+    unsigned char categories[NUM_CARS];
+} Race;
+
+static void exact_add(Exact* e, float v) {
+    e->values[e->count++] = v;
+}
+
+static TelemetryRecord* next_record(Race* race, int car) {
+    TelemetryRecord* rec = &race->records[race->num_records++];
+    memset(rec, 0, sizeof(*rec));
+    rec->car = (uint16_t)car;
+    rec->state = RACING;
+    rec->tires = TIRE_MEDIUM;
+    return rec;
+}
+
+static void record_race(Race* race) {
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        for (int w = 0; w < 2; w++) race->pace[c][w].values = malloc(NUM_CARS * NUM_LAPS * sizeof(float));
+        race->pit_loss[c].values = malloc(NUM_CARS * NUM_LAPS * sizeof(float));
+    }
+    race->records = malloc((size_t)NUM_CARS * (NUM_LAPS * 3 + 1) * sizeof(TelemetryRecord));
+    CHECK(race->records != NULL, "out of memory");
+
+    // Last green time through each sector and whether it was wet, as the analysis keeps them
+    float last_green[NUM_CARS][3];
+    bool green_wet[NUM_CARS][3];
+    float lap_time[NUM_CARS];
+    int kind[NUM_CARS];
+    memset(last_green, 0, sizeof(last_green));
+    Rng rng;
+    rng_seed(&rng, 22);
+    for (int i = 0; i < NUM_CARS; i++) {
+        race->categories[i] = (unsigned char)(i % CAR_CATEGORIES);
+        next_record(race, i)->flags = TLM_START;
+    }
+
+    // Lap by lap across the field, as a race records it
+    for (int lap = 0; lap < NUM_LAPS; lap++) {
+        for (int i = 0; i < NUM_CARS; i++) {
+            lap_time[i] = 0.0f;
+            kind[i] = (int)rng_below(rng_next(&rng), 20);  // 0-13 dry, 14-16 wet, 17 mixed, 18 caution, 19 stop
+        }
+        for (int s = 0; s < 3; s++) {
+            for (int i = 0; i < NUM_CARS; i++) {
+                int c = race->categories[i];
+                float time = (float)(70.0 + 5.0 * c + rng_below(rng_next(&rng), 100000) / 10000.0);
+                uint8_t flags = 0;
+                if (kind[i] >= 14 && kind[i] <= 16) flags |= TLM_RAIN;
+                if (kind[i] == 17 && s == 1) flags |= TLM_RAIN;
+                if (kind[i] == 18 && s == 0) flags |= TLM_CAUTION;
+                bool wet = flags & TLM_RAIN;
+                if (kind[i] == 19 && s == 2) {
+                    flags |= TLM_PIT;
+                    time += 45.0f;
+                    if (last_green[i][s] > 0.0f && green_wet[i][s] == wet) exact_add(&race->pit_loss[c], time - last_green[i][s]);
+                } else if (!(flags & TLM_CAUTION)) {
+                    last_green[i][s] = time;
+                    green_wet[i][s] = wet;
+                }
+                if (s == 2) flags |= TLM_LAP_DONE;
+
+                TelemetryRecord* rec = next_record(race, i);
+                rec->flags = flags;
+                rec->sector_time = time;
+                rec->current_sector = (uint8_t)((s + 1) % 3);
+                rec->laps_completed = (uint16_t)(lap + (s == 2));
+                lap_time[i] += time;
+            }
+        }
+        for (int i = 0; i < NUM_CARS; i++) {
+            if (kind[i] <= 16) exact_add(&race->pace[race->categories[i]][kind[i] >= 14], lap_time[i]);
+        }
+    }
+}
+
+static int compare_float(const void* a, const void* b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+static void check_sketch(const QuantileSketch* sk, Exact* exact, const char* what, int c, int threads) {
+    CHECK(exact->count > 0, "%s, class %d: nothing to compare", what, c);
+    CHECK(sk->count == (uint64_t)exact->count, "%s, class %d, %d workers: %llu values, %d expected",
+          what, c, threads, (unsigned long long)sk->count, exact->count);
+    double sum = 0.0;
+    for (int k = 0; k < exact->count; k++) sum += exact->values[k];
+    CHECK(fabs(sk->sum - sum) <= 1e-9 * sum, "%s, class %d, %d workers: sum %.6f, %.6f expected", what, c, threads, sk->sum, sum);
+
+    qsort(exact->values, (size_t)exact->count, sizeof(float), compare_float);
+    for (int q = 0; q < NUM_QUANTILES; q++) {
+        // The rank sketch_quantile() reads
+        uint64_t rank = (uint64_t)(QUANTILES[q] * (exact->count - 1) + 0.5);
+        double expected = exact->values[rank];
+        double got = sketch_quantile(sk, QUANTILES[q]);
+        CHECK(fabs(got - expected) <= SKETCH_ERROR * expected,
+              "%s, class %d, %d workers: quantile %.2f is %.4f, %.4f by an exact sort", what, c, threads,
+              QUANTILES[q], got, expected);
+    }
+}
+
+int main(void) {
+    Race race;
+    memset(&race, 0, sizeof(race));
+    record_race(&race);
+
+    static const int THREADS[] = { 1, 3 };
+    for (int t = 0; t < 2; t++) {
+        Analysis an, merged;
+        analysis_init(&an, THREADS[t]);
+        analysis_init(&merged, 1);
+        analysis_begin_race(&an, NUM_CARS, race.categories);
+        // Uneven pieces, as a recorder's buffers would come
+        size_t done = 0;
+        while (done < race.num_records) {
+            size_t piece = race.num_records - done < 5000 ? race.num_records - done : 5000;
+            analysis_add(&an, race.records + done, piece);
+            done += piece;
+        }
+        analysis_end_race(&an);
+        analysis_merge(&merged, &an);
+
+        const AnalysisTotals* tot = &merged.workers[0].totals;
+        CHECK(tot->records == race.num_records, "%d workers: %llu records, %zu recorded", THREADS[t],
+              (unsigned long long)tot->records, race.num_records);
+        for (int c = 0; c < CAR_CATEGORIES; c++) {
+            check_sketch(&tot->pace[c][0], &race.pace[c][0], "dry pace", c, THREADS[t]);
+            check_sketch(&tot->pace[c][1], &race.pace[c][1], "wet pace", c, THREADS[t]);
+            check_sketch(&tot->pit_loss[c], &race.pit_loss[c], "pit loss", c, THREADS[t]);
+        }
+        analysis_free(&merged);
+        analysis_free(&an);
+    }
+
+    printf("test_analysis: pace and pit loss quantiles within %.1f%% of an exact sort "
+           "(%zu records, 1 and 3 workers)\n", SKETCH_ERROR * 100.0, race.num_records);
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        free(race.pace[c][0].values);
+        free(race.pace[c][1].values);
+        free(race.pit_loss[c].values);
+    }
+    free(race.records);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <string.h>
+#include "car.h"
+#include "weather.h"
+#include "utils.h"
+#include "test.h"
+
+// car_update_batch() against car_update(), lane by lane and bit for bit, on each path this
+// machine has. The cars run whole races through changing weather, with safety car periods
+// and every caution mask, so lanes pit, change tires, fail and retire next to lanes that
+// do not; the field leaves the last batch partial.
+
+#define NUM_CARS    37
+#define NUM_SEEDS   4
+
+typedef struct {
+    long ticks;
+    long wet_ticks;
+    long stops;         // Tire changes
+    long retirements;
+} Coverage;
+
+#define CHECK_LANE(field)                                                              \
+    CHECK(memcmp(&ref->field, &got->field, sizeof(ref->field)) == 0,                   \
+          "%s path, seed %d, tick %d, car %d: " #field " %.17g (car_update) vs %.17g", \
+          path, seed, tick, ref->id, (double)ref->field, (double)got->field)
+
+static void check_lane(const char* path, int seed, int tick, const Car* ref, const Car* got) {
+    CHECK_LANE(fuel_level);
+    CHECK_LANE(tire_wear);
+    CHECK_LANE(reliability);
+    CHECK_LANE(current_lap_time);
+    CHECK_LANE(last_lap_time);
+    CHECK_LANE(total_race_time);
+    CHECK_LANE(sector_times[0]);
+    CHECK_LANE(sector_times[1]);
+    CHECK_LANE(sector_times[2]);
+    CHECK_LANE(state);
+    CHECK_LANE(current_tires);
+    CHECK_LANE(current_sector);
+    CHECK_LANE(laps_completed);
+}
+
+static void run_races(const char* path, Coverage* cov) {
+    for (int seed = 1; seed <= NUM_SEEDS; seed++) {
+        WeatherTimeline weather = { 0 };
+        weather_timeline_build(&weather, (uint64_t)seed);
+        Rng rng;
+        rng_seed(&rng, (uint64_t)seed);
+
+        Car ref[NUM_CARS];
+        CarSoA soa;
+        car_soa_alloc(&soa, NUM_CARS);
+        for (int i = 0; i < NUM_CARS; i++) {
+            car_init(&ref[i], i + 1, (CarCategory)(i % CAR_CATEGORIES), &rng);
+            // Some start near a failure, a fuel stop or a tire stop, so those come early too
+            if (i % 5 == 1) ref[i].reliability = 1.0 + i % 3;
+            if (i % 7 == 2) ref[i].fuel_level = 6.0;
+            if (i % 4 == 3) ref[i].tire_wear = 80.0;
+            car_soa_load(&soa, i, &ref[i]);
+        }
+
+        uint32_t draws[NUM_CARS * CAR_DRAWS_PER_UPDATE];
+        for (int tick = 0; tick < weather.num_slots; tick++) {
+            const TrackConditions* cond = &weather.slots[tick];
+            bool safety_car = (tick / 150) % 4 == 3;
+            unsigned caution = (unsigned)(tick / 40) % 8;
+            rng_fill(&rng, draws, NUM_CARS * CAR_DRAWS_PER_UPDATE);
+
+            TireCompound tires_before[NUM_CARS];
+            CarState state_before[NUM_CARS];
+            unsigned expected = 0;
+            for (int i = 0; i < NUM_CARS; i++) {
+                tires_before[i] = ref[i].current_tires;
+                state_before[i] = ref[i].state;
+                expected |= car_update(&ref[i], 1.0, safety_car, caution, cond, &draws[i * CAR_DRAWS_PER_UPDATE]);
+            }
+            unsigned incidents = car_update_batch(&soa, NUM_CARS, safety_car, caution, cond, draws);
+
+            for (int i = 0; i < NUM_CARS; i++) {
+                Car lane = ref[i];
+                car_soa_store(&soa, i, &lane);
+                check_lane(path, seed, tick, &ref[i], &lane);
+                if (ref[i].current_tires != tires_before[i]) cov->stops++;
+                if (ref[i].state == RETIRED && state_before[i] != RETIRED) cov->retirements++;
+            }
+            CHECK(incidents == expected, "%s path, seed %d, tick %d: incidents %#x (car_update) vs %#x",
+                  path, seed, tick, expected, incidents);
+            cov->ticks++;
+            if (cond->wet) cov->wet_ticks++;
+        }
+        car_soa_free(&soa);
+        weather_timeline_free(&weather);
+    }
+}
+
+int main(void) {
+    static const CarBatchPath PATHS[] = { CAR_BATCH_PORTABLE, CAR_BATCH_AVX2 };
+    static const char* const NAMES[] = { "portable", "avx2" };
+    for (int p = 0; p < 2; p++) {
+        if (!car_batch_set_path(PATHS[p])) {
+            printf("test_batch: no %s path in this build or on this CPU, skipped\n", NAMES[p]);
+            continue;
+        }
+        Coverage cov = { 0, 0, 0, 0 };
+        run_races(NAMES[p], &cov);
+        // The races must have reached what the lanes disagree on most easily
+        CHECK(cov.wet_ticks > 0 && cov.stops > 0 && cov.retirements > 0,
+              "%s path: %ld wet ticks, %ld tire changes, %ld retirements: not every case was run",
+              NAMES[p], cov.wet_ticks, cov.stops, cov.retirements);
+        printf("test_batch: %s path matches car_update() on %d cars over %ld ticks "
+               "(%ld wet, %ld tire changes, %ld retirements)\n",
+               NAMES[p], NUM_CARS, cov.ticks, cov.wet_ticks, cov.stops, cov.retirements);
+    }
+    car_batch_set_path(CAR_BATCH_AUTO);
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "race.h"
+#include "entries.h"
+#include "utils.h"
+#include "test.h"
+
+// Local cautions against plain per-sector flags. Each race is stepped while the test keeps
+// its own slow zone and full course yellow end for every sector, from the cars it sees stop
+// (in the sector they stopped in; off a wet track, all three). After every step the race's
+// caution times and mask must match. Every engine, the SIMD one on 3 threads too. Some cars
+// start worn, and one never stops, so it wears out on slicks in the rain and crashes.
+// Then car_update() itself: a sector run under a set bit costs CAUTION_TIME more, and nothing
+// else changes.
+
+#define NUM_SEEDS 3
+
+typedef struct {
+    double time;            // Race time the caution comes out
+    bool crash;
+    int sector;
+} Incident;
+
+static long slow_zones, full_course_yellows;
+
+// Stays out whatever the tires and the weather
+static bool never_stop(const Car* car, bool is_raining, void* ctx, TireCompound* compound) {
+    (void)car;
+    (void)is_raining;
+    (void)ctx;
+    (void)compound;
+    return false;
+}
+
+static void raise_flags(double* flag_end, const Incident* inc) {
+    double until = inc->time + (inc->crash ? FULL_COURSE_YELLOW_TICKS : SLOW_ZONE_TICKS) * RACE_TICK_SECONDS;
+    for (int s = 0; s < 3; s++) {
+        if ((inc->crash || s == inc->sector) && flag_end[s] < until) flag_end[s] = until;
+    }
+    if (inc->crash) full_course_yellows++;
+    else slow_zones++;
+}
+
+// Sectors whose flag is still out at race time 't'
+static unsigned flags_at(const double* flag_end, double t) {
+    unsigned mask = 0;
+    for (int s = 0; s < 3; s++) {
+        if (flag_end[s] > t) mask |= 1u << s;
+    }
+    return mask;
+}
+
+static void check_flags(const RaceContext* race, const double* flag_end, unsigned mask, const char* name, int seed) {
+    for (int s = 0; s < 3; s++) {
+        CHECK(race->caution_end[s] == flag_end[s], "%s engine, seed %d, %.0f s: sector %d caution until %.1f, flags say %.1f",
+              name, seed, race->elapsed_time, s, race->caution_end[s], flag_end[s]);
+    }
+    CHECK(race->caution_mask == mask, "%s engine, seed %d, %.0f s: caution mask %#x, flags say %#x",
+          name, seed, race->elapsed_time, race->caution_mask, mask);
+}
+
+static void run_race(const EntryList* entries, RaceEngine engine, const char* name, int threads, int seed) {
+    RaceContext race;
+    race_init_seeded(&race, entries, (uint64_t)seed);
+    race_set_pit_rule(&race, 0, never_stop, NULL);
+    for (int i = 1; i < race.num_cars; i += 3) race.cars[i].reliability = 2.0 * i;
+    race_set_engine(&race, engine);
+    race_set_threads(&race, threads);
+    bool fixed_step = !race_has_events(&race);
+    const WeatherTimeline* weather = race_weather(&race);
+
+    bool* stopped = calloc((size_t)race.num_cars, sizeof(bool));
+    Incident* pending = malloc((size_t)race.num_cars * sizeof(Incident));
+    CHECK(stopped && pending, "out of memory");
+    int num_pending = 0;
+    double flag_end[3] = { 0.0, 0.0, 0.0 };
+    while (!race_is_finished(&race)) {
+        double tick = race.elapsed_time;
+        const TrackConditions* cond = weather_at(weather, tick);
+        race_run_step(&race);
+
+        // A stop is seen once the car shows RETIRED: in the fixed-step engines at the end of
+        // the tick, in the event engines when its sector starts (the adaptive engine's cars
+        // may show it early, on their run)
+        for (int i = 0; i < race.num_cars; i++) {
+            const Car* car = &race.cars[i];
+            if (stopped[i] || car->state != RETIRED) continue;
+            stopped[i] = true;
+            Incident* inc = &pending[num_pending++];
+            inc->time = fixed_step ? tick + RACE_TICK_SECONDS : car->total_race_time;
+            if (!fixed_step) cond = weather_at(weather, inc->time);
+            inc->crash = car->reliability > -10.0 && cond->danger[car->current_tires] > 0.0f;
+            inc->sector = car->current_sector;
+        }
+
+        // The fixed-step mask is taken at the start of the tick, before its stops;
+        // the event engines' at the race clock, after them
+        unsigned mask = flags_at(flag_end, tick);
+        for (int k = 0; k < num_pending; k++) {
+            if (pending[k].time > race.elapsed_time) continue;
+            raise_flags(flag_end, &pending[k]);
+            pending[k--] = pending[--num_pending];
+        }
+        if (!fixed_step) mask = flags_at(flag_end, race.elapsed_time);
+        check_flags(&race, flag_end, mask, name, seed);
+    }
+    free(pending);
+    free(stopped);
+    race_cleanup(&race);
+}
+
+// car_update() with every mask against the same sector run green
+static void check_sector_cost(void) {
+    WeatherTimeline weather = { 0 };
+    weather_timeline_build(&weather, 23);
+    Rng rng;
+    rng_seed(&rng, 23);
+    uint32_t draws[CAR_DRAWS_PER_UPDATE];
+    for (int trial = 0; trial < 300; trial++) {
+        Car car;
+        car_init(&car, 1, (CarCategory)(trial % CAR_CATEGORIES), &rng);
+        car.current_sector = trial % 3;
+        car.tire_wear = rng_below(rng_next(&rng), 90);
+        car.fuel_level = 3.0 + rng_below(rng_next(&rng), 97);
+        bool safety_car = trial % 10 == 9;
+        const TrackConditions* cond = &weather.slots[rng_below(rng_next(&rng), (uint32_t)weather.num_slots)];
+        rng_fill(&rng, draws, CAR_DRAWS_PER_UPDATE);
+
+        Car green = car;
+        unsigned green_incidents = car_update(&green, 1.0, safety_car, 0, cond, draws);
+        for (unsigned mask = 1; mask <= CAUTION_ALL; mask++) {
+            Car slow = car;
+            unsigned incidents = car_update(&slow, 1.0, safety_car, mask, cond, draws);
+            bool charged = !safety_car && ((mask >> car.current_sector) & 1) && green.state != RETIRED;
+            double extra = slow.sector_times[car.current_sector] - green.sector_times[car.current_sector];
+            CHECK(fabs(extra - (charged ? CAUTION_TIME : 0.0)) < 1e-9, "trial %d, sector %d, mask %#x: %.17g s more than green",
+                  trial, car.current_sector, mask, extra);
+            CHECK(incidents == green_incidents && slow.state == green.state && slow.fuel_level == green.fuel_level &&
+                  slow.tire_wear == green.tire_wear && slow.reliability == green.reliability &&
+                  slow.current_tires == green.current_tires,
+                  "trial %d, mask %#x: the caution changed more than the sector time", trial, mask);
+        }
+    }
+    weather_timeline_free(&weather);
+}
+
+int main(void) {
+    EntryList entries;
+    entry_list_init(&entries);
+    entry_list_builtin(&entries);
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        for (int seed = 1; seed <= NUM_SEEDS; seed++) run_race(&entries, ENGINES[e], ENGINE_NAMES[e], 1, seed);
+    }
+    for (int seed = 1; seed <= NUM_SEEDS; seed++) run_race(&entries, ENGINE_SIMD, "simd on 3 threads", 3, seed);
+    CHECK(slow_zones > 0 && full_course_yellows > 0, "%ld slow zones and %ld full course yellows: not every case was run",
+          slow_zones, full_course_yellows);
+    check_sector_cost();
+    printf("test_cautions: caution masks match per-sector flags on %d engines and simd on 3 threads, %d seeds "
+           "(%ld slow zones, %ld full course yellows)\n", NUM_ENGINES, NUM_SEEDS, slow_zones, full_course_yellows);
+    entry_list_free(&entries);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "race.h"
+#include "entries.h"
+#include "snapshot.h"
+#include "telemetry.h"
+#include "test.h"
+
+// Lap times in a replay, which the file does not hold, against the race that recorded it:
+// every few steps the live cars' last laps, best laps and each class's fastest lap are kept,
+// then the replay is sought to the same race times. Every engine, with and without traffic.
+
+#define CHECK_EVERY 25      // Steps between kept standings
+#define LAP_TOLERANCE 1e-6  // A replayed lap is a difference of race times, not a sum of sectors
+
+typedef struct {
+    double time;
+    double* last_lap;       // By car index
+    double* best_lap;
+    double fastest_lap[CAR_CATEGORIES];
+} Kept;
+
+static void run_race(const EntryList* entries, RaceEngine engine, const char* name, bool traffic, const char* path) {
+    RaceContext race;
+    race_init_seeded(&race, entries, 11);
+    race_set_engine(&race, engine);
+    race.traffic = traffic;
+    TelemetryRecorder recorder;
+    CHECK(telemetry_recorder_open(&recorder, path, &race), "cannot record to %s", path);
+    race.recorder = &recorder;
+
+    int n = race.num_cars, num_kept = 0, capacity = 0, step = 0;
+    Kept* kept = NULL;
+    while (!race_is_finished(&race)) {
+        race_run_step(&race);
+        if (++step % CHECK_EVERY != 0 && !race_is_finished(&race)) continue;
+        if (num_kept == capacity) {
+            capacity = capacity ? 2 * capacity : 64;
+            kept = realloc(kept, (size_t)capacity * sizeof(Kept));
+            CHECK(kept, "out of memory");
+        }
+        Kept* k = &kept[num_kept++];
+        k->time = race.elapsed_time;
+        k->last_lap = malloc((size_t)n * sizeof(double));
+        k->best_lap = malloc((size_t)n * sizeof(double));
+        CHECK(k->last_lap && k->best_lap, "out of memory");
+        for (int i = 0; i < n; i++) {
+            k->last_lap[i] = race.cars[i].last_lap_time;
+            k->best_lap[i] = race.standings.best_lap[i];
+        }
+        for (int c = 0; c < CAR_CATEGORIES; c++) k->fastest_lap[c] = standings_class_fastest_lap(&race.standings, (CarCategory)c);
+    }
+    telemetry_recorder_close(&recorder);
+    race.recorder = NULL;
+
+    TelemetryReplay replay;
+    CHECK(telemetry_replay_open(&replay, path), "cannot replay %s", path);
+    RaceSnapshot snap;
+    snapshot_alloc(&snap, n);
+    for (int s = 0; s < num_kept; s++) {
+        const Kept* k = &kept[s];
+        telemetry_replay_seek(&replay, k->time, &snap);
+        for (int p = 0; p < n; p++) {
+            const SnapshotCar* car = &snap.cars[p];
+            int i = car->id - 1;
+            CHECK(fabs(car->last_lap_time - k->last_lap[i]) < LAP_TOLERANCE,
+                  "%s engine, traffic %s, %.0f s: car %d last lap %.9f replayed, %.9f live",
+                  name, traffic ? "on" : "off", k->time, i, car->last_lap_time, k->last_lap[i]);
+            CHECK(fabs(car->best_lap - k->best_lap[i]) < LAP_TOLERANCE,
+                  "%s engine, traffic %s, %.0f s: car %d best lap %.9f replayed, %.9f live",
+                  name, traffic ? "on" : "off", k->time, i, car->best_lap, k->best_lap[i]);
+        }
+        for (int c = 0; c < CAR_CATEGORIES; c++) {
+            CHECK(fabs(snap.fastest_lap[c] - k->fastest_lap[c]) < LAP_TOLERANCE,
+                  "%s engine, traffic %s, %.0f s: class %d fastest lap %.9f replayed, %.9f live",
+                  name, traffic ? "on" : "off", k->time, c, snap.fastest_lap[c], k->fastest_lap[c]);
+            CHECK((snap.fastest[c] == 0) == (k->fastest_lap[c] == 0.0),
+                  "%s engine, traffic %s, %.0f s: class %d fastest lap holder %d", name, traffic ? "on" : "off",
+                  k->time, c, snap.fastest[c]);
+        }
+    }
+    snapshot_free(&snap);
+    telemetry_replay_close(&replay);
+
+    for (int s = 0; s < num_kept; s++) {
+        free(kept[s].last_lap);
+        free(kept[s].best_lap);
+    }
+    free(kept);
+    race_cleanup(&race);
+}
+
+int main(void) {
+    EntryList entries;
+    entry_list_init(&entries);
+    entry_list_builtin(&entries);
+
+    char path[] = "/tmp/test_replay_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0, "cannot create a temporary file");
+    close(fd);
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        run_race(&entries, ENGINES[e], ENGINE_NAMES[e], false, path);
+        run_race(&entries, ENGINES[e], ENGINE_NAMES[e], true, path);
+    }
+    unlink(path);
+    printf("test_replay: replayed last, best and fastest laps match the recording race on %d engines, "
+           "with and without traffic\n", NUM_ENGINES);
+    entry_list_free(&entries);
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "race.h"
+#include "checkpoint.h"
+#include "entries.h"
+#include "test.h"
+
+// A race taken up again from a saved state finishes exactly as the original does, bit for bit,
+// on every engine: a fork (race_clone), a rewound race of another seed and engine
+// (race_restore) and a checkpoint reloaded from disk, all taken mid-race.
+
+#define NUM_SEEDS   2
+#define FORK_TIME   (6.0 * SECONDS_IN_HOUR + 100.0)     // Not on a tick boundary
+
+#define CHECK_SAME(field, i)                                                           \
+    CHECK(memcmp(&ref->field, &got->field, sizeof(ref->field)) == 0,                   \
+          "%s, %s engine, seed %d, car %d: " #field " %.17g (original) vs %.17g", how,  \
+          engine, seed, i, (double)ref->field, (double)got->field)
+
+static void check_car(const char* how, const char* engine, int seed, int i, const Car* ref, const Car* got) {
+    CHECK_SAME(state, i);
+    CHECK_SAME(fuel_level, i);
+    CHECK_SAME(tire_wear, i);
+    CHECK_SAME(reliability, i);
+    CHECK_SAME(current_tires, i);
+    CHECK_SAME(current_lap_time, i);
+    CHECK_SAME(last_lap_time, i);
+    CHECK_SAME(sector_times[0], i);
+    CHECK_SAME(sector_times[1], i);
+    CHECK_SAME(sector_times[2], i);
+    CHECK_SAME(total_race_time, i);
+    CHECK_SAME(current_sector, i);
+    CHECK_SAME(laps_completed, i);
+}
+
+static void check_race(const char* how, const char* engine, int seed, const RaceContext* ref, const RaceContext* got) {
+    CHECK(got->num_cars == ref->num_cars, "%s, %s engine, seed %d: %d cars vs %d",
+          how, engine, seed, got->num_cars, ref->num_cars);
+    CHECK_SAME(elapsed_time, -1);
+    CHECK_SAME(rng.counter, -1);
+    CHECK_SAME(safety_car_active, -1);
+    CHECK_SAME(caution_mask, -1);
+    for (int i = 0; i < ref->num_cars; i++) {
+        check_car(how, engine, seed, i, &ref->cars[i], &got->cars[i]);
+        CHECK_SAME(order[i], i);
+        CHECK_SAME(standings.class_position[i], i);
+        CHECK_SAME(standings.best_lap[i], i);
+        CHECK(strcmp(ref->info[i].team_name, got->info[i].team_name) == 0,
+              "%s, %s engine, seed %d, car %d: team '%s' vs '%s'", how, engine, seed, i,
+              ref->info[i].team_name, got->info[i].team_name);
+    }
+    for (int c = 0; c < CAR_CATEGORIES; c++) CHECK_SAME(standings.fastest[c], c);
+}
+
+int main(void) {
+    EntryList entries;
+    entry_list_init(&entries);
+    entry_list_builtin(&entries);
+    char path[] = "/tmp/test_resume_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0, "cannot create a temporary file");
+    close(fd);
+
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        for (int seed = 1; seed <= NUM_SEEDS; seed++) {
+            const char* engine = ENGINE_NAMES[e];
+            RaceContext race, fork, rewound, resumed;
+            EntryList resumed_entries;
+            race_init_seeded(&race, &entries, (uint64_t)seed);
+            race_set_engine(&race, ENGINES[e]);
+            // Another seed on another engine, so the restore has to replace all of it
+            race_init_seeded(&rewound, &entries, (uint64_t)seed + 100);
+            race_set_engine(&rewound, ENGINES[(e + 1) % NUM_ENGINES]);
+            race_run_until(&rewound, SECONDS_IN_HOUR);
+
+            race_run_until(&race, FORK_TIME);
+            race_clone(&fork, &race);
+            race_restore(&rewound, &race);
+            CHECK(checkpoint_save(&race, path), "%s engine, seed %d: checkpoint not saved", engine, seed);
+            entry_list_init(&resumed_entries);
+            CHECK(checkpoint_load(path, &resumed_entries, &resumed),
+                  "%s engine, seed %d: checkpoint not loaded", engine, seed);
+
+            race_run_until(&race, TOTAL_RACE_TIME);
+            race_run_until(&fork, TOTAL_RACE_TIME);
+            race_run_until(&rewound, TOTAL_RACE_TIME);
+            race_run_until(&resumed, TOTAL_RACE_TIME);
+            check_race("fork", engine, seed, &race, &fork);
+            check_race("restore", engine, seed, &race, &rewound);
+            check_race("checkpoint", engine, seed, &race, &resumed);
+
+            race_cleanup(&resumed);
+            entry_list_free(&resumed_entries);
+            race_cleanup(&rewound);
+            race_cleanup(&fork);
+            race_cleanup(&race);
+        }
+    }
+    remove(path);
+    printf("test_resume: fork, restore and checkpoint resume finish bit for bit as the original "
+           "on %d engines, %d seeds\n", NUM_ENGINES, NUM_SEEDS);
+    entry_list_free(&entries);
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "race.h"
+#include "entries.h"
+#include "track.h"
+#include "test.h"
+
+// The standings the race keeps from step to step, against a full recomputation: the running
+// order against a sort of the whole field, then positions, class positions and class order,
+// gaps, intervals, class gaps, best laps and the fastest lap of each class. Every engine,
+// with and without traffic, on the built-in field and on a large one whose first laps
+// reshuffle it enough to take the merge sort.
+
+#define CHECK_EVERY 5       // Steps between full recomputations
+#define LARGE_FIELD 300
+
+static const RaceContext* sort_race;
+
+static int compare_position(const void* a, const void* b) {
+    const Car* x = &sort_race->cars[*(const int*)a];
+    const Car* y = &sort_race->cars[*(const int*)b];
+    return race_car_is_ahead(x, y) ? -1 : (race_car_is_ahead(y, x) ? 1 : 0);
+}
+
+typedef struct {
+    const char* engine;
+    bool traffic;
+    int num_cars;
+    int step;
+} Where;
+
+#define CHECK_AT(cond, ...)                                                                   \
+    do {                                                                                      \
+        if (!(cond)) {                                                                        \
+            fprintf(stderr, "%s engine, traffic %s, %d cars, step %d: ", at->engine,          \
+                    at->traffic ? "on" : "off", at->num_cars, at->step);                      \
+            CHECK(cond, __VA_ARGS__);                                                         \
+        }                                                                                     \
+    } while (0)
+
+static void check_standings(RaceContext* race, const double* best_lap, bool laps_seen, const Where* at) {
+    int n = race->num_cars;
+    const Standings* st = &race->standings;
+    int* sorted = malloc((size_t)n * sizeof(int));
+    TrackPosition* positions = malloc((size_t)n * sizeof(TrackPosition));
+    CHECK(sorted && positions, "out of memory");
+    for (int i = 0; i < n; i++) sorted[i] = i;
+    sort_race = race;
+    qsort(sorted, (size_t)n, sizeof(int), compare_position);
+
+    int in_class[CAR_CATEGORIES] = { 0 };
+    int leader_of[CAR_CATEGORIES] = { -1, -1, -1 };
+    for (int p = 0; p < n; p++) {
+        int i = sorted[p];
+        int c = race->cars[i].category;
+        CHECK_AT(race->order[p] == i, "position %d: car %d in the order, %d by a full sort", p, race->order[p], i);
+        CHECK_AT(st->position[i] == p, "car %d: position %d, %d by a full sort", i, st->position[i], p);
+        CHECK_AT(st->class_position[i] == in_class[c], "car %d: class position %d, %d by a full sort",
+                 i, st->class_position[i], in_class[c]);
+        CHECK_AT(standings_class_car(st, (CarCategory)c, in_class[c]) == i, "class %d position %d: car %d, %d by a full sort",
+                 c, in_class[c], standings_class_car(st, (CarCategory)c, in_class[c]), i);
+        if (leader_of[c] < 0) leader_of[c] = i;
+        in_class[c]++;
+    }
+
+    // Gaps, from scratch with the track model
+    race_update_gaps(race);
+    double clock = race_track_clock(race);
+    for (int i = 0; i < n; i++) positions[i] = track_car_position(&race->track, &race->cars[i], clock);
+    for (int p = 0; p < n; p++) {
+        int i = sorted[p];
+        const Car* car = &race->cars[i];
+        double gap = track_gap(&race->track, car, positions[i], positions[sorted[0]]);
+        double interval = p == 0 ? 0.0 : track_gap(&race->track, car, positions[i], positions[sorted[p - 1]]);
+        double class_gap = track_gap(&race->track, car, positions[i], positions[leader_of[car->category]]);
+        CHECK_AT(st->gap[i] == gap, "car %d: gap %.17g, %.17g from scratch", i, st->gap[i], gap);
+        CHECK_AT(st->interval[i] == interval, "car %d: interval %.17g, %.17g from scratch", i, st->interval[i], interval);
+        CHECK_AT(st->class_gap[i] == class_gap, "car %d: class gap %.17g, %.17g from scratch",
+                 i, st->class_gap[i], class_gap);
+    }
+
+    // Best laps as seen lap by lap (where the engine shows every lap), and each class's fastest
+    double fastest[CAR_CATEGORIES] = { 0.0, 0.0, 0.0 };
+    for (int i = 0; i < n; i++) {
+        if (laps_seen) {
+            CHECK_AT(st->best_lap[i] == best_lap[i], "car %d: best lap %.17g, %.17g seen", i, st->best_lap[i], best_lap[i]);
+        }
+        double lap = st->best_lap[i];
+        int c = race->cars[i].category;
+        if (lap > 0.0 && (fastest[c] == 0.0 || lap < fastest[c])) fastest[c] = lap;
+    }
+    for (int c = 0; c < CAR_CATEGORIES; c++) {
+        CHECK_AT(standings_class_fastest_lap(st, (CarCategory)c) == fastest[c], "class %d: fastest lap %.17g, %.17g",
+                 c, standings_class_fastest_lap(st, (CarCategory)c), fastest[c]);
+    }
+    free(positions);
+    free(sorted);
+}
+
+static void run_race(const EntryList* entries, RaceEngine engine, const char* name, bool traffic) {
+    RaceContext race;
+    race_init_seeded(&race, entries, 7);
+    race_set_engine(&race, engine);
+    race.traffic = traffic;
+    Where where = { name, traffic, race.num_cars, 0 };
+    const Where* at = &where;
+
+    // The adaptive engine runs several laps between two steps: only its holders are checked
+    bool laps_seen = engine != ENGINE_ADAPTIVE;
+    double* best_lap = calloc((size_t)race.num_cars, sizeof(double));
+    int* laps = calloc((size_t)race.num_cars, sizeof(int));
+    CHECK(best_lap && laps, "out of memory");
+    while (!race_is_finished(&race)) {
+        race_run_step(&race);
+        where.step++;
+        for (int i = 0; i < race.num_cars; i++) {
+            const Car* car = &race.cars[i];
+            if (car->laps_completed != laps[i]) {
+                CHECK_AT(!laps_seen || car->laps_completed == laps[i] + 1, "car %d: %d laps in one step",
+                         i, car->laps_completed - laps[i]);
+                laps[i] = car->laps_completed;
+                double lap = car->last_lap_time;
+                if (lap > 0.0 && (best_lap[i] == 0.0 || lap < best_lap[i])) best_lap[i] = lap;
+            }
+        }
+        if (where.step % CHECK_EVERY == 0 || race_is_finished(&race)) check_standings(&race, best_lap, laps_seen, at);
+    }
+    free(laps);
+    free(best_lap);
+    race_cleanup(&race);
+}
+
+int main(void) {
+    EntryList builtin, large;
+    entry_list_init(&builtin);
+    entry_list_builtin(&builtin);
+    entry_list_init(&large);
+    entry_list_builtin(&large);
+    entry_list_resize(&large, LARGE_FIELD);
+
+    const EntryList* fields[] = { &builtin, &large };
+    for (int f = 0; f < 2; f++) {
+        for (int e = 0; e < NUM_ENGINES; e++) {
+            run_race(fields[f], ENGINES[e], ENGINE_NAMES[e], false);
+            run_race(fields[f], ENGINES[e], ENGINE_NAMES[e], true);
+        }
+    }
+    printf("test_standings: standings match a full recomputation on %d engines, %d and %d cars, "
+           "with and without traffic\n", NUM_ENGINES, builtin.num_entries, large.num_entries);
+    entry_list_free(&large);
+    entry_list_free(&builtin);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "weather.h"
+#include "test.h"
+
+// The wet flag change index against a linear scan of the slots, on built timelines, on
+// branched ones (whose index must follow their new future) and on ones loaded from saved slots,
+// and weather_wet_change() at slot starts, inside slots and past either end of the race.
+
+#define NUM_SEEDS 16
+
+static long changes_seen;
+
+// First slot after 'k' whose wet flag differs from slot k's, by walking the slots
+static int scan_wet_change(const WeatherTimeline* tl, int k) {
+    for (int j = k + 1; j < tl->num_slots; j++) {
+        if (tl->slots[j].wet != tl->slots[k].wet) return j;
+    }
+    return tl->num_slots;
+}
+
+static void check_index(const WeatherTimeline* tl, const char* what, int seed) {
+    CHECK(tl->num_slots == WEATHER_SLOTS, "%s, seed %d: %d slots", what, seed, tl->num_slots);
+    for (int k = 0; k < tl->num_slots; k++) {
+        int expected = scan_wet_change(tl, k);
+        CHECK(tl->wet_change[k] == expected, "%s, seed %d, slot %d: wet change at slot %d, %d by a scan",
+              what, seed, k, tl->wet_change[k], expected);
+        double change = expected < tl->num_slots ? expected * WEATHER_SLOT_SECONDS : HUGE_VAL;
+        double starts[] = { k * WEATHER_SLOT_SECONDS, (k + 0.5) * WEATHER_SLOT_SECONDS };
+        for (int s = 0; s < 2; s++) {
+            CHECK(weather_wet_change(tl, starts[s]) == change, "%s, seed %d: wet change from %.1f s is %.1f, %.1f by a scan",
+                  what, seed, starts[s], weather_wet_change(tl, starts[s]), change);
+        }
+        if (k > 0 && tl->slots[k].wet != tl->slots[k - 1].wet) changes_seen++;
+    }
+    // Before the start and after the flag the first and last slots hold
+    CHECK(weather_wet_change(tl, -10.0) == weather_wet_change(tl, 0.0), "%s, seed %d: before the start", what, seed);
+    CHECK(weather_wet_change(tl, 2.0 * TOTAL_RACE_TIME) == HUGE_VAL, "%s, seed %d: after the flag", what, seed);
+}
+
+int main(void) {
+    for (int seed = 1; seed <= NUM_SEEDS; seed++) {
+        WeatherTimeline built = { 0 }, branched = { 0 }, loaded = { 0 };
+        weather_timeline_build(&built, (uint64_t)seed);
+        check_index(&built, "built", seed);
+
+        double from = (seed % 4 + 1) * TOTAL_RACE_TIME / 5.0;
+        weather_timeline_branch(&branched, &built, from, (uint64_t)seed + 1000);
+        check_index(&branched, "branched", seed);
+        int keep = (int)(weather_at(&built, from) - built.slots) + 1;
+        CHECK(memcmp(branched.slots, built.slots, (size_t)keep * sizeof(TrackConditions)) == 0,
+              "branched, seed %d: the slots before the branch changed", seed);
+
+        weather_timeline_load(&loaded, (uint64_t)seed, built.slots);
+        check_index(&loaded, "loaded", seed);
+        CHECK(loaded.air_base == built.air_base, "loaded, seed %d: air base %g, %g built", seed,
+              loaded.air_base, built.air_base);
+
+        // Branched in place: the index is rebuilt over the new future
+        weather_timeline_branch(&built, &built, from / 2.0, (uint64_t)seed + 2000);
+        check_index(&built, "branched in place", seed);
+
+        weather_timeline_free(&loaded);
+        weather_timeline_free(&branched);
+        weather_timeline_free(&built);
+    }
+    CHECK(changes_seen > 0, "no timeline ever changed its wet flag");
+    printf("test_weather: wet change index matches a scan of %d seeds' timelines (%ld flag changes)\n",
+           NUM_SEEDS, changes_seen);
+    return 0;
+}